@@ -0,0 +1,57 @@
+#ifndef PETRINETS_BACKWARDREACHABILITY_H
+#define PETRINETS_BACKWARDREACHABILITY_H
+
+#include "Constants.h"
+#include "NetView.h"
+#include "StateSpace.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Number of firings every marking of a set needs to reach the nearest of some target markings, found by
+/// firing transitions backwards from all targets at once: a transition whose outputs are marked is unfired (its
+/// outputs taken, its inputs given back) and the predecessor is kept if the set holds it. The candidates come from
+/// the transitions producing into the marked places, so every state costs about its marked places and their producers.
+/// @param net Net the markings belong to.
+/// @param markings The set to stay in, usually the forward reachable markings.
+/// @param targets States of the set to reach.
+/// @return (std::vector) Distance of every marking, INVALID_ID for the ones that can't reach any target.
+std::vector<uint32_t> distancesToAny(const NetView &net, const MarkingStore &markings, std::span<const StateId> targets);
+
+/// @brief distancesToAny with the final marking as the only target.
+/// @param finalMarking Marking to reach, empty if there is none.
+std::vector<uint32_t> distancesToFinal(const NetView &net, const MarkingStore &markings, std::span<const int32_t> finalMarking);
+
+/// @brief Result of checkOptionToComplete.
+struct CompletionReport
+{
+    MarkingStore markings;           // Forward reachable markings
+    std::vector<uint32_t> distances; // See distancesToFinal
+    std::vector<StateId> stuck;      // Reachable states that can't reach the final marking, in id order
+    bool complete = true;            // False if the state limit cut the forward exploration short
+
+    [[nodiscard]] bool finalReachable() const
+    {
+        return !distances.empty() && distances[0] != INVALID_ID;
+    }
+};
+
+/// @brief Decides the option to complete (every reachable marking can still reach the final marking) in time linear
+/// in the reachability graph: a forward exploration that keeps only the markings, then distancesToFinal over them.
+/// @param net Net to check, its current tokens are the initial marking.
+/// @param finalMarking Marking every state must be able to reach.
+/// @param maxStates Stop discovering new states after this many, 0 for no limit.
+CompletionReport checkOptionToComplete(const NetView &net, std::span<const int32_t> finalMarking, size_t maxStates = DEFAULT_STATE_LIMIT);
+
+/// @brief The backward half of checkOptionToComplete, over markings another search already explored (e.g. the ones
+/// findStuckComponents keeps), so the net isn't explored forward twice.
+/// @param markings Every reachable marking, the initial one first.
+/// @param complete False if the search that found them was cut short.
+CompletionReport checkOptionToComplete(const NetView &net, MarkingStore markings, std::span<const int32_t> finalMarking, bool complete);
+
+/// @brief Shortest firing sequence from the initial to the final marking, following the distances down.
+/// @return (TransitionIds) The sequence, empty if the final marking isn't reachable.
+TransitionIds shortestCompletion(const NetView &net, const CompletionReport &report);
+
+#endif //PETRINETS_BACKWARDREACHABILITY_H
@@ -0,0 +1,10 @@
+#ifndef PETRINETS_BATCHVERIFIER_H
+#define PETRINETS_BATCHVERIFIER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+int runBatch(const std::vector<std::string> &arguments, std::ostream &out, std::ostream &err);
+
+#endif //PETRINETS_BATCHVERIFIER_H
@@ -0,0 +1,105 @@
+#ifndef PETRINETS_BINARYNET_H
+#define PETRINETS_BINARYNET_H
+
+#include "MappedFile.h"
+#include "NetView.h"
+#include "Petrinet.h"
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+/// @brief Magic bytes at the start of a binary net file.
+const char BINARY_NET_MAGIC[8] = {'P', 'N', 'E', 'T', 'B', 'I', 'N', '\0'};
+/// @brief Version of the layout below, bumped on every incompatible change.
+const uint32_t BINARY_NET_VERSION = 1;
+/// @brief Written in native byte order, a reader seeing anything else can't use the file.
+const uint32_t BINARY_NET_BYTE_ORDER = 0x01020304;
+
+/// @brief Sections of a binary net file, in file order.
+enum class BinaryNetSection : uint32_t
+{
+    Places,       // Place records (name id, initial tokens)
+    Transitions,  // Transition records (name id)
+    NameOffsets,  // nameCount + 1 offsets into the name pool
+    NamePool,     // Name characters back to back
+    TransitionInputOffsets,
+    TransitionInputTargets,
+    TransitionInputWeights,
+    TransitionOutputOffsets,
+    TransitionOutputTargets,
+    TransitionOutputWeights,
+    PlaceInputOffsets,
+    PlaceInputTargets,
+    PlaceInputWeights,
+    PlaceOutputOffsets,
+    PlaceOutputTargets,
+    PlaceOutputWeights,
+    Count
+};
+
+/// @brief Byte range of a section, relative to the start of the file.
+struct BinaryNetSectionEntry
+{
+    uint64_t offset;
+    uint64_t length;
+};
+
+/// @brief Fixed-size header of a binary net file.
+/// Every section starts on an 8 byte boundary so its contents can be used in place.
+struct BinaryNetHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t placeCount;
+    uint32_t transitionCount;
+    uint32_t nameCount;
+    uint32_t flags; // Bit 0: every arc has weight 1
+    BinaryNetSectionEntry sections[static_cast<size_t>(BinaryNetSection::Count)];
+};
+
+/// @brief Returns a section of a mapped file as a typed span, checking its bounds and alignment.
+/// @param file Mapped file, its start is page aligned.
+/// @param entry Byte range of the section.
+/// @param path Path of the file, used in error messages.
+template <typename T>
+std::span<const T> mappedSection(const MappedFile &file, const BinaryNetSectionEntry &entry, const std::string &path)
+{
+    if (entry.offset > file.size() || entry.length > file.size() - entry.offset)
+    {
+        throw std::runtime_error(path + ": Section at offset " + std::to_string(entry.offset) + " is out of bounds");
+    }
+    if (entry.offset % alignof(T) != 0 || entry.length % sizeof(T) != 0)
+    {
+        throw std::runtime_error(path + ": Section at offset " + std::to_string(entry.offset) + " is misaligned");
+    }
+    return {reinterpret_cast<const T *>(file.data() + entry.offset), static_cast<size_t>(entry.length / sizeof(T))};
+}
+
+/// @brief A binary net file mapped into memory.
+/// Opening checks the header and the section bounds only, the incidence is used straight from the mapping
+/// without parsing or allocating. Call verify() before trusting the indices of a file from an unknown source.
+class MappedNet
+{
+public:
+    explicit MappedNet(const std::string &path);
+
+    [[nodiscard]] const NetView &view() const;
+
+    /// @brief Checks every offset, index and weight, throws std::runtime_error on the first inconsistency.
+    void verify() const;
+
+private:
+    MappedFile file;
+    std::string path;
+    NetView net;
+};
+
+void writeBinaryNet(const PetriNet &net, std::ostream &out);
+void saveBinaryNet(const PetriNet &net, const std::string &path);
+PetriNet netFromView(const NetView &view);
+
+#endif //PETRINETS_BINARYNET_H
@@ -0,0 +1,62 @@
+#ifndef PETRINETS_BISIMULATION_H
+#define PETRINETS_BISIMULATION_H
+
+#include "Types.h"
+
+#include <compare>
+#include <span>
+#include <vector>
+
+/// @brief Equivalence a transition-labelled graph is reduced by.
+enum class Equivalence
+{
+    None,     // Every state stays on its own
+    Strong,   // States firing the same transitions into equivalent states are merged
+    Branching // Like strong, but silent transitions between equivalent states are invisible
+};
+
+/// @brief How to reduce a graph, see drawingQuotient.
+struct BisimulationOptions
+{
+    Equivalence equivalence = Equivalence::None;
+    std::vector<bool> silent; // Silent (tau) transitions for branching bisimulation, indexed by transition id
+};
+
+/// @brief Edge of a transition-labelled graph such as a reachability graph.
+struct LabeledEdge
+{
+    StateId from;
+    TransitionId transition;
+    StateId to;
+
+    auto operator<=>(const LabeledEdge &other) const = default;
+};
+
+/// @brief A graph with its bisimilar states merged into blocks.
+struct Quotient
+{
+    std::vector<uint32_t> blockOf;        // Block of every state
+    std::vector<StateId> representatives; // Lowest state of every block, blocks are numbered in the order of these
+    std::vector<LabeledEdge> edges;       // Edges between blocks, sorted and without duplicates
+
+    [[nodiscard]] size_t blockCount() const
+    {
+        return representatives.size();
+    }
+};
+
+/// @brief Merges the bisimilar states of a transition-labelled graph to draw fewer nodes.
+/// Strong bisimulation is computed by Paige-Tarjan partition refinement in O(E log V). Branching bisimulation
+/// first merges cycles of silent transitions and then refines signatures (Blom-Orzan), in O(E) per round; it is
+/// divergence-sensitive, a block of states that can loop silently forever keeps a silent loop in the quotient.
+/// Only drawings use it. The soundness queries (option to complete, deadlocks, livelocks) run once in O(V + E) on
+/// the ReachabilityGraph itself, which the quotient can't make cheaper since building it alone costs more.
+/// @param stateCount Number of states, edges refer to 0 .. stateCount - 1.
+/// @param edges Edges of the graph, in any order.
+/// @param options Equivalence and silent transitions.
+/// @param colors Only states of the same colour are merged (e.g. the STATE_FINAL flag), empty if all are alike.
+/// @return (Quotient) Block of every state and the edges between blocks, the block of state 0 is block 0.
+Quotient drawingQuotient(size_t stateCount, std::span<const LabeledEdge> edges, const BisimulationOptions &options,
+                              std::span<const uint32_t> colors = {});
+
+#endif //PETRINETS_BISIMULATION_H
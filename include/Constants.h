@@ -1,13 +1,39 @@
 #ifndef PETRINETS_CONSTANTS_H
 #define PETRINETS_CONSTANTS_H
 
+#include <cstddef>
+#include <cstdint>
+
 // Constants related to graphical representation
 const int REACHABILITY_GRAPH_WIDTH = 1000; // The width of the reachability graph
 const int ITERATIONS = 500;                // The number of iterations for force-directed graph layout
-const double ATTRACTION_CONSTANT = 0.5;    // The attraction constant used in the graph layout algorithm
-const double MAX_FORCE = 1e5;              // The maximum force to apply in graph layout
-const double MIN_FORCE = 1e-3;             // The minimum force to apply in graph layout
+const double LAYOUT_THETA = 0.8;           // Barnes-Hut opening angle, smaller is more accurate and slower (0 is exact)
+const double LAYOUT_TOLERANCE = 1e-3;      // The layout stops once nodes move less than this (in edge lengths) on average
+const size_t LAYOUT_THREADS = 0;           // Threads computing the layout forces, 0 uses every core
+const size_t MULTILEVEL_COARSEST = 64;     // Multilevel layout stops coarsening at this many nodes
+const int MULTILEVEL_ITERATIONS = 100;     // Refinement iterations on every finer level of a multilevel layout
+const float MULTILEVEL_TEMPERATURE = 1.0f; // Largest refinement step in edge lengths, the coarse layout is already close
+const int LAYERED_SWEEPS = 12;             // Crossing minimization sweeps of the layered Petri net layout
+const int LAYER_SPACING = 150;             // Horizontal distance between the layers of a Petri net drawing
+const int LAYER_NODE_SPACING = 120;        // Vertical distance between the nodes of one layer
+const char *const LAYOUT_CACHE_DIRECTORY = "petrinets"; // Layouts kept between runs, inside the user's cache directory, see LayoutCache
+const uintmax_t LAYOUT_CACHE_MAX_BYTES = 64 << 20; // The layout cache drops its least recently used files beyond this size
+const double LAYOUT_WARM_START = 0.5;      // Share of the nodes a cached layout must place to start from it
+const bool ANIMATE_WITNESS = true;         // Save the witness as one animated witness.svg instead of 1st.svg, 2nd.svg, ...
+const double WITNESS_STEP_SECONDS = 1.0;   // Time every step of the animated witness is shown
+const size_t RENDER_THREADS = 2;           // Background threads writing drawings to disk
 const int NODE_RADIUS = 25;                // The radius of a node in the graph
 const int SPACE_BETWEEN_NODES = 200;       // Space between nodes in the SVG output
 
+// Constants related to state-space exploration
+const size_t DEFAULT_STATE_LIMIT = 1000000; // States explored before giving up on a (possibly unbounded) net
+const size_t FARKAS_ROW_LIMIT = 100000;     // Rows Farkas' algorithm may hold before giving up on the invariants
+const int64_t UNBOUNDED_PLACE = INT64_MAX;  // Bound of a place no place invariant covers
+const size_t SIPHON_SEARCH_LIMIT = 100000;  // Subproblems the minimal siphon and trap enumeration may split into
+const size_t FRAGMENT_THREADS = 0;          // Threads verifying the fragments of a decomposed workflow net, 0 uses every core
+const size_t FRAGMENT_STATE_LIMIT = 100000; // States explored in one fragment before giving up on the decomposition
+const size_t SCOMPONENT_SEARCH_LIMIT = 100000; // Branches the search for an S-component through one place may explore
+const uint32_t MAX_K_SOUNDNESS = 64;        // Largest number of cases batch mode checks k-soundness for (-k)
+const size_t MAX_BATCH_JOBS = 1024;         // Most worker threads batch mode accepts (-j)
+
 #endif //PETRINETS_CONSTANTS_H
@@ -0,0 +1,339 @@
+#ifndef PETRINETS_FLATHASH_H
+#define PETRINETS_FLATHASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Mixes the bits of a 64-bit value (splitmix64 finalizer).
+/// @param x Value to mix.
+/// @return (uint64_t) Mixed value, suitable for power-of-two bucket masks.
+inline uint64_t mixHash(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/// @brief Default hash for flat hash containers, integral keys are mixed so dense ids spread over the table.
+template <typename Key>
+struct FlatHash
+{
+    size_t operator()(const Key &key) const
+    {
+        if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>)
+        {
+            return static_cast<size_t>(mixHash(static_cast<uint64_t>(key)));
+        }
+        else
+        {
+            return static_cast<size_t>(mixHash(std::hash<Key>()(key)));
+        }
+    }
+};
+
+/// @brief Open-addressing hash map with linear probing, keys and values are stored inline in one array.
+/// @tparam Key Key type, must be copyable.
+/// @tparam Value Mapped type.
+/// @tparam Hash Hash functor.
+template <typename Key, typename Value, typename Hash = FlatHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+public:
+    typedef std::pair<Key, Value> value_type;
+
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        typedef std::conditional_t<Const, const FlatHashMap *, FlatHashMap *> MapPointer;
+        typedef std::conditional_t<Const, const value_type, value_type> Entry;
+
+        Iterator(MapPointer map, size_t index) : map(map), index(index)
+        {
+            skip();
+        }
+        Entry &operator*() const
+        {
+            return map->slots[index];
+        }
+        Entry *operator->() const
+        {
+            return &map->slots[index];
+        }
+        Iterator &operator++()
+        {
+            ++index;
+            skip();
+            return *this;
+        }
+        bool operator==(const Iterator &other) const
+        {
+            return index == other.index;
+        }
+        bool operator!=(const Iterator &other) const
+        {
+            return index != other.index;
+        }
+
+    private:
+        friend class FlatHashMap;
+        void skip()
+        {
+            while (index < map->used.size() && !map->used[index])
+            {
+                ++index;
+            }
+        }
+        MapPointer map;
+        size_t index;
+    };
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    FlatHashMap() = default;
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+    iterator end()
+    {
+        return iterator(this, used.size());
+    }
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const
+    {
+        return const_iterator(this, used.size());
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return count_;
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return count_ == 0;
+    }
+
+    void clear()
+    {
+        slots.clear();
+        used.clear();
+        count_ = 0;
+    }
+
+    /// @brief Ensures the map can hold n entries without rehashing.
+    void reserve(size_t n)
+    {
+        size_t capacity = 16;
+        while (capacity * 7 / 8 < n)
+        {
+            capacity *= 2;
+        }
+        if (capacity > used.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    iterator find(const Key &key)
+    {
+        return iterator(this, locate(key));
+    }
+    const_iterator find(const Key &key) const
+    {
+        return const_iterator(this, locate(key));
+    }
+    [[nodiscard]] size_t count(const Key &key) const
+    {
+        return locate(key) != used.size() ? 1 : 0;
+    }
+    [[nodiscard]] bool contains(const Key &key) const
+    {
+        return locate(key) != used.size();
+    }
+
+    Value &at(const Key &key)
+    {
+        size_t index = locate(key);
+        if (index == used.size())
+        {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return slots[index].second;
+    }
+    const Value &at(const Key &key) const
+    {
+        size_t index = locate(key);
+        if (index == used.size())
+        {
+            throw std::out_of_range("FlatHashMap::at: key not found");
+        }
+        return slots[index].second;
+    }
+
+    Value &operator[](const Key &key)
+    {
+        return emplace(key, Value()).first->second;
+    }
+
+    /// @brief Inserts key -> value if key is absent.
+    /// @return (pair) Iterator to the entry and true if it was inserted.
+    std::pair<iterator, bool> emplace(const Key &key, Value value)
+    {
+        if ((count_ + 1) * 8 > used.size() * 7)
+        {
+            rehash(used.empty() ? 16 : used.size() * 2);
+        }
+        size_t mask = used.size() - 1;
+        size_t index = Hash()(key) & mask;
+        while (used[index])
+        {
+            if (KeyEqual()(slots[index].first, key))
+            {
+                return {iterator(this, index), false};
+            }
+            index = (index + 1) & mask;
+        }
+        used[index] = 1;
+        slots[index] = value_type(key, std::move(value));
+        ++count_;
+        return {iterator(this, index), true};
+    }
+    std::pair<iterator, bool> insert(const value_type &entry)
+    {
+        return emplace(entry.first, entry.second);
+    }
+
+    /// @brief Removes key using backward-shift deletion (no tombstones).
+    /// @return (size_t) Number of removed entries (0 or 1).
+    size_t erase(const Key &key)
+    {
+        size_t index = locate(key);
+        if (index == used.size())
+        {
+            return 0;
+        }
+        size_t mask = used.size() - 1;
+        size_t hole = index;
+        size_t next = (hole + 1) & mask;
+        while (used[next])
+        {
+            size_t home = Hash()(slots[next].first) & mask;
+            // Move the entry back if the hole lies on its probe path
+            if (((next - home) & mask) >= ((next - hole) & mask))
+            {
+                slots[hole] = std::move(slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+        used[hole] = 0;
+        slots[hole] = value_type();
+        --count_;
+        return 1;
+    }
+
+private:
+    size_t locate(const Key &key) const
+    {
+        if (count_ == 0)
+        {
+            return used.size();
+        }
+        size_t mask = used.size() - 1;
+        size_t index = Hash()(key) & mask;
+        while (used[index])
+        {
+            if (KeyEqual()(slots[index].first, key))
+            {
+                return index;
+            }
+            index = (index + 1) & mask;
+        }
+        return used.size();
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<value_type> oldSlots(capacity);
+        std::vector<uint8_t> oldUsed(capacity, 0);
+        oldSlots.swap(slots);
+        oldUsed.swap(used);
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < oldUsed.size(); i++)
+        {
+            if (!oldUsed[i])
+            {
+                continue;
+            }
+            size_t index = Hash()(oldSlots[i].first) & mask;
+            while (used[index])
+            {
+                index = (index + 1) & mask;
+            }
+            used[index] = 1;
+            slots[index] = std::move(oldSlots[i]);
+        }
+    }
+
+    std::vector<value_type> slots;
+    std::vector<uint8_t> used;
+    size_t count_ = 0;
+};
+
+/// @brief Open-addressing hash set built on FlatHashMap.
+template <typename Key, typename Hash = FlatHash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashSet
+{
+public:
+    /// @return (Bool) True if the key was inserted, false if it was already present.
+    bool insert(const Key &key)
+    {
+        return map.emplace(key, 0).second;
+    }
+    [[nodiscard]] size_t count(const Key &key) const
+    {
+        return map.count(key);
+    }
+    [[nodiscard]] bool contains(const Key &key) const
+    {
+        return map.contains(key);
+    }
+    size_t erase(const Key &key)
+    {
+        return map.erase(key);
+    }
+    void reserve(size_t n)
+    {
+        map.reserve(n);
+    }
+    void clear()
+    {
+        map.clear();
+    }
+    [[nodiscard]] size_t size() const
+    {
+        return map.size();
+    }
+    [[nodiscard]] bool empty() const
+    {
+        return map.empty();
+    }
+
+private:
+    FlatHashMap<Key, uint8_t, Hash, KeyEqual> map;
+};
+
+#endif //PETRINETS_FLATHASH_H
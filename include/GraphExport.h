@@ -0,0 +1,53 @@
+#ifndef PETRINETS_GRAPHEXPORT_H
+#define PETRINETS_GRAPHEXPORT_H
+
+#include "NetView.h"
+#include "StateSpace.h"
+
+#include <ostream>
+#include <string>
+
+/// @brief Streams the reachability graph as Graphviz DOT while it is explored.
+/// Each state is written when it is expanded and each edge when it is found, nothing is kept in between.
+class DotStateSpaceWriter : public StateSpaceObserver
+{
+public:
+    DotStateSpaceWriter(std::ostream &out, const NetView &net);
+
+    void onEdge(StateId from, TransitionId transition, StateId to) override;
+    void onExpanded(StateId state, std::span<const int32_t> marking, uint8_t flags) override;
+    void onFinish(const StateSpaceResult &result) override;
+
+private:
+    std::ostream &out;
+    NetView net;
+};
+
+/// @brief Streams the reachability graph as GraphML while it is explored.
+/// Nodes carry the marking and the initial/final/deadlock flags, edges the transition name and id.
+class GraphmlStateSpaceWriter : public StateSpaceObserver
+{
+public:
+    GraphmlStateSpaceWriter(std::ostream &out, const NetView &net);
+
+    void onEdge(StateId from, TransitionId transition, StateId to) override;
+    void onExpanded(StateId state, std::span<const int32_t> marking, uint8_t flags) override;
+    void onFinish(const StateSpaceResult &result) override;
+
+private:
+    std::ostream &out;
+    NetView net;
+};
+
+void writeNetDot(const NetView &net, std::ostream &out);
+void writeNetGraphml(const NetView &net, std::ostream &out);
+
+/// @brief Explores the reachability graph of a net and writes it to a file.
+/// The format is picked from the extension: .dot, .graphml or the binary .prg dump.
+StateSpaceResult exportReachabilityGraph(const NetView &net, const std::string &path, size_t maxStates = 0);
+
+/// @brief Writes the structure of a net as .dot or .graphml, picked from the extension.
+/// @return (bool) False if the extension isn't one of the two.
+bool exportNetGraph(const NetView &net, const std::string &path);
+
+#endif //PETRINETS_GRAPHEXPORT_H
@@ -0,0 +1,54 @@
+#ifndef PETRINETS_INVARIANTS_H
+#define PETRINETS_INVARIANTS_H
+
+#include "Constants.h"
+#include "NetView.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Semi-positive place invariant with minimal support, as a sparse vector.
+/// A place invariant y keeps y·M constant in every reachable marking M.
+struct Invariant
+{
+    std::vector<uint32_t> support; // Places with a positive weight, increasing
+    std::vector<int64_t> weights;  // Parallel to support, without a common divisor
+};
+
+/// @brief Result of placeInvariants.
+struct InvariantBasis
+{
+    std::vector<Invariant> invariants;
+    bool complete = true; // False if the row limit or a coefficient overflow stopped the elimination, invariants is empty then
+};
+
+/// @brief Minimal semi-positive place invariants (solutions of y·C = 0, y >= 0) by Farkas' algorithm on the sparse
+/// incidence matrix C. Transitions are eliminated one at a time, the one creating the fewest new rows first. Every
+/// combination is reduced by the gcd of its entries and dropped if its support contains the support of another row,
+/// which keeps only minimal supports. Coefficients are 64-bit and every product and sum is checked for overflow, a
+/// result of INT64_MIN counts as one so that every entry can be negated.
+/// @param net Net to analyze.
+/// @param maxRows Give up when an elimination step would hold more rows than this.
+InvariantBasis placeInvariants(const NetView &net, size_t maxRows = FARKAS_ROW_LIMIT);
+
+/// @brief Token bounds every reachable marking respects: y·M = y·M0 for every place invariant y, so a place p in
+/// its support never holds more than y·M0 / y(p) tokens.
+struct PlaceBounds
+{
+    std::vector<int64_t> tokens; // Bound of every place, UNBOUNDED_PLACE where no invariant covers it
+
+    /// @return (bool) Every place is covered, the net is bounded from this marking whatever it does.
+    [[nodiscard]] bool bounded() const;
+};
+
+/// @brief Smallest bound the invariants give every place.
+/// @param net Net to bound, its current tokens are the initial marking.
+/// @param basis Place invariants of the net.
+PlaceBounds placeBounds(const NetView &net, const InvariantBasis &basis);
+
+/// @brief Whether a place invariant tells two markings apart (y·a != y·b), in which case neither is reachable from
+/// the other: it is the cheapest proof that the final marking of a workflow net can't be reached.
+bool separates(const Invariant &invariant, std::span<const int32_t> a, std::span<const int32_t> b);
+
+#endif //PETRINETS_INVARIANTS_H
@@ -0,0 +1,32 @@
+#ifndef PETRINETS_KSOUNDNESS_H
+#define PETRINETS_KSOUNDNESS_H
+
+#include "Constants.h"
+#include "NetView.h"
+
+#include <cstdint>
+#include <vector>
+
+/// @brief Verdict of checkKSoundness for one number of cases.
+struct KSoundnessLevel
+{
+    uint32_t k = 0;
+    bool sound = false;    // Every marking reachable from k tokens in i can reach k tokens in o
+    bool complete = true;  // False if the state limit cut the level short, it isn't sound then
+    size_t states = 0;     // Markings reachable from k tokens in i
+    size_t inherited = 0;  // Of these, the ones composed from the levels below instead of being discovered
+    size_t stuck = 0;      // Markings that can't reach k tokens in o
+};
+
+/// @brief Checks k-soundness for k = 1..maxK in one sweep, every level built on the one below.
+/// k cases can run one after the other, so every sum of a marking reachable with k - 1 cases and one reachable
+/// with a single case is reachable with k. These sums seed the level without being discovered, and from them only
+/// transitions taking tokens of both parts (joins not enabled in either) can lead anywhere new. A sum whose parts
+/// can both complete can complete too, the backward search only has to settle the rest.
+/// @param net Net to check, only the places i and o (see findWorkflowPlaces) matter for the marking: the others start empty.
+/// @param maxK Largest number of cases to check.
+/// @param maxStates Stop a level after this many states, 0 for no limit. The sweep ends with the first cut level.
+/// @return (std::vector) One entry per level checked, in increasing k.
+std::vector<KSoundnessLevel> checkKSoundness(const NetView &net, uint32_t maxK, size_t maxStates = DEFAULT_STATE_LIMIT);
+
+#endif //PETRINETS_KSOUNDNESS_H
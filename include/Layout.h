@@ -0,0 +1,99 @@
+#ifndef PETRINETS_LAYOUT_H
+#define PETRINETS_LAYOUT_H
+
+#include "Constants.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// @brief Graph to lay out, nodes are numbered 0 .. nodeCount - 1.
+/// Edges go from first to second; only the layered layout looks at their direction.
+struct LayoutGraph
+{
+    size_t nodeCount = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+};
+
+/// @brief Node positions as separate coordinate arrays (structure of arrays).
+struct LayoutPositions
+{
+    std::vector<float> x;
+    std::vector<float> y;
+
+    [[nodiscard]] size_t size() const
+    {
+        return x.size();
+    }
+};
+
+/// @brief Layout algorithm, see forceDirectedLayout and multilevelLayout.
+enum class LayoutMode
+{
+    ForceDirected,
+    Multilevel
+};
+
+/// @brief Result of a layered layout: the layer of every node and its rank (0 is first) within the layer.
+struct LayeredPositions
+{
+    std::vector<uint32_t> layer;
+    std::vector<uint32_t> rank;
+    std::vector<uint32_t> layerSizes;
+    size_t crossings = 0; // Crossings between edges joining adjacent layers
+};
+
+/// @brief LAYOUT_CACHE_DIRECTORY inside the user's cache directory ($XDG_CACHE_HOME, ~/.cache or %LOCALAPPDATA%),
+/// or inside the temporary directory if there is none. Defined in LayoutCache.cpp.
+std::string defaultLayoutCacheDirectory();
+
+/// @brief Tuning of the force-directed layout.
+struct LayoutOptions
+{
+    LayoutMode mode = LayoutMode::ForceDirected;
+    int iterations = ITERATIONS;
+    double theta = LAYOUT_THETA;
+    size_t threads = LAYOUT_THREADS; // 0 uses the hardware concurrency, the result is the same for any count
+    bool refine = false;             // The positions are nearly final (a cached layout), only take small steps
+    std::string cacheDirectory = defaultLayoutCacheDirectory(); // Where the SVG writers keep layouts, empty disables it
+};
+
+/// @brief Places the nodes on a spiral, a deterministic starting point without overlapping nodes.
+void spiralLayout(size_t nodeCount, LayoutPositions &positions);
+
+/// @brief Fruchterman-Reingold layout with Barnes-Hut approximated repulsion, O(N log N + E) per iteration.
+/// Positions are in units of the ideal edge length; the caller scales them to the canvas.
+/// @param graph Graph to lay out.
+/// @param positions Starting positions, replaced by a spiral if they don't match the node count.
+/// Forces are computed in parallel over fixed chunks of nodes with SSE2 kernels where available.
+/// @param options Iterations, Barnes-Hut accuracy and threads.
+void forceDirectedLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options = {});
+
+/// @brief Multilevel layout: coarsens the graph by matching neighbours, lays out the coarsest graph and
+/// interpolates it back level by level with a short refinement each. Levels shrink geometrically, so the
+/// total cost is close to that of a few iterations on the full graph. Starting positions are ignored.
+void multilevelLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options = {});
+
+/// @brief Sugiyama-style layered layout of a directed graph.
+/// Layers are breadth-first distances from the sources (nodes not reached start new searches from layer 0 in id
+/// order), so every forward edge joins adjacent layers. The layers are then reordered by barycentric sweeps, each
+/// sorting a layer by the mean rank of the node's neighbours in the layer before (or after) it, which costs
+/// O((V + E) log V) per sweep like the crossing count; the order with the fewest crossings is kept.
+/// @param sources Nodes in the first layer, e.g. the initially marked places of a net.
+/// @param sweeps Number of down and up sweep pairs, stops early once no edges cross.
+/// @param initialOrder Relative position (0 .. 1) of every node within its layer to start the sweeps from, NaN for
+/// nodes without one, which keep their breadth-first position. Empty starts from the breadth-first order.
+void layeredLayout(const LayoutGraph &graph, std::span<const uint32_t> sources, LayeredPositions &positions, int sweeps = LAYERED_SWEEPS,
+                   std::span<const float> initialOrder = {});
+
+/// @brief Places the nodes without a position next to a neighbour that has one, for warm starts from an older layout.
+/// Nodes not connected to any placed node go on a spiral beside the placed ones.
+/// @param known Which nodes already have a position.
+void placeNewNodes(const LayoutGraph &graph, LayoutPositions &positions, const std::vector<bool> &known);
+
+/// @brief Lays out a graph with the algorithm picked by options.mode, or refines it if options.refine is set.
+void computeLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options = {});
+
+#endif //PETRINETS_LAYOUT_H
@@ -0,0 +1,58 @@
+#ifndef PETRINETS_LAYOUTCACHE_H
+#define PETRINETS_LAYOUTCACHE_H
+
+#include "Constants.h"
+#include "Layout.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Magic bytes at the start of a cached layout.
+const char LAYOUT_CACHE_MAGIC[8] = {'P', 'N', 'L', 'A', 'Y', 'O', 'U', 'T'};
+const uint32_t LAYOUT_CACHE_VERSION = 1;
+
+/// @brief Canonical hash of a graph to lay out, independent of the order its edges are listed in.
+/// @param keys Stable name of every node (a marking, a place name), part of the hash.
+/// @param kind Layout algorithm, the same graph laid out differently gets a different fingerprint.
+uint64_t graphFingerprint(const LayoutGraph &graph, const std::vector<std::string> &keys, std::string_view kind);
+
+/// @brief Layouts kept on disk between runs, one file per graph fingerprint.
+/// Every drawing (output file) also remembers the fingerprint of its last layout, so a graph that changed
+/// can start from the positions of its previous version, matched node by node through the keys.
+/// The cache never stops a drawing: unreadable files count as missing and failed writes are ignored. Files are
+/// written under a name unique to the writer and renamed, and the directory is trimmed to a size limit after every
+/// write, dropping the files used least recently first.
+class LayoutCache
+{
+public:
+    /// @param directory Directory of the cache files, empty disables the cache.
+    /// @param maxBytes Size the directory is trimmed to.
+    explicit LayoutCache(const std::string &directory, uintmax_t maxBytes = LAYOUT_CACHE_MAX_BYTES);
+
+    [[nodiscard]] bool enabled() const;
+
+    /// @brief Looks up the layout of exactly this graph.
+    /// @return (bool) True if it was cached, positions then holds it.
+    bool find(uint64_t fingerprint, const std::vector<std::string> &keys, LayoutPositions &positions) const;
+
+    /// @brief Starts from the last layout of a drawing, for the nodes whose key it contains.
+    /// @param known Receives which nodes got a cached position.
+    /// @return (size_t) Number of nodes with a cached position.
+    size_t warmStart(const std::string &drawing, const std::vector<std::string> &keys, LayoutPositions &positions, std::vector<bool> &known) const;
+
+    /// @brief Saves a layout and records it as the last layout of the drawing.
+    void store(const std::string &drawing, uint64_t fingerprint, const std::vector<std::string> &keys, const LayoutPositions &positions) const;
+
+private:
+    [[nodiscard]] std::filesystem::path entryPath(uint64_t fingerprint) const;
+    [[nodiscard]] std::filesystem::path drawingPath(const std::string &drawing) const;
+    void trim() const;
+
+    std::filesystem::path directory;
+    uintmax_t maxBytes;
+};
+
+#endif //PETRINETS_LAYOUTCACHE_H
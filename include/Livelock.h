@@ -0,0 +1,51 @@
+#ifndef PETRINETS_LIVELOCK_H
+#define PETRINETS_LIVELOCK_H
+
+#include "Constants.h"
+#include "NetView.h"
+#include "ReachabilityGraph.h"
+#include "StateSpace.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Bottom strongly connected component of the reachability graph without the final marking.
+/// Its states can never complete: a single state without enabled transitions is a deadlock, anything else
+/// (a cycle or a group of cycles no transition leaves) a livelock.
+struct StuckComponent
+{
+    std::vector<StateId> states;
+    bool deadlock = false;
+};
+
+/// @brief Result of findStuckComponents.
+struct LivelockReport
+{
+    std::vector<StuckComponent> components; // In the order they closed
+    MarkingStore markings;                  // Markings of the explored states, to describe the components
+    size_t states = 0;
+    bool complete = true;        // False if the state limit, stopAtFirst or maxTokens ended the search early
+    bool exceededTokens = false; // A marking held more than maxTokens in a place, it is the last one stored
+};
+
+/// @brief Depth-first exploration running Tarjan's algorithm on the fly: every strongly connected component
+/// is checked the moment it closes, so stuck components are found in one pass over the reachable markings.
+/// States whose successors were cut off by the state limit count as leaving their component, the search
+/// never reports a component it hasn't seen completely.
+/// @param net Net to explore, its current tokens are the initial marking.
+/// @param finalMarking Marking the components must reach, empty if none counts as final.
+/// @param stopAtFirst Return as soon as the first stuck component closes.
+/// @param maxStates Stop discovering new states after this many, 0 for no limit.
+/// @param maxTokens Stop at the first marking with more tokens than this in a place, 0 for no bound.
+LivelockReport findStuckComponents(const NetView &net, std::span<const int32_t> finalMarking, bool stopAtFirst = false,
+                                   size_t maxStates = DEFAULT_STATE_LIMIT, int32_t maxTokens = 0);
+
+/// @brief Stuck components of an explored reachability graph: its bottom strongly connected components without a
+/// STATE_FINAL state. A component with a STATE_TRUNCATED state may have successors the state limit left out, it is
+/// never reported.
+/// @param graph Graph explored with the final marking.
+/// @return (std::vector) The components in the order they closed.
+std::vector<StuckComponent> findStuckComponents(const ReachabilityGraph &graph);
+
+#endif //PETRINETS_LIVELOCK_H
@@ -0,0 +1,35 @@
+#ifndef PETRINETS_MAPPEDFILE_H
+#define PETRINETS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/// @brief Read-only memory mapping of a whole file.
+/// On platforms without mmap the file is read into memory instead.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &path, bool sequential = true);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    [[nodiscard]] const char *data() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] std::string_view view() const;
+
+private:
+    void release();
+
+    const char *bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::string buffer;
+#endif
+};
+
+#endif //PETRINETS_MAPPEDFILE_H
@@ -0,0 +1,51 @@
+#ifndef PETRINETS_NAMETABLE_H
+#define PETRINETS_NAMETABLE_H
+
+#include "Types.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief String interner mapping names to dense ids.
+/// Names are stored back to back in a single character pool, ids are indices in insertion order.
+class NameTable
+{
+public:
+    /// @brief Interns a name.
+    /// @param name Name to intern.
+    /// @return (NameId) Id of the name, a new id is assigned if it wasn't interned before.
+    NameId intern(std::string_view name);
+
+    /// @brief Looks up an already interned name.
+    /// @param name Name to look up.
+    /// @return (NameId) Id of the name, INVALID_ID if it isn't interned.
+    [[nodiscard]] NameId find(std::string_view name) const;
+
+    /// @brief Resolves an id back to its name.
+    /// @param id Id returned by intern.
+    /// @return (std::string_view) View into the pool, valid until the next intern call.
+    [[nodiscard]] std::string_view name(NameId id) const;
+
+    [[nodiscard]] size_t size() const;
+
+    /// @brief Characters of all names back to back, name n spans pool()[offsets()[n] .. offsets()[n + 1]).
+    [[nodiscard]] std::string_view pool() const;
+
+    [[nodiscard]] std::span<const uint32_t> offsets() const;
+
+    /// @brief Reserves space for the given number of names and total characters.
+    void reserve(size_t names, size_t characterCount);
+
+private:
+    void rehash(size_t capacity);
+
+    std::string characters;
+    std::vector<uint32_t> boundaries = {0};
+    // Open-addressing index, each slot holds a name id and the low bits of its hash
+    std::vector<std::pair<NameId, uint32_t>> slots;
+};
+
+#endif //PETRINETS_NAMETABLE_H
@@ -0,0 +1,50 @@
+#ifndef PETRINETS_NETLOADER_H
+#define PETRINETS_NETLOADER_H
+
+#include "BinaryNet.h"
+#include "NetView.h"
+#include "Petrinet.h"
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/// @brief Raised when a net description can't be parsed, carries the position of the offending token.
+class NetParseError : public std::runtime_error
+{
+public:
+    NetParseError(const std::string &source, size_t line, size_t column, const std::string &message);
+
+    [[nodiscard]] size_t line() const;
+    [[nodiscard]] size_t column() const;
+
+private:
+    size_t line_;
+    size_t column_;
+};
+
+/// @brief A net loaded to be read only. Binary nets (.pnb) stay mapped and are used in place, the other formats are
+/// parsed into a PetriNet the view points into, so the object can't be copied or moved.
+class LoadedNet
+{
+public:
+    explicit LoadedNet(const std::string &path);
+
+    LoadedNet(const LoadedNet &) = delete;
+    LoadedNet &operator=(const LoadedNet &) = delete;
+
+    [[nodiscard]] const NetView &view() const;
+
+private:
+    std::optional<MappedNet> mapped;
+    PetriNet net;
+    NetView netView;
+};
+
+PetriNet parseNet(std::string_view text, const std::string &source = "<input>");
+PetriNet loadNetFromFile(const std::string &path);
+PetriNet loadNet(const std::string &path, NetLayout *layout = nullptr);
+bool isNetFile(const std::string &path);
+
+#endif //PETRINETS_NETLOADER_H
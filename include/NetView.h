@@ -0,0 +1,101 @@
+#ifndef PETRINETS_NETVIEW_H
+#define PETRINETS_NETVIEW_H
+
+#include "Types.h"
+
+#include <span>
+#include <string_view>
+
+/// @brief Non-owning compressed sparse row adjacency, see CsrIndex.
+struct CsrView
+{
+    std::span<const uint32_t> offsets;
+    std::span<const uint32_t> targets;
+    std::span<const uint32_t> weights;
+
+    CsrView() = default;
+    CsrView(std::span<const uint32_t> offsets, std::span<const uint32_t> targets, std::span<const uint32_t> weights)
+        : offsets(offsets), targets(targets), weights(weights)
+    {
+    }
+    CsrView(const CsrIndex &index) : offsets(index.offsets), targets(index.targets), weights(index.weights)
+    {
+    }
+
+    [[nodiscard]] std::span<const uint32_t> operator[](uint32_t row) const
+    {
+        return targets.subspan(offsets[row], offsets[row + 1] - offsets[row]);
+    }
+    [[nodiscard]] std::span<const uint32_t> weightsOf(uint32_t row) const
+    {
+        return weights.subspan(offsets[row], offsets[row + 1] - offsets[row]);
+    }
+    [[nodiscard]] size_t rows() const
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+};
+
+/// @brief Read-only view of a finalized net: structure, incidence, names and initial marking.
+/// Produced by PetriNet::view() or by a MappedNet straight from a binary file, so code written
+/// against it runs on both without copying. The view must not outlive the object it was taken from.
+struct NetView
+{
+    std::span<const Place> places;
+    std::span<const Transition> transitions;
+    CsrView transitionInputs;
+    CsrView transitionOutputs;
+    CsrView placeInputs;
+    CsrView placeOutputs;
+    // Name pool, name n spans namePool[nameOffsets[n] .. nameOffsets[n + 1])
+    std::string_view namePool;
+    std::span<const uint32_t> nameOffsets;
+    bool ordinary = true;
+
+    [[nodiscard]] size_t placeCount() const
+    {
+        return places.size();
+    }
+    [[nodiscard]] size_t transitionCount() const
+    {
+        return transitions.size();
+    }
+    [[nodiscard]] std::span<const PlaceId> preset(TransitionId transition) const
+    {
+        return transitionInputs[transition];
+    }
+    [[nodiscard]] std::span<const PlaceId> postset(TransitionId transition) const
+    {
+        return transitionOutputs[transition];
+    }
+    [[nodiscard]] std::span<const uint32_t> presetWeights(TransitionId transition) const
+    {
+        return transitionInputs.weightsOf(transition);
+    }
+    [[nodiscard]] std::span<const uint32_t> postsetWeights(TransitionId transition) const
+    {
+        return transitionOutputs.weightsOf(transition);
+    }
+    [[nodiscard]] std::span<const TransitionId> placePreset(PlaceId place) const
+    {
+        return placeInputs[place];
+    }
+    [[nodiscard]] std::span<const TransitionId> placePostset(PlaceId place) const
+    {
+        return placeOutputs[place];
+    }
+    [[nodiscard]] std::string_view name(NameId id) const
+    {
+        return namePool.substr(nameOffsets[id], nameOffsets[id + 1] - nameOffsets[id]);
+    }
+    [[nodiscard]] std::string_view placeName(PlaceId place) const
+    {
+        return name(places[place].name);
+    }
+    [[nodiscard]] std::string_view transitionName(TransitionId transition) const
+    {
+        return name(transitions[transition].name);
+    }
+};
+
+#endif //PETRINETS_NETVIEW_H
@@ -0,0 +1,44 @@
+#ifndef PETRINETS_PETRINETBUILDER_H
+#define PETRINETS_PETRINETBUILDER_H
+
+#include "Petrinet.h"
+
+#include <span>
+#include <string_view>
+
+/// @brief Place description for batch insertion.
+struct PlaceSpec
+{
+    std::string_view name;
+    int tokens;
+};
+
+/// @brief Builds a PetriNet from batches of places, transitions and arcs.
+/// Capacity is reserved up front, duplicate arcs are dropped through a hash set and
+/// build() finalizes the incidence in O(V+E).
+class PetriNetBuilder
+{
+public:
+    PetriNetBuilder() = default;
+
+    PetriNetBuilder(size_t placeCount, size_t transitionCount, size_t arcCount);
+
+    void reserve(size_t placeCount, size_t transitionCount, size_t arcCount);
+
+    PlaceId addPlaces(std::span<const PlaceSpec> places);
+
+    TransitionId addTransitions(std::span<const std::string_view> names);
+
+    size_t addArcs(std::span<const Edge> arcs);
+
+    [[nodiscard]] size_t placeCount() const;
+
+    [[nodiscard]] size_t transitionCount() const;
+
+    PetriNet build();
+
+private:
+    PetriNet net;
+};
+
+#endif //PETRINETS_PETRINETBUILDER_H
@@ -1,16 +1,41 @@
 #ifndef PETRINETS_PETRINET_H
 #define PETRINETS_PETRINET_H
 
-#include "types.h"
+#include "Types.h"
+#include "NameTable.h"
+#include "NetView.h"
+
+#include <string_view>
 
 class PetriNet {
 public:
     PetriNet(); // Constructor declaration
 
-    bool addPlace(Place &place);
-    bool addTransition(const Transition &transition);
-    bool addArc(const Place &place, const Transition &transition);
-    bool addArc(const Transition &transition, const Place &place);
+    bool addPlace(std::string_view name, int tokens);
+    bool addTransition(std::string_view name);
+    bool addArc(uint32_t from, uint32_t to, ArcDirection direction, uint32_t weight = 1);
+
+    void reserve(size_t placeCount, size_t transitionCount, size_t arcCount);
+
+    void finalize();
+
+    [[nodiscard]] bool isFinalized() const;
+
+    [[nodiscard]] std::span<const PlaceId> preset(TransitionId transition) const;
+
+    [[nodiscard]] std::span<const PlaceId> postset(TransitionId transition) const;
+
+    [[nodiscard]] std::span<const uint32_t> presetWeights(TransitionId transition) const;
+
+    [[nodiscard]] std::span<const uint32_t> postsetWeights(TransitionId transition) const;
+
+    [[nodiscard]] bool isOrdinary() const;
+
+    [[nodiscard]] std::span<const TransitionId> placePreset(PlaceId place) const;
+
+    [[nodiscard]] std::span<const TransitionId> placePostset(PlaceId place) const;
+
+    [[nodiscard]] NetView view() const;
 
 private:
     Places places;
@@ -31,25 +56,42 @@ public:
 
     [[maybe_unused]] void setTransitionMap(const TransitionMap &transitionMap);
 
-    [[nodiscard]] const ReverseTransitionMap &getReverseTransitionMap() const;
-
-    [[maybe_unused]] void setReverseTransitionMap(const ReverseTransitionMap &reverseTransitionMap);
-
     [[nodiscard]] const Arcs &getArcs() const;
 
     [[maybe_unused]] void setArcs(const Arcs &arcs);
 
-    void consumeToken(int);
+    [[nodiscard]] const NameTable &getNames() const;
+
+    [[nodiscard]] PlaceId findPlace(std::string_view name) const;
+
+    [[nodiscard]] TransitionId findTransition(std::string_view name) const;
+
+    [[nodiscard]] TransitionId findTransitionLabel(std::string_view label) const;
+
+    [[nodiscard]] std::string_view placeName(PlaceId place) const;
+
+    [[nodiscard]] std::string_view transitionName(TransitionId transition) const;
+
+    void consumeToken(PlaceId, int count = 1);
 
-    void addToken(int);
+    void addToken(PlaceId, int count = 1);
 
 private:
     Transitions transitions;
     PlaceMap placeMap;
     TransitionMap transitionMap;
-    ReverseTransitionMap reverseTransitionMap;
+    NameTable names;
 
     Arcs arcs;
+    ArcSet arcSet;
+
+    // Incidence built by finalize(), invalidated by structural changes
+    bool finalized = false;
+    bool ordinary = true;
+    CsrIndex transitionInputs;
+    CsrIndex transitionOutputs;
+    CsrIndex placeInputs;
+    CsrIndex placeOutputs;
 };
 
-#endif //PETRINETS_PETRINET_H
\ No newline at end of file
+#endif //PETRINETS_PETRINET_H
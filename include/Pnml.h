@@ -0,0 +1,15 @@
+#ifndef PETRINETS_PNML_H
+#define PETRINETS_PNML_H
+
+#include "Petrinet.h"
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+PetriNet readPnml(std::istream &input, NetLayout *layout = nullptr, const std::string &source = "<pnml>");
+PetriNet loadPnml(const std::string &path, NetLayout *layout = nullptr);
+void writePnml(const PetriNet &net, std::ostream &out, const NetLayout *layout = nullptr);
+void savePnml(const PetriNet &net, const std::string &path, const NetLayout *layout = nullptr);
+
+#endif //PETRINETS_PNML_H
@@ -0,0 +1,72 @@
+#ifndef PETRINETS_PROCESSSTRUCTURE_H
+#define PETRINETS_PROCESSSTRUCTURE_H
+
+#include "Constants.h"
+#include "NetView.h"
+#include "Petrinet.h"
+#include "WorkflowStructure.h"
+
+#include <vector>
+
+/// @brief Single-entry single-exit fragment of a workflow net, bordered by two places: every consumer of the entry
+/// and every producer of the exit is inside, and the inside is connected to the rest of the net through these two
+/// places only. Seen from outside it behaves like one transition taking a token from the entry and putting one into
+/// the exit, the inside is a workflow net of its own with the entry as i and the exit as o.
+struct Fragment
+{
+    PlaceId entry = INVALID_ID;
+    PlaceId exit = INVALID_ID;
+    std::vector<PlaceId> places;   // Interior places, the ones of nested fragments included, increasing
+    TransitionIds transitions;     // Interior transitions, the ones of nested fragments included, increasing
+    uint32_t parent = INVALID_ID;  // Smallest enclosing fragment, INVALID_ID for the root
+};
+
+/// @brief Fragments of a workflow net nested into a tree (a refined process structure tree with place-bordered
+/// fragments). Fragments with the same parent share no interior node.
+struct ProcessStructureTree
+{
+    std::vector<Fragment> fragments; // Children before their parents, the whole net (entry i, exit o) last
+};
+
+/// @brief Decomposes a workflow net into its place-bordered fragments. The exit of the fragment starting at a
+/// place is searched among the place's postdominators, nearest first (Cooper, Harvey and Kennedy's iteration on
+/// the reversed net), and checked by one search from the entry that stops at the exit. Fragments are nested by
+/// increasing size, one crossing a smaller one is dropped.
+/// @param net Workflow net to decompose.
+/// @param structure Result of validateWorkflowNet for the net.
+/// @return (ProcessStructureTree) The tree, empty if the structure has defects, only the root if nothing splits off.
+ProcessStructureTree decomposeWorkflowNet(const NetView &net, const WorkflowStructure &structure);
+
+/// @brief Result of verifying one fragment, see verifyFragments.
+struct FragmentVerdict
+{
+    bool sound = false;
+    bool safe = false;     // No reachable marking holds more than one token in a place
+    bool complete = false; // False if the state limit or an unsafe marking cut the exploration short, or it was skipped
+    size_t states = 0;     // Markings of the fragment explored with its children contracted to places
+};
+
+/// @brief Result of verifyFragments.
+struct DecomposedSoundness
+{
+    bool sound = false;                    // Every fragment is safe and sound, so the net is
+    std::vector<FragmentVerdict> verdicts; // One per fragment of the tree
+    TransitionIds witness;                 // Firing sequence of the net reaching the final marking, if sound
+    size_t states = 0;                     // Markings explored in all fragments together
+    size_t largest = 0;                    // Markings explored in the largest fragment
+};
+
+/// @brief Verifies the fragments of a workflow net one by one, spread over a thread pool. Replacing a transition of
+/// a safe and sound workflow net by a safe and sound workflow net keeps it safe and sound (van der Aalst), so the net
+/// is safe and sound if every fragment is with its children contracted, and the work is bounded by the largest
+/// contracted fragment instead of the product of them all. Any other outcome decides nothing about the whole net:
+/// a fragment may need the tokens only its surroundings provide.
+/// @param net Workflow net with one token in i.
+/// @param tree Result of decomposeWorkflowNet for the net.
+/// @param threads Worker threads, 0 uses every core.
+/// @param maxStates State limit of every fragment, well below the one of the whole net: a fragment this large gains
+/// little over exploring the net, which happens anyway if the fragments decide nothing.
+DecomposedSoundness verifyFragments(const NetView &net, const ProcessStructureTree &tree, size_t threads = FRAGMENT_THREADS,
+                                    size_t maxStates = FRAGMENT_STATE_LIMIT);
+
+#endif //PETRINETS_PROCESSSTRUCTURE_H
@@ -0,0 +1,105 @@
+#ifndef PETRINETS_REACHABILITYDUMP_H
+#define PETRINETS_REACHABILITYDUMP_H
+
+#include "BinaryNet.h"
+#include "MappedFile.h"
+#include "StateSpace.h"
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @brief Magic bytes at the start of a reachability graph dump.
+const char REACHABILITY_DUMP_MAGIC[8] = {'P', 'N', 'R', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t REACHABILITY_DUMP_VERSION = 1;
+
+/// @brief Sections of a reachability graph dump, in file order.
+enum class ReachabilitySection : uint32_t
+{
+    Edges,        // StateEdge records grouped by source state, streamed during exploration
+    Markings,     // stateCount * placeCount token counts of tokenBytes each
+    EdgeOffsets,  // stateCount + 1 uint64 offsets into Edges, state s owns Edges[offsets[s] .. offsets[s + 1])
+    InitialBits,  // One bit per state, packed into uint64 words
+    FinalBits,
+    DeadlockBits,
+    Count
+};
+
+/// @brief Outgoing edge of a state in a reachability graph dump.
+struct StateEdge
+{
+    StateId target;
+    TransitionId transition;
+};
+
+/// @brief Fixed-size header of a reachability graph dump, sections are 8 byte aligned.
+struct ReachabilityDumpHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t placeCount;
+    uint32_t tokenBytes;
+    uint64_t stateCount;
+    uint64_t edgeCount;
+    uint32_t flags; // Bit 0: the exploration finished without hitting the state limit
+    uint32_t reserved;
+    BinaryNetSectionEntry sections[static_cast<size_t>(ReachabilitySection::Count)];
+};
+
+/// @brief Observer writing the explored graph to a dump file.
+/// Edges go to the file as they are reported; markings are copied from the explorer's store once the
+/// exploration finishes, the offsets and flag bitmaps (a few bits per state) are kept until then.
+class ReachabilityDumpWriter : public StateSpaceObserver
+{
+public:
+    ReachabilityDumpWriter(const std::string &path, const MarkingStore &markings);
+
+    void onEdge(StateId from, TransitionId transition, StateId to) override;
+    void onExpanded(StateId state, std::span<const int32_t> marking, uint8_t flags) override;
+    void onFinish(const StateSpaceResult &result) override;
+
+private:
+    void pad();
+
+    std::vector<char> buffer;
+    std::ofstream file;
+    std::string path;
+    const MarkingStore &markings;
+    uint64_t edgeCount = 0;
+    std::vector<uint64_t> offsets = {0};
+    std::vector<uint64_t> initialBits;
+    std::vector<uint64_t> finalBits;
+    std::vector<uint64_t> deadlockBits;
+};
+
+/// @brief A reachability graph dump mapped into memory, opening checks the header and section bounds.
+class MappedReachabilityGraph
+{
+public:
+    explicit MappedReachabilityGraph(const std::string &path);
+
+    [[nodiscard]] size_t stateCount() const;
+    [[nodiscard]] size_t edgeCount() const;
+    [[nodiscard]] size_t placeCount() const;
+    [[nodiscard]] bool complete() const;
+    [[nodiscard]] std::span<const int32_t> marking(StateId state) const;
+    [[nodiscard]] std::span<const StateEdge> edges(StateId state) const;
+    [[nodiscard]] uint8_t flags(StateId state) const;
+
+private:
+    MappedFile file;
+    ReachabilityDumpHeader header;
+    std::span<const int32_t> markings;
+    std::span<const uint64_t> offsets;
+    std::span<const StateEdge> edgeRecords;
+    std::span<const uint64_t> initialBits;
+    std::span<const uint64_t> finalBits;
+    std::span<const uint64_t> deadlockBits;
+};
+
+StateSpaceResult dumpReachabilityGraph(const NetView &net, const std::string &path, size_t maxStates = 0);
+
+#endif //PETRINETS_REACHABILITYDUMP_H
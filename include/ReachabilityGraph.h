@@ -0,0 +1,79 @@
+#ifndef PETRINETS_REACHABILITYGRAPH_H
+#define PETRINETS_REACHABILITYGRAPH_H
+
+#include "Bisimulation.h"
+#include "NetView.h"
+#include "StateSpace.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Strongly connected components of a graph.
+struct StronglyConnectedComponents
+{
+    std::vector<uint32_t> componentOf; // Component of every node, edges never lead to a component with a higher number
+    std::vector<bool> bottom;          // Components no edge leaves, indexed by component
+    size_t count = 0;
+};
+
+/// @brief Tarjan's algorithm (without recursion) over a compressed sparse row graph.
+/// Components are numbered in the order they close, so a component comes after every component it reaches.
+StronglyConnectedComponents stronglyConnectedComponents(const CsrView &graph);
+
+/// @brief Reachability graph of a net, explored once and kept in memory for queries.
+/// States are the markings in breadth-first discovery order (0 is the initial marking), the edges are stored as
+/// forward and backward compressed rows whose weights hold the transition fired along each edge.
+class ReachabilityGraph
+{
+public:
+    /// @brief Explores the reachability graph of a net.
+    /// @param net Net to explore, its current tokens are the initial marking.
+    /// @param finalMarking Marking flagged as STATE_FINAL, empty for none.
+    /// @param maxStates Stop discovering new states after this many, 0 for no limit.
+    explicit ReachabilityGraph(const NetView &net, std::vector<int32_t> finalMarking = {}, size_t maxStates = 0);
+
+    [[nodiscard]] size_t stateCount() const;
+    [[nodiscard]] size_t edgeCount() const;
+
+    /// @return (bool) False if the state limit cut the exploration short.
+    [[nodiscard]] bool complete() const;
+
+    [[nodiscard]] std::span<const int32_t> marking(StateId state) const;
+
+    /// @return (uint8_t) StateFlag bits of the state.
+    [[nodiscard]] uint8_t flags(StateId state) const;
+
+    [[nodiscard]] std::span<const uint32_t> successors(StateId state) const;
+    /// @brief Transitions leading to successors(state), in the same order.
+    [[nodiscard]] std::span<const uint32_t> successorTransitions(StateId state) const;
+    [[nodiscard]] std::span<const uint32_t> predecessors(StateId state) const;
+    /// @brief Transitions leading from predecessors(state), in the same order.
+    [[nodiscard]] std::span<const uint32_t> predecessorTransitions(StateId state) const;
+
+    [[nodiscard]] const CsrIndex &forward() const;
+    [[nodiscard]] const CsrIndex &backward() const;
+
+    /// @brief Every edge, sorted by source state, e.g. for drawingQuotient.
+    [[nodiscard]] std::vector<LabeledEdge> labeledEdges() const;
+
+    /// @return (std::vector) States carrying all of the given StateFlag bits, in id order.
+    [[nodiscard]] std::vector<StateId> statesWith(uint8_t flag) const;
+
+    /// @return (std::vector) Which states some source reaches (sources included).
+    [[nodiscard]] std::vector<bool> reachableFrom(std::span<const StateId> sources) const;
+
+    /// @return (std::vector) Which states reach some target (targets included).
+    [[nodiscard]] std::vector<bool> canReach(std::span<const StateId> targets) const;
+
+    [[nodiscard]] StronglyConnectedComponents components() const;
+
+private:
+    MarkingStore store;
+    std::vector<uint8_t> stateFlags;
+    CsrIndex outgoing;
+    CsrIndex incoming;
+    bool finished = true;
+};
+
+#endif //PETRINETS_REACHABILITYGRAPH_H
@@ -0,0 +1,162 @@
+#ifndef PETRINETS_RENDERER_H
+#define PETRINETS_RENDERER_H
+
+#include "Constants.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Colours of the drawings: Xiketic for nodes, inputs and text, Blue Jeans for outputs and highlights.
+enum class DrawingColor
+{
+    Dark,
+    Blue
+};
+
+enum class NodeShape
+{
+    Circle, // Place, the label goes inside or above it if it holds tokens
+    Box,    // Transition, the label goes inside and the caption below
+    Text    // Label only, e.g. a state of the reachability graph
+};
+
+/// @brief Laid out node of a drawing.
+struct DrawingNode
+{
+    std::string id; // Identifier in DOT and JSON output, e.g. p0, t3 or s12
+    NodeShape shape = NodeShape::Circle;
+    double x = 0;
+    double y = 0;
+    std::string label;
+    std::string caption;
+    int tokens = 0; // Circles holding tokens get a dot
+};
+
+/// @brief Laid out edge of a drawing, end points are on the outlines of the nodes.
+struct DrawingEdge
+{
+    uint32_t from = 0;
+    uint32_t to = 0;
+    DrawingColor color = DrawingColor::Dark;
+    double x1 = 0;
+    double y1 = 0;
+    double x2 = 0;
+    double y2 = 0;
+    bool curved = false; // Quadratic curve through the control point instead of a straight line
+    double controlX = 0;
+    double controlY = 0;
+    std::string label;
+    double labelX = 0;
+    double labelY = 0;
+    DrawingColor labelColor = DrawingColor::Dark;
+};
+
+/// @brief Step of an animated drawing.
+struct DrawingFrame
+{
+    std::string caption;
+    std::vector<uint32_t> marked;      // Circles holding tokens in this frame
+    uint32_t highlighted = UINT32_MAX; // Node outlined in this frame, if any
+};
+
+/// @brief Format-independent result of laying out a net or a reachability graph, what the renderers draw.
+struct Drawing
+{
+    double width = 0;
+    double height = 0;
+    std::vector<DrawingNode> nodes;
+    std::vector<DrawingEdge> edges;
+    std::vector<DrawingFrame> frames; // Empty for a still drawing, otherwise the tokens come from the frames
+    double frameSeconds = WITNESS_STEP_SECONDS;
+};
+
+/// @brief Output format of drawings.
+class Renderer
+{
+public:
+    virtual ~Renderer() = default;
+
+    virtual void render(const Drawing &drawing, std::ostream &out) const = 0;
+};
+
+/// @brief SVG with the frames as SMIL animations.
+class SvgRenderer : public Renderer
+{
+public:
+    void render(const Drawing &drawing, std::ostream &out) const override;
+};
+
+/// @brief Graphviz DOT with pinned positions (for neato -n), frames are left out.
+class DotRenderer : public Renderer
+{
+public:
+    void render(const Drawing &drawing, std::ostream &out) const override;
+};
+
+/// @brief JSON with every node, edge and frame of the drawing.
+class JsonRenderer : public Renderer
+{
+public:
+    void render(const Drawing &drawing, std::ostream &out) const override;
+};
+
+/// @brief Picks the renderer from the extension of an output path: .svg, .dot or .json.
+/// @throws std::invalid_argument for other extensions.
+std::unique_ptr<Renderer> rendererFor(const std::string &path);
+
+/// @brief Output file writing through a large buffer, so the many small pieces of a drawing reach the disk in big blocks.
+class BufferedFile
+{
+public:
+    explicit BufferedFile(const std::string &path);
+
+    std::ostream &stream();
+
+    /// @brief Flushes and closes the file.
+    /// @throws std::runtime_error if anything couldn't be written.
+    void close();
+
+private:
+    std::vector<char> buffer;
+    std::ofstream file;
+    std::string path;
+};
+
+/// @brief Renders a drawing into a file, the format is picked from the extension.
+void renderToFile(const Drawing &drawing, const std::string &path);
+
+/// @brief Renders drawings to files on background threads, so the caller doesn't wait for the disk.
+class RenderQueue
+{
+public:
+    explicit RenderQueue(size_t threads = RENDER_THREADS);
+
+    /// @throws std::invalid_argument right away if no renderer handles the extension of path.
+    void submit(Drawing drawing, const std::string &path);
+
+    /// @brief Waits for the submitted drawings to be written.
+    /// @throws The first error a job ran into since the last wait.
+    void wait();
+
+private:
+    std::mutex mutex;
+    std::exception_ptr failure;
+    // Declared last so it's destroyed first: ~ThreadPool finishes the pending jobs, which still lock mutex
+    ThreadPool pool;
+};
+
+/// @brief Queue the SVG writers submit their drawings to, wait on it before the program exits.
+RenderQueue &renderQueue();
+
+std::string jsonEscape(std::string_view text);
+void writeDotQuoted(std::ostream &out, std::string_view text);
+
+#endif //PETRINETS_RENDERER_H
@@ -0,0 +1,50 @@
+#ifndef PETRINETS_SCOMPONENTS_H
+#define PETRINETS_SCOMPONENTS_H
+
+#include "Constants.h"
+#include "Invariants.h"
+#include "NetView.h"
+#include "Petrinet.h"
+
+#include <cstdint>
+#include <vector>
+
+/// @brief Strongly connected state-machine subnet: a set of places together with all their producers and consumers,
+/// every one of which takes one token from the set and puts one back (arc weights 1). The tokens in the set never
+/// change in number, so none of its places ever holds more than the set holds initially.
+struct SComponent
+{
+    std::vector<PlaceId> places; // Increasing
+    TransitionIds transitions;   // Increasing
+    int64_t tokens = 0;          // Tokens in the places initially, and in every reachable marking
+};
+
+/// @brief Result of sComponentCover.
+struct SComponentCover
+{
+    std::vector<SComponent> components;
+    std::vector<PlaceId> uncovered; // Places no S-component holds, or that the search gave up on
+    bool complete = true;           // False if SCOMPONENT_SEARCH_LIMIT stopped a search, uncovered may be covered then
+
+    /// @return (bool) Every place is in a component, the net is bounded from any marking.
+    [[nodiscard]] bool covers() const
+    {
+        return uncovered.empty();
+    }
+};
+
+/// @brief Covers the places of a net with S-components, read from its arc list. For every place not covered yet, one
+/// component holding it is searched for: adding a place adds its transitions, and a transition short of an input or
+/// an output place in the set adds one, forced if there is only one left and split into one branch per candidate
+/// otherwise. A second input or output in the set is a conflict, a closed set has to be strongly connected.
+/// Live and bounded free-choice nets are always covered (Hack), and whatever is covered is bounded.
+/// @param net Net to cover, it doesn't have to be finalized.
+/// @param maxSubproblems Branches one search may explore before giving up on its place.
+SComponentCover sComponentCover(const PetriNet &net, size_t maxSubproblems = SCOMPONENT_SEARCH_LIMIT);
+
+/// @brief Token bounds the components give every place: the fewest tokens of any component holding it.
+/// @param net Net the cover belongs to, its current tokens are the initial marking.
+/// @param cover Result of sComponentCover for the net.
+PlaceBounds placeBounds(const NetView &net, const SComponentCover &cover);
+
+#endif //PETRINETS_SCOMPONENTS_H
@@ -0,0 +1,55 @@
+#ifndef PETRINETS_SIPHONS_H
+#define PETRINETS_SIPHONS_H
+
+#include "Constants.h"
+#include "NetView.h"
+
+#include <vector>
+
+/// @brief Minimal siphons or traps of a net, as increasing place ids.
+/// A siphon is a set of places every producer of which also consumes from it: once empty it stays empty.
+/// A trap is a set of places every consumer of which also produces into it: once marked it stays marked.
+struct MinimalPlaceSets
+{
+    std::vector<std::vector<PlaceId>> sets;
+    bool complete = true; // False if SIPHON_SEARCH_LIMIT stopped the enumeration, sets holds the ones found so far
+};
+
+/// @brief Largest siphon inside a set of places, by removing places with a producer that takes nothing from the
+/// rest until none is left. Every arc is looked at once, O(V+E).
+/// @param within Places allowed in the siphon, one flag per place.
+/// @return (std::vector) Membership flag of every place, all false if there is no siphon inside.
+std::vector<bool> maximalSiphon(const NetView &net, std::vector<bool> within);
+
+/// @brief Largest trap inside a set of places, see maximalSiphon.
+std::vector<bool> maximalTrap(const NetView &net, std::vector<bool> within);
+
+/// @brief Enumerates the minimal siphons by splitting the search space: the subproblem (allowed places, required
+/// places) finds one siphon minimal among those holding the required places by shrinking the maximal siphon a place
+/// at a time, then splits into one subproblem per other place of it (the first excluded, the earlier ones required).
+/// The subproblems share no siphon, so every minimal siphon is found exactly once.
+/// @param maxSubproblems Give up after this many subproblems.
+MinimalPlaceSets minimalSiphons(const NetView &net, size_t maxSubproblems = SIPHON_SEARCH_LIMIT);
+
+/// @brief Minimal traps, see minimalSiphons.
+MinimalPlaceSets minimalTraps(const NetView &net, size_t maxSubproblems = SIPHON_SEARCH_LIMIT);
+
+/// @brief Result of checkCommonerProperty.
+struct CommonerReport
+{
+    bool holds = false;
+    bool complete = true;                // False if the siphon enumeration was cut short, holds is false then
+    std::vector<PlaceId> unmarkedSiphon; // A minimal siphon without an initially marked trap, empty if none was found
+};
+
+/// @brief Commoner's property: every siphon holds an initially marked trap. It suffices to look at the maximal trap
+/// of every minimal siphon. An ordinary net with the property has no dead marking (the unmarked places of one would
+/// form a siphon whose trap lost its tokens), and a free-choice net with it is live.
+/// @param net Net to check, its current tokens are the initial marking.
+CommonerReport checkCommonerProperty(const NetView &net, size_t maxSubproblems = SIPHON_SEARCH_LIMIT);
+
+/// @brief Whether transitions sharing an input place share all of them (extended free choice), so a choice between
+/// transitions never depends on tokens elsewhere.
+bool isFreeChoice(const NetView &net);
+
+#endif //PETRINETS_SIPHONS_H
@@ -0,0 +1,120 @@
+#ifndef PETRINETS_STATESPACE_H
+#define PETRINETS_STATESPACE_H
+
+#include "NetView.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// @brief Flags describing a reachable state.
+enum StateFlag : uint8_t
+{
+    STATE_INITIAL = 1,
+    STATE_FINAL = 2,    // The marking equals the final marking passed to the explorer
+    STATE_DEADLOCK = 4, // No transition is enabled and the marking isn't final
+    STATE_TRUNCATED = 8, // The state limit left some successors out
+};
+
+/// @brief Deduplicating arena of markings.
+/// Markings are stored back to back with a fixed stride (one token count per place) and indexed by an
+/// open-addressing table over state ids, so a state costs its tokens plus a few bytes of index.
+class MarkingStore
+{
+public:
+    explicit MarkingStore(size_t placeCount);
+
+    /// @brief Adds a marking unless an equal one is already stored.
+    /// @return (std::pair) Id of the marking and whether it was inserted.
+    std::pair<StateId, bool> insert(std::span<const int32_t> marking);
+
+    /// @return (StateId) Id of the marking, INVALID_ID if it isn't stored.
+    [[nodiscard]] StateId find(std::span<const int32_t> marking) const;
+
+    [[nodiscard]] std::span<const int32_t> operator[](StateId state) const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] size_t placeCount() const;
+
+    /// @brief All markings back to back, state s spans [s * placeCount(), (s + 1) * placeCount()).
+    [[nodiscard]] std::span<const int32_t> tokens() const;
+
+private:
+    void rehash(size_t capacity);
+
+    size_t stride;
+    std::vector<int32_t> arena;
+    std::vector<uint32_t> hashes;
+    std::vector<StateId> slots;
+};
+
+/// @brief Result of a state-space exploration.
+struct StateSpaceResult
+{
+    size_t states = 0;
+    size_t edges = 0;
+    bool complete = true; // False if the state limit was reached
+};
+
+/// @brief Receives the reachability graph while it is being explored.
+/// States are expanded in id (breadth-first) order and the edges leaving a state are reported back to back
+/// right before its onExpanded call, so observers can write edge lists as compressed rows without buffering.
+/// A state's onState always comes before the first edge that mentions it.
+class StateSpaceObserver
+{
+public:
+    virtual ~StateSpaceObserver() = default;
+
+    /// @brief A new state was discovered, called once per state in id order.
+    virtual void onState(StateId /*state*/, std::span<const int32_t> /*marking*/, uint8_t /*flags*/)
+    {
+    }
+
+    /// @brief Firing transition in state from leads to state to.
+    virtual void onEdge(StateId /*from*/, TransitionId /*transition*/, StateId /*to*/)
+    {
+    }
+
+    /// @brief All edges of the state were reported, flags now include STATE_DEADLOCK if applicable.
+    virtual void onExpanded(StateId /*state*/, std::span<const int32_t> /*marking*/, uint8_t /*flags*/)
+    {
+    }
+
+    /// @brief The exploration ended, every discovered state has been expanded.
+    /// With a state limit, edges into states that would have exceeded it are left out.
+    virtual void onFinish(const StateSpaceResult & /*result*/)
+    {
+    }
+};
+
+/// @brief Breadth-first explorer of the reachability graph of a net.
+class StateSpaceExplorer
+{
+public:
+    /// @param net Net to explore, its current tokens are the initial marking.
+    /// @param finalMarking Marking flagged as STATE_FINAL, empty for none.
+    explicit StateSpaceExplorer(const NetView &net, std::vector<int32_t> finalMarking = {});
+
+    /// @brief Explores the reachable markings, reporting them to the observer.
+    /// @param observer Receives states and edges as they are found.
+    /// @param maxStates Stop discovering new states after this many, 0 for no limit.
+    StateSpaceResult explore(StateSpaceObserver &observer, size_t maxStates = 0);
+
+    [[nodiscard]] const MarkingStore &markings() const;
+
+    /// @brief Hands the markings of the last exploration over, leaving the explorer without any.
+    MarkingStore releaseMarkings();
+
+private:
+    NetView net;
+    std::vector<int32_t> finalMarking;
+    MarkingStore store;
+};
+
+/// @brief The final marking of a workflow net: as many tokens in o as i initially holds, nothing elsewhere. i and o are
+/// the only places without producers and without consumers (findWorkflowPlaces).
+/// @return (std::vector) The marking, empty unless both places are unique.
+std::vector<int32_t> workflowFinalMarking(const NetView &net);
+
+#endif //PETRINETS_STATESPACE_H
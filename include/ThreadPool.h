@@ -0,0 +1,41 @@
+#ifndef PETRINETS_THREADPOOL_H
+#define PETRINETS_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// @brief Fixed-size pool of worker threads executing queued jobs in FIFO order.
+class ThreadPool
+{
+public:
+    /// @param threads Number of workers, 0 uses the hardware concurrency.
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(std::function<void()> job);
+
+    void wait();
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    void work();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobsDone;
+    size_t running = 0;
+    bool stopping = false;
+};
+
+#endif //PETRINETS_THREADPOOL_H
@@ -1,10 +1,11 @@
 #ifndef PETRINETS_TYPES_H
 #define PETRINETS_TYPES_H
 
-#include <string>
+#include "FlatHash.h"
+
+#include <cstdint>
+#include <span>
 #include <vector>
-#include <map>
-#include <unordered_set>
 #include <functional>
 
 struct Node
@@ -25,19 +26,27 @@ struct Node
     }
 };
 
+/// @brief Dense id of an interned name, see NameTable.
+typedef uint32_t NameId;
+/// @brief Dense index of a place in PetriNet::getPlaces().
+typedef uint32_t PlaceId;
+/// @brief Dense index of a transition in PetriNet::getTransitions().
+typedef uint32_t TransitionId;
+
+/// @brief Dense index of a reachable marking in a MarkingStore, in discovery order.
+typedef uint32_t StateId;
+
+/// @brief Sentinel for a missing name, place, transition or state.
+const uint32_t INVALID_ID = UINT32_MAX;
+
 /// @brief Petri net place.
 struct Place
 {
-    std::string name;
-    int tokens;
-    Place()
+    NameId name = INVALID_ID;
+    int tokens = 0;
+    Place() = default;
+    Place(NameId name, int tokens) : name(name), tokens(tokens)
     {
-        tokens = 0;
-    }
-    Place(std::string name, int tokens)
-    {
-        this->name = std::move(name);
-        this->tokens = tokens;
     }
     bool operator==(const Place &other) const
     {
@@ -48,11 +57,10 @@ struct Place
 /// @brief Petri net transition.
 struct Transition
 {
-    std::string name;
+    NameId name = INVALID_ID;
     Transition() = default;
-    explicit Transition(std::string name)
+    explicit Transition(NameId name) : name(name)
     {
-        this->name = std::move(name);
     }
     bool operator==(const Transition &other) const
     {
@@ -60,21 +68,12 @@ struct Transition
     }
 };
 
-/// @brief Hash function for Petri net transitions.
-struct TransitionHash
-{
-    size_t operator()(const Transition &transition) const
-    {
-        return std::hash<std::string>()(transition.name);
-    }
-};
-
 /// @brief Hash function for Petri net places.
 struct PlaceHash
 {
     size_t operator()(const Place &place) const
     {
-        return std::hash<std::string>()(place.name);
+        return std::hash<NameId>()(place.name);
     }
 };
 /// @brief Hash function for a vector of places
@@ -85,7 +84,7 @@ struct PlacesHash
         std::size_t seed = 0;
         for (const auto &place : places)
         {
-            seed ^= place.tokens *PlaceHash{}(place) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= (place.tokens * 0x9e3779b97f4a7c15ULL + place.name) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
         }
         return seed;
     }
@@ -99,18 +98,63 @@ enum class ArcDirection
 /// @brief Petri net arc.
 struct Edge
 {
-    int from;
-    int to;
+    uint32_t from;
+    uint32_t to;
     ArcDirection direction;
+    uint32_t weight = 1; // Number of tokens moved along the arc, not part of the arc's identity
+    bool operator==(const Edge &other) const
+    {
+        return from == other.from && to == other.to && direction == other.direction;
+    }
+};
+
+/// @brief Hash function for Petri net arcs.
+struct EdgeHash
+{
+    size_t operator()(const Edge &edge) const
+    {
+        uint64_t key = (static_cast<uint64_t>(edge.from) << 32) | edge.to;
+        return static_cast<size_t>(mixHash(key ^ static_cast<uint64_t>(edge.direction) * 0x9e3779b97f4a7c15ULL));
+    }
+};
+
+/// @brief Compressed sparse row adjacency, row r spans targets[offsets[r] .. offsets[r + 1]).
+/// weights runs parallel to targets.
+struct CsrIndex
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> weights;
+
+    [[nodiscard]] std::span<const uint32_t> operator[](uint32_t row) const
+    {
+        return {targets.data() + offsets[row], targets.data() + offsets[row + 1]};
+    }
+    [[nodiscard]] std::span<const uint32_t> weightsOf(uint32_t row) const
+    {
+        return {weights.data() + offsets[row], weights.data() + offsets[row + 1]};
+    }
+    [[nodiscard]] size_t rows() const
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+};
+
+/// @brief Positions of the places and transitions of a net, indexed like PetriNet::getPlaces()/getTransitions().
+struct NetLayout
+{
+    std::vector<Node> places;
+    std::vector<Node> transitions;
 };
 
 typedef std::vector<Place> Places;
 typedef std::vector<Transition> Transitions;
-typedef std::map<std::string, int> PlaceMap;
-typedef std::map<std::string, int> TransitionMap;
+typedef std::vector<TransitionId> TransitionIds;
+typedef FlatHashMap<NameId, PlaceId> PlaceMap;
+typedef FlatHashMap<NameId, TransitionId> TransitionMap;
 typedef std::vector<Edge> Arcs;
-typedef std::map<std::string, Transition> ReverseTransitionMap;
-typedef std::unordered_set<Transition, TransitionHash> TransitionSet;
-typedef std::unordered_set<Place, PlaceHash> PlaceSet;
+typedef FlatHashSet<Edge, EdgeHash> ArcSet;
+typedef FlatHashSet<TransitionId> TransitionSet;
+typedef FlatHashSet<PlaceId> PlaceSet;
 
 #endif //PETRINETS_TYPES_H
@@ -1,22 +1,53 @@
 #ifndef PETRINETS_UTILITY_H
 #define PETRINETS_UTILITY_H
 
+#include "./Bisimulation.h"
+#include "./Constants.h"
+#include "./Layout.h"
 #include "./Petrinet.h"
+#include "./WorkflowStructure.h"
+
+#include <string>
+#include <unordered_set>
+
+/// @brief Outcome of a soundness check, see verifySoundness.
+struct SoundnessReport
+{
+    bool workflowNet = false;
+    bool sound = false;
+    bool finalReachable = false;
+    bool coveredByInvariants = false;    // Every place is in the support of a place invariant, so the net is bounded. Only checked
+                                         // when proven structurally or when the state limit cut the exploration short
+    bool finalExcluded = false;          // A place invariant rules the final marking out, only checked with an incomplete exploration
+    bool provenStructurally = false;     // Soundness followed from siphons, traps and invariants, no state was explored
+    bool complete = true;                // False if DEFAULT_STATE_LIMIT cut the exploration short, the net is then reported unsound
+    TransitionIds deadTransitions;       // Transitions no reachable state enables, empty unless the exploration is complete
+    std::vector<PlaceId> deadlockPlaces; // Marked places of the states without enabled transitions
+    std::vector<std::vector<PlaceId>> livelocks; // Marked places of every reachable cycle that can't reach the final state
+    TransitionIds witness;               // Firing sequence reaching the final state
+    std::vector<WorkflowIssue> structureIssues; // Why the net isn't a workflow net, see validateWorkflowNet
+    size_t states = 0;                   // Number of reachable states, 0 if proven structurally, summed over the fragments if decomposed
+    size_t fragments = 0;                // Fragments verified one by one (see verifyFragments), 0 if the net was explored as a whole
+};
 
 std::string convertToOrdinal(int num);
 Places getEnabledPlaces(const PetriNet &net);
-Transitions getEnabledTransitions(const PetriNet &net);
-void fireTransition(PetriNet &net, const Transition &transition);
-void unFireTransition(PetriNet &net, const Transition &transition);
-bool isFinalState(const PetriNet &net, int target);
-void writePetriNetToSVG(const PetriNet &net, const std::string &filename);
+TransitionIds getEnabledTransitions(const PetriNet &net);
+void fireTransition(PetriNet &net, TransitionId transition);
+void unFireTransition(PetriNet &net, TransitionId transition);
+void writePetriNetToSVG(const PetriNet &net, const std::string &filename, const LayoutOptions &options = {});
 bool isWorkflowNet(const PetriNet &net);
-bool getFinalSpace(PetriNet net, std::vector<std::pair<Places, Transitions>> &states, std::unordered_set<Places, PlacesHash> &statesSet, int initialTokens, Transitions firedTransitions, int depth);
-bool allTransitionsEnabled(PetriNet net, TransitionSet &possibleTransitions, int initialTokens, int depth);
+bool provenSound(const NetView &net, const WorkflowStructure &structure);
+SoundnessReport verifySoundness(const NetView &net, size_t fragmentThreads = FRAGMENT_THREADS);
+SoundnessReport verifySoundness(const PetriNet &net, size_t fragmentThreads = FRAGMENT_THREADS);
+void writeWitnessToSVG(const PetriNet &net, const TransitionIds &witness);
+void writeAnimatedWitnessToSVG(const PetriNet &net, const TransitionIds &witness, const std::string &filename, const LayoutOptions &options = {});
 bool isSound(const PetriNet &net);
-std::string markingToString(const Places &places);
-void drawReachabilityGraphToSVG(const PetriNet &net, const std::string &filename);
+std::string markingToString(const PetriNet &net, const Places &places);
+std::string markingToString(const NetView &net, std::span<const int32_t> marking);
+void drawReachabilityGraphToSVG(const PetriNet &net, const std::string &filename, const LayoutOptions &options = {},
+                                const BisimulationOptions &reduction = {Equivalence::Strong, {}});
 
-extern Transitions latestFiredTransitions;
+extern TransitionIds latestFiredTransitions;
 
 #endif //PETRINETS_UTILITY_H
@@ -0,0 +1,77 @@
+#ifndef PETRINETS_WORKFLOWSTRUCTURE_H
+#define PETRINETS_WORKFLOWSTRUCTURE_H
+
+#include "NetView.h"
+#include "Petrinet.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Reason a net isn't a workflow net.
+enum class WorkflowDefect : uint8_t
+{
+    MissingInput,      // Every place has producers, so there is no input place
+    MissingOutput,     // Every place has consumers, so there is no output place
+    SeveralInputs,     // The place has no producers, but neither does another one
+    SeveralOutputs,    // The place has no consumers, but neither does another one
+    UnmarkedInput,     // The input place holds no token initially
+    MarkedPlace,       // A place other than the input place holds tokens initially
+    Unreachable,       // The node isn't on any path from the input place
+    CannotReachOutput, // No path leads from the node to the output place
+};
+
+/// @brief One defect, with the place or transition it is about.
+struct WorkflowIssue
+{
+    WorkflowDefect defect;
+    uint32_t node = INVALID_ID; // Place or transition id, INVALID_ID for a missing place
+    bool transition = false;    // node is a transition id
+};
+
+/// @brief Places a workflow net starts and ends in, told apart by structure alone: the input place is the one place
+/// without producers and the output place the one without consumers, whatever their names.
+struct WorkflowPlaces
+{
+    std::vector<PlaceId> sources; // Places without producers, in id order
+    std::vector<PlaceId> sinks;   // Places without consumers, in id order
+    PlaceId input = INVALID_ID;   // The only source, INVALID_ID unless there is exactly one
+    PlaceId output = INVALID_ID;  // The only sink, INVALID_ID unless there is exactly one
+};
+
+/// @brief Finds the input and output places of a workflow net in O(V).
+WorkflowPlaces findWorkflowPlaces(const NetView &net);
+
+/// @brief Result of validateWorkflowNet.
+struct WorkflowStructure
+{
+    PlaceId input = INVALID_ID;
+    PlaceId output = INVALID_ID;
+    bool stronglyConnected = false; // The net with a transition from o back to i added is strongly connected
+    std::vector<WorkflowIssue> issues;
+
+    [[nodiscard]] bool valid() const
+    {
+        return issues.empty();
+    }
+};
+
+/// @brief Checks the structure of a workflow net in O(V+E): one source place i without producers, one sink place o
+/// without consumers (see findWorkflowPlaces), i the only marked place, and every node on a path from i to o. The last part is one search
+/// forward from i and one backward from o, together they decide whether the short-circuited net (o connected back
+/// to i by an extra transition) is strongly connected, without building it.
+/// @param net Net to check, its current tokens are the initial marking.
+/// @return (WorkflowStructure) Every defect found, in the order above and by node id within one kind.
+WorkflowStructure validateWorkflowNet(const NetView &net);
+
+/// @brief Copy of a workflow net with one more transition, taking a token from o and putting it back into i. A workflow
+/// net is sound exactly if this net is live and bounded.
+/// @param net View of the net, e.g. of a mapped binary net.
+/// @param input The place i.
+/// @param output The place o.
+PetriNet shortCircuitNet(const NetView &net, PlaceId input, PlaceId output);
+
+/// @brief One line describing a defect, e.g. "Transition t3 can't reach the output place".
+std::string describeWorkflowIssue(const NetView &net, const WorkflowIssue &issue);
+
+#endif //PETRINETS_WORKFLOWSTRUCTURE_H
@@ -0,0 +1,81 @@
+#ifndef PETRINETS_XMLREADER_H
+#define PETRINETS_XMLREADER_H
+
+#include <array>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief Streaming (pull style SAX) XML reader.
+/// Only the current event is held in memory; the input is consumed in fixed-size chunks.
+/// Supports elements, attributes, character data, CDATA, comments, processing instructions
+/// and the predefined/numeric entities. DTDs are skipped.
+class XmlReader
+{
+public:
+    enum class Event
+    {
+        StartElement,
+        EndElement,
+        Text,
+        EndOfDocument
+    };
+
+    explicit XmlReader(std::istream &input, std::string source = "<xml>");
+
+    /// @brief Advances to the next event.
+    Event next();
+
+    /// @brief Local name (namespace prefix stripped) of the current start/end element.
+    [[nodiscard]] const std::string &name() const;
+
+    /// @brief Value of an attribute of the current start element.
+    /// @return (std::string_view) The value, empty if the attribute is missing.
+    [[nodiscard]] std::string_view attribute(std::string_view name) const;
+
+    [[nodiscard]] bool hasAttribute(std::string_view name) const;
+
+    /// @brief Character data of the current text event, entities decoded.
+    [[nodiscard]] const std::string &text() const;
+
+    [[nodiscard]] size_t line() const;
+
+    /// @brief Throws a std::runtime_error mentioning the current line.
+    [[noreturn]] void fail(const std::string &message) const;
+
+private:
+    int peek();
+    int get();
+    bool refill();
+    void expect(std::string_view literal);
+    void skipUntil(std::string_view terminator);
+    void skipWhitespace();
+    void appendRun(std::string *out, const std::array<bool, 256> &stop);
+    void readName(std::string &out);
+    void readReference(std::string &out);
+    void readStartElement();
+
+    std::istream &input;
+    std::string source;
+    std::vector<char> buffer;
+    size_t position = 0;
+    size_t available = 0;
+    size_t currentLine = 1;
+
+    std::string elementName;
+    std::string characters;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    size_t attributeCount = 0;
+    bool pendingEnd = false;
+    // Qualified names of the open elements, the first depth entries are in use
+    std::vector<std::string> openElements;
+    int depth = 0;
+};
+
+void writeXmlEscaped(std::ostream &out, std::string_view text);
+
+#endif //PETRINETS_XMLREADER_H
@@ -0,0 +1,176 @@
+#include "../include/BackwardReachability.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+std::vector<uint32_t> distancesToAny(const NetView &net, const MarkingStore &markings, std::span<const StateId> targets)
+{
+    std::vector<uint32_t> distances(markings.size(), INVALID_ID);
+    std::vector<StateId> queue;
+    for (const StateId target : targets)
+    {
+        if (distances[target] == INVALID_ID)
+        {
+            distances[target] = 0;
+            queue.push_back(target);
+        }
+    }
+    // Transitions without outputs can be unfired anywhere, the others are found through their first output place
+    std::vector<TransitionId> unconditional;
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        if (net.postset(transition).empty())
+        {
+            unconditional.push_back(transition);
+        }
+    }
+    std::vector<int32_t> current(net.placeCount()), previous(net.placeCount());
+    const auto unfire = [&](TransitionId transition, uint32_t distance)
+    {
+        const auto outputs = net.postset(transition);
+        const auto outputWeights = net.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            if (current[outputs[i]] < static_cast<int32_t>(outputWeights[i]))
+            {
+                return;
+            }
+        }
+        previous = current;
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            previous[outputs[i]] -= static_cast<int32_t>(outputWeights[i]);
+        }
+        const auto inputs = net.preset(transition);
+        const auto inputWeights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            previous[inputs[i]] += static_cast<int32_t>(inputWeights[i]);
+        }
+        // Predecessors outside the set aren't reachable, which keeps the backward search finite
+        const StateId predecessor = markings.find(previous);
+        if (predecessor != INVALID_ID && distances[predecessor] == INVALID_ID)
+        {
+            distances[predecessor] = distance;
+            queue.push_back(predecessor);
+        }
+    };
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        const StateId state = queue[head];
+        const auto marking = markings[state];
+        std::copy(marking.begin(), marking.end(), current.begin());
+        const uint32_t distance = distances[state] + 1;
+        for (PlaceId place = 0; place < net.placeCount(); place++)
+        {
+            if (current[place] == 0)
+            {
+                continue;
+            }
+            for (const TransitionId transition : net.placePreset(place))
+            {
+                if (net.postset(transition).front() == place)
+                {
+                    unfire(transition, distance);
+                }
+            }
+        }
+        for (const TransitionId transition : unconditional)
+        {
+            unfire(transition, distance);
+        }
+    }
+    return distances;
+}
+
+std::vector<uint32_t> distancesToFinal(const NetView &net, const MarkingStore &markings, std::span<const int32_t> finalMarking)
+{
+    if (finalMarking.empty())
+    {
+        return std::vector<uint32_t>(markings.size(), INVALID_ID);
+    }
+    if (finalMarking.size() != net.placeCount())
+    {
+        throw std::invalid_argument("The final marking must have one entry per place");
+    }
+    const StateId target = markings.find(finalMarking);
+    if (target == INVALID_ID)
+    {
+        return std::vector<uint32_t>(markings.size(), INVALID_ID);
+    }
+    return distancesToAny(net, markings, std::span<const StateId>(&target, 1));
+}
+
+CompletionReport checkOptionToComplete(const NetView &net, std::span<const int32_t> finalMarking, size_t maxStates)
+{
+    // The forward pass only needs the markings, no edges are kept
+    StateSpaceExplorer explorer(net, std::vector<int32_t>(finalMarking.begin(), finalMarking.end()));
+    StateSpaceObserver ignore;
+    const bool complete = explorer.explore(ignore, maxStates).complete;
+    return checkOptionToComplete(net, explorer.releaseMarkings(), finalMarking, complete);
+}
+
+CompletionReport checkOptionToComplete(const NetView &net, MarkingStore markings, std::span<const int32_t> finalMarking, bool complete)
+{
+    CompletionReport report{std::move(markings), {}, {}};
+    report.complete = complete;
+    report.distances = distancesToFinal(net, report.markings, finalMarking);
+    for (StateId state = 0; state < report.markings.size(); state++)
+    {
+        if (report.distances[state] == INVALID_ID)
+        {
+            report.stuck.push_back(state);
+        }
+    }
+    return report;
+}
+
+TransitionIds shortestCompletion(const NetView &net, const CompletionReport &report)
+{
+    TransitionIds sequence;
+    if (!report.finalReachable())
+    {
+        return sequence;
+    }
+    std::vector<int32_t> next(net.placeCount());
+    StateId state = 0;
+    while (report.distances[state] > 0)
+    {
+        // Some enabled transition leads one step closer, take the first one
+        const auto marking = report.markings[state];
+        for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+        {
+            const auto inputs = net.preset(transition);
+            const auto inputWeights = net.presetWeights(transition);
+            bool enabled = true;
+            for (size_t i = 0; i < inputs.size() && enabled; i++)
+            {
+                enabled = marking[inputs[i]] >= static_cast<int32_t>(inputWeights[i]);
+            }
+            if (!enabled)
+            {
+                continue;
+            }
+            std::copy(marking.begin(), marking.end(), next.begin());
+            for (size_t i = 0; i < inputs.size(); i++)
+            {
+                next[inputs[i]] -= static_cast<int32_t>(inputWeights[i]);
+            }
+            const auto outputs = net.postset(transition);
+            const auto outputWeights = net.postsetWeights(transition);
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                next[outputs[i]] += static_cast<int32_t>(outputWeights[i]);
+            }
+            const StateId successor = report.markings.find(next);
+            if (successor != INVALID_ID && report.distances[successor] != INVALID_ID && report.distances[successor] + 1 == report.distances[state])
+            {
+                sequence.push_back(transition);
+                state = successor;
+                break;
+            }
+        }
+    }
+    return sequence;
+}
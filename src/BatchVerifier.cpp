@@ -0,0 +1,235 @@
+#include "../include/BatchVerifier.h"
+#include "../include/Constants.h"
+#include "../include/KSoundness.h"
+#include "../include/NetLoader.h"
+#include "../include/Renderer.h"
+#include "../include/ThreadPool.h"
+#include "../include/Utility.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+
+/// @brief One net file to verify, or a directory that couldn't be listed.
+struct BatchInput
+{
+    std::string path;
+    std::string error; // Why the directory couldn't be listed, empty for a net file
+};
+
+/// @brief Expands directories into the net files they contain (recursively, sorted by path).
+/// A directory that can't be read becomes one input carrying the error, the others are still expanded.
+static std::vector<BatchInput> collectInputs(const std::vector<std::string> &paths)
+{
+    std::vector<BatchInput> inputs;
+    for (const auto &path : paths)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_directory(path, error))
+        {
+            // Missing files are reported when they fail to load
+            inputs.push_back({path, {}});
+            continue;
+        }
+        std::vector<BatchInput> found;
+        std::filesystem::recursive_directory_iterator entry(path, error), end;
+        for (; !error && entry != end; entry.increment(error))
+        {
+            std::error_code statusError; // An entry that vanished meanwhile is skipped
+            if (entry->is_regular_file(statusError) && isNetFile(entry->path().string()))
+            {
+                found.push_back({entry->path().string(), {}});
+            }
+        }
+        std::sort(found.begin(), found.end(), [](const BatchInput &a, const BatchInput &b) { return a.path < b.path; });
+        inputs.insert(inputs.end(), found.begin(), found.end());
+        if (error)
+        {
+            inputs.push_back({path, error.message()});
+        }
+    }
+    return inputs;
+}
+
+/// @brief Loads and verifies one net.
+/// @param path Net file.
+/// @param maxK Also check k-soundness for k = 1..maxK, 0 to skip.
+/// @param fragmentThreads Threads verifying the fragments of the net, see verifySoundness.
+/// @param failed Set to true if the net couldn't be loaded.
+/// @return (String) One JSON object describing the result, without trailing newline.
+static std::string verifyFile(const std::string &path, uint32_t maxK, size_t fragmentThreads, bool &failed)
+{
+    std::ostringstream line;
+    line << "{\"file\":\"" << jsonEscape(path) << "\"";
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        // Binary nets are verified straight from the mapping
+        const LoadedNet loaded(path);
+        const NetView &net = loaded.view();
+        const SoundnessReport report = verifySoundness(net, fragmentThreads);
+        line << std::boolalpha << ",\"workflow\":" << report.workflowNet << ",\"sound\":" << report.sound
+             << ",\"final_reachable\":" << report.finalReachable << ",\"states\":" << report.states
+             << ",\"complete\":" << report.complete
+             << ",\"covered_by_invariants\":" << report.coveredByInvariants << ",\"proven_structurally\":" << report.provenStructurally
+             << ",\"fragments\":" << report.fragments;
+        line << ",\"dead_transitions\":[";
+        for (size_t i = 0; i < report.deadTransitions.size(); i++)
+        {
+            line << (i ? "," : "") << "\"t" << report.deadTransitions[i] + 1 << "\"";
+        }
+        line << "],\"deadlocks\":[";
+        for (size_t i = 0; i < report.deadlockPlaces.size(); i++)
+        {
+            line << (i ? "," : "") << "\"" << jsonEscape(net.placeName(report.deadlockPlaces[i])) << "\"";
+        }
+        line << "],\"livelocks\":[";
+        for (size_t i = 0; i < report.livelocks.size(); i++)
+        {
+            line << (i ? ",[" : "[");
+            for (size_t j = 0; j < report.livelocks[i].size(); j++)
+            {
+                line << (j ? "," : "") << "\"" << jsonEscape(net.placeName(report.livelocks[i][j])) << "\"";
+            }
+            line << "]";
+        }
+        line << "],\"structure_issues\":[";
+        for (size_t i = 0; i < report.structureIssues.size(); i++)
+        {
+            line << (i ? "," : "") << "\"" << jsonEscape(describeWorkflowIssue(net, report.structureIssues[i])) << "\"";
+        }
+        line << "]";
+        if (maxK > 0 && report.workflowNet)
+        {
+            line << ",\"k_soundness\":[";
+            const std::vector<KSoundnessLevel> levels = checkKSoundness(net, maxK);
+            for (size_t i = 0; i < levels.size(); i++)
+            {
+                line << (i ? "," : "") << "{\"k\":" << levels[i].k << ",\"sound\":" << levels[i].sound << ",\"complete\":" << levels[i].complete
+                     << ",\"states\":" << levels[i].states << ",\"inherited\":" << levels[i].inherited << ",\"stuck\":" << levels[i].stuck << "}";
+            }
+            line << "]";
+        }
+        const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        line << ",\"time_ms\":" << elapsed << "}";
+    }
+    catch (const std::exception &e)
+    {
+        failed = true;
+        line << ",\"error\":\"" << jsonEscape(e.what()) << "\"}";
+    }
+    return line.str();
+}
+
+/// @brief Parses an option's number, as a signed value so that "-1" isn't read as a huge unsigned one.
+/// @return (bool) false unless the whole text is an integer from minimum to maximum.
+static bool parseCount(const std::string &text, long long minimum, long long maximum, long long &value)
+{
+    const char *end = text.data() + text.size();
+    const auto [last, error] = std::from_chars(text.data(), end, value);
+    return error == std::errc() && last == end && value >= minimum && value <= maximum;
+}
+
+/// @brief Prints the command line usage.
+static void printUsage(std::ostream &out)
+{
+    out << "Usage: PetriNets [-j N] [-k K] <net file | directory>...\n"
+           "Verifies every net and prints one JSON object per net on its own line.\n"
+           "  -j, --jobs N     Number of worker threads (default: number of cores, at most " << MAX_BATCH_JOBS << ")\n"
+           "  -k, --k-sound K  Also check k-soundness for 1 to K cases (K at most " << MAX_K_SOUNDNESS << ")\n"
+           "  -h, --help       Show this message\n"
+           "Without arguments the program runs interactively.\n";
+}
+
+/// @brief Non-interactive entry point, verifies many nets concurrently.
+/// @param arguments Command line arguments without the program name.
+/// @param out Stream receiving one result line per net.
+/// @param err Stream receiving usage errors.
+/// @return (Int) 0 if every net was verified, 1 if some couldn't be loaded, 2 on usage errors.
+int runBatch(const std::vector<std::string> &arguments, std::ostream &out, std::ostream &err)
+{
+    size_t jobs = 0;
+    uint32_t maxK = 0;
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < arguments.size(); i++)
+    {
+        const std::string &argument = arguments[i];
+        if (argument == "-h" || argument == "--help")
+        {
+            printUsage(out);
+            return 0;
+        }
+        else if (argument == "-j" || argument == "--jobs")
+        {
+            if (i + 1 == arguments.size())
+            {
+                err << argument << " expects a number\n";
+                return 2;
+            }
+            long long value = 0;
+            if (!parseCount(arguments[++i], 1, static_cast<long long>(MAX_BATCH_JOBS), value))
+            {
+                err << argument << " expects a number from 1 to " << MAX_BATCH_JOBS << "\n";
+                return 2;
+            }
+            jobs = static_cast<size_t>(value);
+        }
+        else if (argument == "-k" || argument == "--k-sound")
+        {
+            if (i + 1 == arguments.size())
+            {
+                err << argument << " expects a number\n";
+                return 2;
+            }
+            long long value = 0;
+            if (!parseCount(arguments[++i], 1, MAX_K_SOUNDNESS, value))
+            {
+                err << argument << " expects a number from 1 to " << MAX_K_SOUNDNESS << "\n";
+                return 2;
+            }
+            maxK = static_cast<uint32_t>(value);
+        }
+        else if (!argument.empty() && argument[0] == '-')
+        {
+            err << "Unknown option " << argument << "\n";
+            printUsage(err);
+            return 2;
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.empty())
+    {
+        printUsage(err);
+        return 2;
+    }
+
+    const std::vector<BatchInput> inputs = collectInputs(paths);
+    std::mutex outputMutex;
+    bool anyFailed = false;
+    {
+        ThreadPool pool(jobs);
+        // Busy workers verify fragments inline, a pool per net would multiply the threads by the cores
+        const size_t fragmentThreads = pool.size() == 1 || inputs.size() == 1 ? FRAGMENT_THREADS : 1;
+        for (const auto &input : inputs)
+        {
+            pool.submit([&, input]
+            {
+                bool failed = !input.error.empty();
+                const std::string line = failed ? "{\"file\":\"" + jsonEscape(input.path) + "\",\"error\":\"" + jsonEscape(input.error) + "\"}"
+                                                : verifyFile(input.path, maxK, fragmentThreads, failed);
+                std::lock_guard<std::mutex> lock(outputMutex);
+                out << line << '\n';
+                anyFailed = anyFailed || failed;
+            });
+        }
+        pool.wait();
+    }
+    out.flush();
+    return anyFailed ? 1 : 0;
+}
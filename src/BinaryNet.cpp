@@ -0,0 +1,254 @@
+#include "../include/BinaryNet.h"
+#include "../include/PetriNetBuilder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+static_assert(sizeof(Place) == 8 && std::is_trivially_copyable_v<Place>, "Place records are stored verbatim");
+static_assert(sizeof(Transition) == 4 && std::is_trivially_copyable_v<Transition>, "Transition records are stored verbatim");
+static_assert(sizeof(BinaryNetHeader) % 8 == 0, "Sections after the header must stay 8 byte aligned");
+
+/// @brief Raw bytes of one section, used by the writer.
+struct SectionData
+{
+    const void *data;
+    size_t length;
+};
+
+template <typename T>
+static SectionData sectionData(std::span<const T> values)
+{
+    return {values.data(), values.size_bytes()};
+}
+
+/// @brief Writes a finalized net in the binary format, see BinaryNetHeader.
+/// @param net Finalized net, the current tokens are stored as the initial marking.
+/// @param out Binary output stream.
+void writeBinaryNet(const PetriNet &net, std::ostream &out)
+{
+    const NetView view = net.view();
+    const SectionData sections[] = {
+        sectionData(view.places),
+        sectionData(view.transitions),
+        sectionData(view.nameOffsets),
+        {view.namePool.data(), view.namePool.size()},
+        sectionData(view.transitionInputs.offsets),
+        sectionData(view.transitionInputs.targets),
+        sectionData(view.transitionInputs.weights),
+        sectionData(view.transitionOutputs.offsets),
+        sectionData(view.transitionOutputs.targets),
+        sectionData(view.transitionOutputs.weights),
+        sectionData(view.placeInputs.offsets),
+        sectionData(view.placeInputs.targets),
+        sectionData(view.placeInputs.weights),
+        sectionData(view.placeOutputs.offsets),
+        sectionData(view.placeOutputs.targets),
+        sectionData(view.placeOutputs.weights),
+    };
+    static_assert(std::size(sections) == static_cast<size_t>(BinaryNetSection::Count));
+
+    BinaryNetHeader header{};
+    std::memcpy(header.magic, BINARY_NET_MAGIC, sizeof(header.magic));
+    header.version = BINARY_NET_VERSION;
+    header.byteOrder = BINARY_NET_BYTE_ORDER;
+    header.placeCount = static_cast<uint32_t>(view.placeCount());
+    header.transitionCount = static_cast<uint32_t>(view.transitionCount());
+    header.nameCount = static_cast<uint32_t>(view.nameOffsets.size() - 1);
+    header.flags = view.ordinary ? 1 : 0;
+    uint64_t offset = sizeof(BinaryNetHeader);
+    for (size_t i = 0; i < std::size(sections); i++)
+    {
+        header.sections[i] = {offset, sections[i].length};
+        offset = (offset + sections[i].length + 7) & ~uint64_t(7);
+    }
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    const char padding[8] = {};
+    for (const auto &section : sections)
+    {
+        out.write(static_cast<const char *>(section.data), static_cast<std::streamsize>(section.length));
+        out.write(padding, static_cast<std::streamsize>((8 - section.length % 8) % 8));
+    }
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write the binary net");
+    }
+}
+
+void saveBinaryNet(const PetriNet &net, const std::string &path)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path);
+    }
+    writeBinaryNet(net, file);
+}
+
+/// @brief Maps a CSR index (offsets, targets and weights sections starting at first) and checks that their sizes agree.
+static CsrView mappedIndex(const MappedFile &file, const BinaryNetHeader &header, BinaryNetSection first, size_t rows,
+                           const std::string &path)
+{
+    const BinaryNetSectionEntry *entries = header.sections + static_cast<size_t>(first);
+    CsrView index(mappedSection<uint32_t>(file, entries[0], path), mappedSection<uint32_t>(file, entries[1], path),
+                  mappedSection<uint32_t>(file, entries[2], path));
+    if (index.offsets.size() != rows + 1 || index.offsets.front() != 0 || index.offsets.back() != index.targets.size() ||
+        index.weights.size() != index.targets.size())
+    {
+        throw std::runtime_error(path + ": Inconsistent incidence section " + std::to_string(static_cast<uint32_t>(first)));
+    }
+    return index;
+}
+
+/// @brief Maps a binary net file written by writeBinaryNet.
+/// @param path Path of the file.
+MappedNet::MappedNet(const std::string &path) : file(path, false), path(path)
+{
+    if (file.size() < sizeof(BinaryNetHeader))
+    {
+        throw std::runtime_error(path + ": Truncated binary net header");
+    }
+    BinaryNetHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, BINARY_NET_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error(path + ": Not a binary net file");
+    }
+    if (header.byteOrder != BINARY_NET_BYTE_ORDER)
+    {
+        throw std::runtime_error(path + ": Binary net was written with a different byte order");
+    }
+    if (header.version != BINARY_NET_VERSION)
+    {
+        throw std::runtime_error(path + ": Unsupported binary net version " + std::to_string(header.version));
+    }
+    net.places = mappedSection<Place>(file, header.sections[static_cast<size_t>(BinaryNetSection::Places)], path);
+    net.transitions = mappedSection<Transition>(file, header.sections[static_cast<size_t>(BinaryNetSection::Transitions)], path);
+    net.nameOffsets = mappedSection<uint32_t>(file, header.sections[static_cast<size_t>(BinaryNetSection::NameOffsets)], path);
+    const auto pool = mappedSection<char>(file, header.sections[static_cast<size_t>(BinaryNetSection::NamePool)], path);
+    net.namePool = std::string_view(pool.data(), pool.size());
+    if (net.places.size() != header.placeCount || net.transitions.size() != header.transitionCount)
+    {
+        throw std::runtime_error(path + ": Place or transition count doesn't match the header");
+    }
+    if (net.nameOffsets.size() != size_t(header.nameCount) + 1 || net.nameOffsets.front() != 0 ||
+        net.nameOffsets.back() != net.namePool.size())
+    {
+        throw std::runtime_error(path + ": Inconsistent name table");
+    }
+    net.transitionInputs = mappedIndex(file, header, BinaryNetSection::TransitionInputOffsets, header.transitionCount, path);
+    net.transitionOutputs = mappedIndex(file, header, BinaryNetSection::TransitionOutputOffsets, header.transitionCount, path);
+    net.placeInputs = mappedIndex(file, header, BinaryNetSection::PlaceInputOffsets, header.placeCount, path);
+    net.placeOutputs = mappedIndex(file, header, BinaryNetSection::PlaceOutputOffsets, header.placeCount, path);
+    net.ordinary = (header.flags & 1) != 0;
+}
+
+const NetView &MappedNet::view() const
+{
+    return net;
+}
+
+/// @brief Checks that a CSR index has non-decreasing offsets, targets below columns and positive weights.
+static bool validIndex(const CsrView &index, size_t columns)
+{
+    for (size_t row = 0; row < index.rows(); row++)
+    {
+        if (index.offsets[row] > index.offsets[row + 1])
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < index.targets.size(); i++)
+    {
+        if (index.targets[i] >= columns || index.weights[i] == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MappedNet::verify() const
+{
+    const size_t names = net.nameOffsets.size() - 1;
+    for (size_t i = 0; i < names; i++)
+    {
+        if (net.nameOffsets[i] > net.nameOffsets[i + 1])
+        {
+            throw std::runtime_error(path + ": Inconsistent name table");
+        }
+    }
+    for (const auto &place : net.places)
+    {
+        if (place.name >= names || place.tokens < 0)
+        {
+            throw std::runtime_error(path + ": Invalid place record");
+        }
+    }
+    for (const auto &transition : net.transitions)
+    {
+        if (transition.name >= names)
+        {
+            throw std::runtime_error(path + ": Invalid transition record");
+        }
+    }
+    if (!validIndex(net.transitionInputs, net.placeCount()) || !validIndex(net.transitionOutputs, net.placeCount()) ||
+        !validIndex(net.placeInputs, net.transitionCount()) || !validIndex(net.placeOutputs, net.transitionCount()) ||
+        net.transitionInputs.targets.size() != net.placeOutputs.targets.size() ||
+        net.transitionOutputs.targets.size() != net.placeInputs.targets.size())
+    {
+        throw std::runtime_error(path + ": Invalid incidence");
+    }
+    // provenSound and the Commoner check trust the flag instead of looking at the weights
+    const auto unit = [](uint32_t weight) { return weight == 1; };
+    const bool ordinary = std::all_of(net.transitionInputs.weights.begin(), net.transitionInputs.weights.end(), unit) &&
+                          std::all_of(net.transitionOutputs.weights.begin(), net.transitionOutputs.weights.end(), unit);
+    if (ordinary != net.ordinary)
+    {
+        throw std::runtime_error(path + ": The ordinary flag doesn't match the arc weights");
+    }
+}
+
+/// @brief Copies a view into an owning, finalized PetriNet.
+/// @param view View of a finalized net, e.g. MappedNet::view().
+PetriNet netFromView(const NetView &view)
+{
+    const size_t arcCount = view.transitionInputs.targets.size() + view.transitionOutputs.targets.size();
+    PetriNetBuilder builder(view.placeCount(), view.transitionCount(), arcCount);
+    std::vector<PlaceSpec> places;
+    places.reserve(view.placeCount());
+    for (PlaceId place = 0; place < view.placeCount(); place++)
+    {
+        places.push_back({view.placeName(place), view.places[place].tokens});
+    }
+    builder.addPlaces(places);
+    std::vector<std::string_view> transitions;
+    transitions.reserve(view.transitionCount());
+    for (TransitionId transition = 0; transition < view.transitionCount(); transition++)
+    {
+        transitions.push_back(view.transitionName(transition));
+    }
+    builder.addTransitions(transitions);
+    Arcs arcs;
+    arcs.reserve(arcCount);
+    for (TransitionId transition = 0; transition < view.transitionCount(); transition++)
+    {
+        const auto inputs = view.preset(transition), inputWeights = view.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            arcs.push_back({inputs[i], transition, ArcDirection::PlaceToTransition, inputWeights[i]});
+        }
+        const auto outputs = view.postset(transition), outputWeights = view.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            arcs.push_back({transition, outputs[i], ArcDirection::TransitionToPlace, outputWeights[i]});
+        }
+    }
+    builder.addArcs(arcs);
+    return builder.build();
+}
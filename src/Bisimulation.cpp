@@ -0,0 +1,530 @@
+#include "../include/Bisimulation.h"
+#include "../include/ReachabilityGraph.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+/// @brief Partition of 0 .. n - 1 into blocks that are refined by marking elements and splitting the marked ones off.
+/// Every block is a contiguous range of elements with its marked elements at the front, so marking and splitting
+/// cost as much as the number of marked elements (the refinable partition of Valmari and Lehtinen).
+class RefinablePartition
+{
+public:
+    /// @param colors Initial block of every element, elements of equal colour start in the same block.
+    RefinablePartition(size_t size, std::span<const uint32_t> colors) : elements(size), location(size), blocks(size)
+    {
+        std::iota(elements.begin(), elements.end(), 0);
+        if (!colors.empty())
+        {
+            std::stable_sort(elements.begin(), elements.end(), [colors](uint32_t a, uint32_t b)
+            {
+                return colors[a] < colors[b];
+            });
+        }
+        for (uint32_t i = 0; i < size; i++)
+        {
+            const uint32_t element = elements[i];
+            location[element] = i;
+            if (i == 0 || (!colors.empty() && colors[element] != colors[elements[i - 1]]))
+            {
+                first.push_back(i);
+                end.push_back(i);
+                middle.push_back(i);
+            }
+            blocks[element] = static_cast<uint32_t>(first.size() - 1);
+            end.back() = i + 1;
+        }
+    }
+
+    [[nodiscard]] size_t blockCount() const
+    {
+        return first.size();
+    }
+
+    [[nodiscard]] uint32_t blockOf(uint32_t element) const
+    {
+        return blocks[element];
+    }
+
+    [[nodiscard]] uint32_t size(uint32_t block) const
+    {
+        return end[block] - first[block];
+    }
+
+    [[nodiscard]] std::span<const uint32_t> members(uint32_t block) const
+    {
+        return {elements.data() + first[block], size(block)};
+    }
+
+    void mark(uint32_t element)
+    {
+        const uint32_t block = blocks[element];
+        const uint32_t position = location[element];
+        const uint32_t boundary = middle[block];
+        if (position < boundary)
+        {
+            return;
+        }
+        if (boundary == first[block])
+        {
+            touched.push_back(block);
+        }
+        std::swap(elements[position], elements[boundary]);
+        location[elements[position]] = position;
+        location[element] = boundary;
+        middle[block]++;
+    }
+
+    /// @brief Splits the marked elements off every block that has unmarked ones too and clears the marks.
+    /// @param onSplit Called as onSplit(block, created) for every block that was split.
+    template <typename OnSplit>
+    void split(const OnSplit &onSplit)
+    {
+        for (const uint32_t block : touched)
+        {
+            const uint32_t boundary = middle[block];
+            if (boundary == end[block])
+            {
+                middle[block] = first[block];
+                continue;
+            }
+            const auto created = static_cast<uint32_t>(first.size());
+            first.push_back(first[block]);
+            end.push_back(boundary);
+            middle.push_back(first[block]);
+            first[block] = boundary;
+            middle[block] = boundary;
+            for (uint32_t i = first[created]; i < end[created]; i++)
+            {
+                blocks[elements[i]] = created;
+            }
+            onSplit(block, created);
+        }
+        touched.clear();
+    }
+
+private:
+    std::vector<uint32_t> elements;
+    std::vector<uint32_t> location; // Position of every element in elements
+    std::vector<uint32_t> blocks;   // Block of every element
+    std::vector<uint32_t> first;    // Block b spans elements[first[b] .. end[b]), marked up to middle[b]
+    std::vector<uint32_t> end;
+    std::vector<uint32_t> middle;
+    std::vector<uint32_t> touched; // Blocks with marked elements
+};
+
+/// @brief Strong bisimulation by Paige-Tarjan refinement: the partition is kept stable against a coarser
+/// partition of compound blocks, and a compound block is split by taking out its smaller half B.
+/// Blocks are then split by "has an a-edge into B" and "has a-edges into B only", the second test comes from
+/// counting a-edges per (state, label, compound block) instead of looking at the larger half.
+/// @return (std::vector) Block of every state.
+static std::vector<uint32_t> strongBisimulation(size_t stateCount, std::span<const LabeledEdge> edges, std::span<const uint32_t> colors)
+{
+    RefinablePartition partition(stateCount, colors);
+    const auto edgeCount = static_cast<uint32_t>(edges.size());
+
+    // Incoming edges of every state
+    std::vector<uint32_t> inOffsets(stateCount + 1, 0);
+    for (const LabeledEdge &edge : edges)
+    {
+        inOffsets[edge.to + 1]++;
+    }
+    std::partial_sum(inOffsets.begin(), inOffsets.end(), inOffsets.begin());
+    std::vector<uint32_t> incoming(edgeCount);
+    {
+        std::vector<uint32_t> next(inOffsets.begin(), inOffsets.end() - 1);
+        for (uint32_t edge = 0; edge < edgeCount; edge++)
+        {
+            incoming[next[edges[edge].to]++] = edge;
+        }
+    }
+
+    // counts[counter[e]] is the number of edges with the source and label of e into the compound block of its target
+    std::vector<uint32_t> order(edgeCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [edges](uint32_t a, uint32_t b)
+    {
+        return std::tie(edges[a].from, edges[a].transition) < std::tie(edges[b].from, edges[b].transition);
+    });
+    std::vector<uint32_t> counter(edgeCount);
+    std::vector<uint32_t> counts;
+    for (uint32_t i = 0; i < edgeCount; i++)
+    {
+        const LabeledEdge &edge = edges[order[i]];
+        if (i == 0 || edge.from != edges[order[i - 1]].from || edge.transition != edges[order[i - 1]].transition)
+        {
+            counts.push_back(0);
+        }
+        counter[order[i]] = static_cast<uint32_t>(counts.size() - 1);
+        counts.back()++;
+    }
+
+    // Compound blocks, the ones made of several blocks are pending
+    std::vector<std::vector<uint32_t>> compounds(1);
+    std::vector<uint32_t> compoundOf;
+    std::vector<uint32_t> positionInCompound;
+    std::vector<uint32_t> pending;
+    std::vector<bool> isPending(1, false);
+    const auto addBlock = [&](uint32_t block, uint32_t compound)
+    {
+        compoundOf.resize(std::max<size_t>(compoundOf.size(), block + 1));
+        positionInCompound.resize(compoundOf.size());
+        compoundOf[block] = compound;
+        positionInCompound[block] = static_cast<uint32_t>(compounds[compound].size());
+        compounds[compound].push_back(block);
+        if (compounds[compound].size() == 2 && !isPending[compound])
+        {
+            isPending[compound] = true;
+            pending.push_back(compound);
+        }
+    };
+    for (uint32_t block = 0; block < partition.blockCount(); block++)
+    {
+        addBlock(block, 0);
+    }
+    const auto onSplit = [&](uint32_t block, uint32_t created)
+    {
+        addBlock(created, compoundOf[block]);
+    };
+
+    // The initial partition has to be stable against the whole state space: a-edges somewhere or none
+    std::vector<uint32_t> splitter(order);
+    std::stable_sort(splitter.begin(), splitter.end(), [edges](uint32_t a, uint32_t b)
+    {
+        return edges[a].transition < edges[b].transition;
+    });
+    for (uint32_t i = 0; i < edgeCount; i++)
+    {
+        partition.mark(edges[splitter[i]].from);
+        if (i + 1 == edgeCount || edges[splitter[i + 1]].transition != edges[splitter[i]].transition)
+        {
+            partition.split(onSplit);
+        }
+    }
+
+    std::vector<uint32_t> remap;
+    std::vector<uint32_t> touchedCounters;
+    while (!pending.empty())
+    {
+        const uint32_t compound = pending.back();
+        std::vector<uint32_t> &members = compounds[compound];
+        // Taking out the smaller of two blocks touches every state O(log V) times over the whole run
+        const uint32_t block = partition.size(members[0]) <= partition.size(members[1]) ? members[0] : members[1];
+        members[positionInCompound[block]] = members.back();
+        positionInCompound[members.back()] = positionInCompound[block];
+        members.pop_back();
+        if (members.size() < 2)
+        {
+            pending.pop_back();
+            isPending[compound] = false;
+        }
+        compounds.emplace_back();
+        isPending.push_back(false);
+        addBlock(block, static_cast<uint32_t>(compounds.size() - 1));
+
+        splitter.clear();
+        for (const uint32_t state : partition.members(block))
+        {
+            splitter.insert(splitter.end(), incoming.begin() + inOffsets[state], incoming.begin() + inOffsets[state + 1]);
+        }
+        std::sort(splitter.begin(), splitter.end(), [edges](uint32_t a, uint32_t b)
+        {
+            return edges[a].transition < edges[b].transition;
+        });
+        for (size_t low = 0, high; low < splitter.size(); low = high)
+        {
+            high = low + 1;
+            while (high < splitter.size() && edges[splitter[high]].transition == edges[splitter[low]].transition)
+            {
+                high++;
+            }
+            const std::span<const uint32_t> labelled(splitter.data() + low, high - low);
+            // Count the edges into the block per source, in new counters
+            remap.resize(counts.size(), INVALID_ID);
+            for (const uint32_t edge : labelled)
+            {
+                const uint32_t old = counter[edge];
+                if (remap[old] == INVALID_ID)
+                {
+                    remap[old] = static_cast<uint32_t>(counts.size());
+                    counts.push_back(0);
+                    touchedCounters.push_back(old);
+                }
+                counts[remap[old]]++;
+            }
+            // Split by the sources of edges into the block
+            for (const uint32_t edge : labelled)
+            {
+                partition.mark(edges[edge].from);
+            }
+            partition.split(onSplit);
+            // Split by the sources whose edges into the compound block all go into the block
+            for (const uint32_t edge : labelled)
+            {
+                if (counts[remap[counter[edge]]] == counts[counter[edge]])
+                {
+                    partition.mark(edges[edge].from);
+                }
+            }
+            partition.split(onSplit);
+            // The edges into the block now count towards the block alone
+            for (const uint32_t old : touchedCounters)
+            {
+                counts[old] -= counts[remap[old]];
+            }
+            for (const uint32_t edge : labelled)
+            {
+                counter[edge] = remap[counter[edge]];
+            }
+            for (const uint32_t old : touchedCounters)
+            {
+                remap[old] = INVALID_ID;
+            }
+            touchedCounters.clear();
+        }
+    }
+
+    std::vector<uint32_t> blocks(stateCount);
+    for (StateId state = 0; state < stateCount; state++)
+    {
+        blocks[state] = partition.blockOf(state);
+    }
+    return blocks;
+}
+
+/// @brief Divergence-sensitive branching bisimulation by signature refinement. Cycles of silent edges are merged
+/// first (their states are branching bisimilar), then every round gives each state the signature of the (label, block)
+/// pairs it can reach through silent edges inside its own block, until the number of blocks stops growing. A merged
+/// cycle adds a divergence mark to the signature, so states that can loop silently forever are never merged with
+/// states that can't.
+/// @return (std::vector) Block of every state.
+static std::vector<uint32_t> branchingBisimulation(size_t stateCount, std::span<const LabeledEdge> edges, const std::vector<bool> &silent,
+                                                   std::span<const uint32_t> colors)
+{
+    const auto isSilent = [&silent](TransitionId transition)
+    {
+        return transition < silent.size() && silent[transition];
+    };
+    const auto colorOf = [colors](StateId state)
+    {
+        return colors.empty() ? 0 : colors[state];
+    };
+
+    // Silent edges between states of the same colour, the only ones that can stay inside a block
+    CsrIndex silentEdges;
+    silentEdges.offsets.assign(stateCount + 1, 0);
+    for (const LabeledEdge &edge : edges)
+    {
+        if (isSilent(edge.transition) && colorOf(edge.from) == colorOf(edge.to))
+        {
+            silentEdges.offsets[edge.from + 1]++;
+        }
+    }
+    std::partial_sum(silentEdges.offsets.begin(), silentEdges.offsets.end(), silentEdges.offsets.begin());
+    silentEdges.targets.resize(silentEdges.offsets.back());
+    {
+        std::vector<uint32_t> next(silentEdges.offsets.begin(), silentEdges.offsets.end() - 1);
+        for (const LabeledEdge &edge : edges)
+        {
+            if (isSilent(edge.transition) && colorOf(edge.from) == colorOf(edge.to))
+            {
+                silentEdges.targets[next[edge.from]++] = edge.to;
+            }
+        }
+    }
+    // Components are numbered after their silent successors
+    const StronglyConnectedComponents silentCycles = stronglyConnectedComponents(silentEdges);
+    const std::vector<uint32_t> &component = silentCycles.componentOf;
+    const auto componentCount = static_cast<uint32_t>(silentCycles.count);
+
+    // Graph of the components, without the silent edges inside one. A component with such an edge is a silent cycle.
+    std::vector<LabeledEdge> collapsed;
+    std::vector<bool> divergent(componentCount, false);
+    collapsed.reserve(edges.size());
+    for (const LabeledEdge &edge : edges)
+    {
+        const uint32_t from = component[edge.from];
+        const uint32_t to = component[edge.to];
+        if (isSilent(edge.transition) && from == to)
+        {
+            divergent[from] = true;
+        }
+        else
+        {
+            // Every silent transition is the same invisible step
+            collapsed.push_back({from, isSilent(edge.transition) ? INVALID_ID : edge.transition, to});
+        }
+    }
+    std::sort(collapsed.begin(), collapsed.end());
+    collapsed.erase(std::unique(collapsed.begin(), collapsed.end()), collapsed.end());
+    std::vector<uint32_t> outOffsets(componentCount + 1, 0);
+    for (const LabeledEdge &edge : collapsed)
+    {
+        outOffsets[edge.from + 1]++;
+    }
+    std::partial_sum(outOffsets.begin(), outOffsets.end(), outOffsets.begin());
+
+    std::vector<uint32_t> blocks(componentCount);
+    std::vector<uint32_t> componentColors(componentCount);
+    for (StateId state = 0; state < stateCount; state++)
+    {
+        componentColors[component[state]] = colorOf(state);
+    }
+    {
+        std::map<uint32_t, uint32_t> colorBlocks;
+        for (uint32_t node = 0; node < componentCount; node++)
+        {
+            blocks[node] = colorBlocks.emplace(componentColors[node], colorBlocks.size()).first->second;
+        }
+    }
+    size_t blockCount = componentCount == 0 ? 0 : *std::max_element(blocks.begin(), blocks.end()) + 1;
+    typedef std::vector<std::pair<uint32_t, uint32_t>> Signature;
+    std::vector<Signature> signatures(componentCount);
+    while (true)
+    {
+        // Silent successors come first, so their signatures are ready
+        for (uint32_t node = 0; node < componentCount; node++)
+        {
+            Signature &signature = signatures[node];
+            signature.clear();
+            if (divergent[node])
+            {
+                signature.emplace_back(INVALID_ID, INVALID_ID); // No edge has this pair, every silent edge leads to a block
+            }
+            for (uint32_t i = outOffsets[node]; i < outOffsets[node + 1]; i++)
+            {
+                const LabeledEdge &edge = collapsed[i];
+                if (edge.transition == INVALID_ID && blocks[edge.to] == blocks[node])
+                {
+                    signature.insert(signature.end(), signatures[edge.to].begin(), signatures[edge.to].end());
+                }
+                else
+                {
+                    signature.emplace_back(edge.transition, blocks[edge.to]);
+                }
+            }
+            std::sort(signature.begin(), signature.end());
+            signature.erase(std::unique(signature.begin(), signature.end()), signature.end());
+        }
+        std::map<std::pair<uint32_t, Signature>, uint32_t> refined;
+        std::vector<uint32_t> next(componentCount);
+        for (uint32_t node = 0; node < componentCount; node++)
+        {
+            next[node] = refined.emplace(std::make_pair(blocks[node], signatures[node]), refined.size()).first->second;
+        }
+        if (refined.size() == blockCount)
+        {
+            break;
+        }
+        blockCount = refined.size();
+        blocks = std::move(next);
+    }
+
+    std::vector<uint32_t> stateBlocks(stateCount);
+    for (StateId state = 0; state < stateCount; state++)
+    {
+        stateBlocks[state] = blocks[component[state]];
+    }
+    return stateBlocks;
+}
+
+Quotient drawingQuotient(size_t stateCount, std::span<const LabeledEdge> edges, const BisimulationOptions &options, std::span<const uint32_t> colors)
+{
+    if (!colors.empty() && colors.size() != stateCount)
+    {
+        throw std::invalid_argument("Expected a colour for each of the " + std::to_string(stateCount) + " states");
+    }
+    for (const LabeledEdge &edge : edges)
+    {
+        if (edge.from >= stateCount || edge.to >= stateCount)
+        {
+            throw std::invalid_argument("Edge between unknown states " + std::to_string(edge.from) + " and " + std::to_string(edge.to));
+        }
+    }
+    std::vector<uint32_t> blocks;
+    switch (options.equivalence)
+    {
+    case Equivalence::None:
+        blocks.resize(stateCount);
+        std::iota(blocks.begin(), blocks.end(), 0);
+        break;
+    case Equivalence::Strong:
+        blocks = strongBisimulation(stateCount, edges, colors);
+        break;
+    case Equivalence::Branching:
+        blocks = branchingBisimulation(stateCount, edges, options.silent, colors);
+        break;
+    }
+
+    // Number the blocks by their lowest state
+    Quotient quotient;
+    quotient.blockOf.resize(stateCount);
+    std::vector<uint32_t> numbers(stateCount, INVALID_ID);
+    for (StateId state = 0; state < stateCount; state++)
+    {
+        uint32_t &number = numbers[blocks[state]];
+        if (number == INVALID_ID)
+        {
+            number = static_cast<uint32_t>(quotient.representatives.size());
+            quotient.representatives.push_back(state);
+        }
+        quotient.blockOf[state] = number;
+    }
+    const bool branching = options.equivalence == Equivalence::Branching;
+    const auto isSilent = [&options](TransitionId transition)
+    {
+        return transition < options.silent.size() && options.silent[transition];
+    };
+    // Silent steps inside a block vanish in a branching quotient, unless they close a cycle: a divergent block keeps a loop
+    std::vector<LabeledEdge> inside;
+    for (const LabeledEdge &edge : edges)
+    {
+        if (branching && isSilent(edge.transition) && quotient.blockOf[edge.from] == quotient.blockOf[edge.to])
+        {
+            inside.push_back(edge);
+        }
+    }
+    std::vector<bool> divergent(quotient.blockCount(), false);
+    if (!inside.empty())
+    {
+        CsrIndex loops;
+        loops.offsets.assign(stateCount + 1, 0);
+        for (const LabeledEdge &edge : inside)
+        {
+            loops.offsets[edge.from + 1]++;
+        }
+        std::partial_sum(loops.offsets.begin(), loops.offsets.end(), loops.offsets.begin());
+        loops.targets.resize(inside.size());
+        std::vector<uint32_t> next(loops.offsets.begin(), loops.offsets.end() - 1);
+        for (const LabeledEdge &edge : inside)
+        {
+            loops.targets[next[edge.from]++] = edge.to;
+        }
+        const StronglyConnectedComponents cycles = stronglyConnectedComponents(loops);
+        for (const LabeledEdge &edge : inside)
+        {
+            if (cycles.componentOf[edge.from] == cycles.componentOf[edge.to])
+            {
+                divergent[quotient.blockOf[edge.from]] = true;
+            }
+        }
+    }
+    quotient.edges.reserve(edges.size());
+    for (const LabeledEdge &edge : edges)
+    {
+        const uint32_t from = quotient.blockOf[edge.from];
+        const uint32_t to = quotient.blockOf[edge.to];
+        if (branching && from == to && isSilent(edge.transition) && !divergent[from])
+        {
+            continue;
+        }
+        quotient.edges.push_back({from, edge.transition, to});
+    }
+    std::sort(quotient.edges.begin(), quotient.edges.end());
+    quotient.edges.erase(std::unique(quotient.edges.begin(), quotient.edges.end()), quotient.edges.end());
+    return quotient;
+}
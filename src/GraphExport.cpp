@@ -0,0 +1,242 @@
+#include "../include/GraphExport.h"
+#include "../include/ReachabilityDump.h"
+#include "../include/Renderer.h"
+#include "../include/Utility.h"
+#include "../include/XmlReader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+DotStateSpaceWriter::DotStateSpaceWriter(std::ostream &out, const NetView &net) : out(out), net(net)
+{
+    out << "digraph reachability {\n";
+    out << "node [shape=ellipse];\n";
+}
+
+void DotStateSpaceWriter::onEdge(StateId from, TransitionId transition, StateId to)
+{
+    out << 's' << from << " -> s" << to << " [label=";
+    writeDotQuoted(out, net.transitionName(transition));
+    out << "];\n";
+}
+
+void DotStateSpaceWriter::onExpanded(StateId state, std::span<const int32_t> marking, uint8_t flags)
+{
+    out << 's' << state << " [label=";
+    writeDotQuoted(out, markingToString(net, marking));
+    if (flags & STATE_INITIAL)
+    {
+        out << ", style=bold";
+    }
+    if (flags & STATE_FINAL)
+    {
+        out << ", peripheries=2";
+    }
+    if (flags & STATE_DEADLOCK)
+    {
+        out << ", color=red";
+    }
+    out << "];\n";
+}
+
+void DotStateSpaceWriter::onFinish(const StateSpaceResult &result)
+{
+    if (!result.complete)
+    {
+        out << "// Exploration stopped at the state limit, the graph is partial\n";
+    }
+    out << "}\n";
+}
+
+GraphmlStateSpaceWriter::GraphmlStateSpaceWriter(std::ostream &out, const NetView &net) : out(out), net(net)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n";
+    out << "<key id=\"marking\" for=\"node\" attr.name=\"marking\" attr.type=\"string\"/>\n";
+    out << "<key id=\"initial\" for=\"node\" attr.name=\"initial\" attr.type=\"boolean\"><default>false</default></key>\n";
+    out << "<key id=\"final\" for=\"node\" attr.name=\"final\" attr.type=\"boolean\"><default>false</default></key>\n";
+    out << "<key id=\"deadlock\" for=\"node\" attr.name=\"deadlock\" attr.type=\"boolean\"><default>false</default></key>\n";
+    out << "<key id=\"transition\" for=\"edge\" attr.name=\"transition\" attr.type=\"string\"/>\n";
+    out << "<key id=\"transitionId\" for=\"edge\" attr.name=\"transitionId\" attr.type=\"int\"/>\n";
+    out << "<graph id=\"reachability\" edgedefault=\"directed\">\n";
+}
+
+void GraphmlStateSpaceWriter::onEdge(StateId from, TransitionId transition, StateId to)
+{
+    out << "<edge source=\"s" << from << "\" target=\"s" << to << "\"><data key=\"transition\">";
+    writeXmlEscaped(out, net.transitionName(transition));
+    out << "</data><data key=\"transitionId\">" << transition << "</data></edge>\n";
+}
+
+void GraphmlStateSpaceWriter::onExpanded(StateId state, std::span<const int32_t> marking, uint8_t flags)
+{
+    out << "<node id=\"s" << state << "\"><data key=\"marking\">";
+    writeXmlEscaped(out, markingToString(net, marking));
+    out << "</data>";
+    if (flags & STATE_INITIAL)
+    {
+        out << "<data key=\"initial\">true</data>";
+    }
+    if (flags & STATE_FINAL)
+    {
+        out << "<data key=\"final\">true</data>";
+    }
+    if (flags & STATE_DEADLOCK)
+    {
+        out << "<data key=\"deadlock\">true</data>";
+    }
+    out << "</node>\n";
+}
+
+void GraphmlStateSpaceWriter::onFinish(const StateSpaceResult &result)
+{
+    if (!result.complete)
+    {
+        out << "<!-- Exploration stopped at the state limit, the graph is partial -->\n";
+    }
+    out << "</graph>\n</graphml>\n";
+}
+
+/// @brief Writes the places (circles with their tokens), transitions (boxes) and weighted arcs of a net as DOT.
+void writeNetDot(const NetView &net, std::ostream &out)
+{
+    out << "digraph net {\n";
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        out << 'p' << place << " [shape=circle, label=";
+        writeDotQuoted(out, net.placeName(place));
+        if (net.places[place].tokens > 0)
+        {
+            out << ", xlabel=\"" << net.places[place].tokens << '"';
+        }
+        out << "];\n";
+    }
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        out << 't' << transition << " [shape=box, label=";
+        writeDotQuoted(out, net.transitionName(transition));
+        out << "];\n";
+        const auto inputs = net.preset(transition), inputWeights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            out << 'p' << inputs[i] << " -> t" << transition;
+            if (inputWeights[i] != 1)
+            {
+                out << " [label=\"" << inputWeights[i] << "\"]";
+            }
+            out << ";\n";
+        }
+        const auto outputs = net.postset(transition), outputWeights = net.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            out << 't' << transition << " -> p" << outputs[i];
+            if (outputWeights[i] != 1)
+            {
+                out << " [label=\"" << outputWeights[i] << "\"]";
+            }
+            out << ";\n";
+        }
+    }
+    out << "}\n";
+}
+
+/// @brief Writes the places, transitions and weighted arcs of a net as GraphML.
+void writeNetGraphml(const NetView &net, std::ostream &out)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n";
+    out << "<key id=\"kind\" for=\"node\" attr.name=\"kind\" attr.type=\"string\"/>\n";
+    out << "<key id=\"name\" for=\"node\" attr.name=\"name\" attr.type=\"string\"/>\n";
+    out << "<key id=\"tokens\" for=\"node\" attr.name=\"tokens\" attr.type=\"int\"><default>0</default></key>\n";
+    out << "<key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"int\"><default>1</default></key>\n";
+    out << "<graph id=\"net\" edgedefault=\"directed\">\n";
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        out << "<node id=\"p" << place << "\"><data key=\"kind\">place</data><data key=\"name\">";
+        writeXmlEscaped(out, net.placeName(place));
+        out << "</data>";
+        if (net.places[place].tokens != 0)
+        {
+            out << "<data key=\"tokens\">" << net.places[place].tokens << "</data>";
+        }
+        out << "</node>\n";
+    }
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        out << "<node id=\"t" << transition << "\"><data key=\"kind\">transition</data><data key=\"name\">";
+        writeXmlEscaped(out, net.transitionName(transition));
+        out << "</data></node>\n";
+    }
+    const auto writeArc = [&out](char sourceKind, uint32_t source, char targetKind, uint32_t target, uint32_t weight)
+    {
+        out << "<edge source=\"" << sourceKind << source << "\" target=\"" << targetKind << target << "\"";
+        if (weight != 1)
+        {
+            out << "><data key=\"weight\">" << weight << "</data></edge>\n";
+        }
+        else
+        {
+            out << "/>\n";
+        }
+    };
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        const auto inputs = net.preset(transition), inputWeights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            writeArc('p', inputs[i], 't', transition, inputWeights[i]);
+        }
+        const auto outputs = net.postset(transition), outputWeights = net.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            writeArc('t', transition, 'p', outputs[i], outputWeights[i]);
+        }
+    }
+    out << "</graph>\n</graphml>\n";
+}
+
+StateSpaceResult exportReachabilityGraph(const NetView &net, const std::string &path, size_t maxStates)
+{
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension != ".dot" && extension != ".graphml")
+    {
+        return dumpReachabilityGraph(net, path, maxStates);
+    }
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path);
+    }
+    StateSpaceExplorer explorer(net, workflowFinalMarking(net));
+    if (extension == ".dot")
+    {
+        DotStateSpaceWriter writer(file, net);
+        return explorer.explore(writer, maxStates);
+    }
+    GraphmlStateSpaceWriter writer(file, net);
+    return explorer.explore(writer, maxStates);
+}
+
+bool exportNetGraph(const NetView &net, const std::string &path)
+{
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension != ".dot" && extension != ".graphml")
+    {
+        return false;
+    }
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path);
+    }
+    if (extension == ".dot")
+    {
+        writeNetDot(net, file);
+    }
+    else
+    {
+        writeNetGraphml(net, file);
+    }
+    return true;
+}
@@ -0,0 +1,324 @@
+#include "../include/Invariants.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+/// @brief Sparse row or column of integers as (index, value) pairs in increasing index order, without zeros.
+typedef std::vector<std::pair<uint32_t, int64_t>> SparseVector;
+
+/// @brief Row of Farkas' tableau: what is left of the incidence matrix and the combination of places that produced it.
+struct FarkasRow
+{
+    SparseVector remaining;
+    SparseVector coefficients;
+};
+
+/// @brief result = a * x + b * y.
+/// @return (bool) false if the result or an intermediate product doesn't fit in 64 bits. INT64_MIN is rejected as
+/// well, so every value in the tableau can be negated and passed to std::gcd.
+static bool multiplyAdd(int64_t a, int64_t x, int64_t b, int64_t y, int64_t &result)
+{
+    const auto multiply = [](int64_t left, int64_t right, int64_t &product)
+    {
+        if (left != 0 && right != 0 && (left == INT64_MIN || right == INT64_MIN || std::abs(left) > INT64_MAX / std::abs(right)))
+        {
+            return false;
+        }
+        product = left * right;
+        return true;
+    };
+    int64_t first = 0, second = 0;
+    if (!multiply(a, x, first) || !multiply(b, y, second))
+    {
+        return false;
+    }
+    if ((second > 0 && first > INT64_MAX - second) || (second < 0 && first <= INT64_MIN - second))
+    {
+        return false;
+    }
+    result = first + second;
+    return true;
+}
+
+/// @brief out = a * x + b * y, entries that cancel out are left out.
+/// @return (bool) false on overflow.
+static bool combine(int64_t a, const SparseVector &x, int64_t b, const SparseVector &y, SparseVector &out)
+{
+    out.clear();
+    size_t i = 0, j = 0;
+    while (i < x.size() || j < y.size())
+    {
+        const uint32_t index = j == y.size() || (i < x.size() && x[i].first < y[j].first) ? x[i].first : y[j].first;
+        const int64_t left = i < x.size() && x[i].first == index ? x[i++].second : 0;
+        const int64_t right = j < y.size() && y[j].first == index ? y[j++].second : 0;
+        int64_t value = 0;
+        if (!multiplyAdd(a, left, b, right, value))
+        {
+            return false;
+        }
+        if (value != 0)
+        {
+            out.emplace_back(index, value);
+        }
+    }
+    return true;
+}
+
+/// @brief Divides a row by the gcd of all its entries.
+static void normalize(FarkasRow &row)
+{
+    int64_t divisor = 0;
+    for (const SparseVector *part : {&row.remaining, &row.coefficients})
+    {
+        for (const auto &entry : *part)
+        {
+            divisor = std::gcd(divisor, entry.second);
+        }
+    }
+    if (divisor > 1)
+    {
+        for (SparseVector *part : {&row.remaining, &row.coefficients})
+        {
+            for (auto &entry : *part)
+            {
+                entry.second /= divisor;
+            }
+        }
+    }
+}
+
+/// @brief Farkas' algorithm on a tableau whose rows start as unit coefficient vectors.
+static InvariantBasis farkas(std::vector<FarkasRow> rows, size_t columns, size_t maxRows)
+{
+    std::vector<uint32_t> positive(columns), negative(columns);
+    std::vector<FarkasRow> next;
+    FarkasRow combined;
+    // Kept rows by the entries of their supports, and how many of a kept row's entries the current row shares
+    std::vector<std::vector<uint32_t>> keptWith(rows.size());
+    std::vector<uint32_t> shared, touched;
+    while (true)
+    {
+        std::fill(positive.begin(), positive.end(), 0);
+        std::fill(negative.begin(), negative.end(), 0);
+        for (const FarkasRow &row : rows)
+        {
+            for (const auto &[column, value] : row.remaining)
+            {
+                (value > 0 ? positive : negative)[column]++;
+            }
+        }
+        // Eliminating a column replaces its positive and negative rows by their pairwise combinations
+        uint32_t pivot = INVALID_ID;
+        int64_t fewestAdded = INT64_MAX;
+        for (uint32_t column = 0; column < columns; column++)
+        {
+            if (positive[column] + negative[column] == 0)
+            {
+                continue;
+            }
+            const int64_t added = static_cast<int64_t>(positive[column]) * negative[column] - positive[column] - negative[column];
+            if (added < fewestAdded)
+            {
+                fewestAdded = added;
+                pivot = column;
+            }
+        }
+        if (pivot == INVALID_ID)
+        {
+            break;
+        }
+        const auto valueAt = [pivot](const FarkasRow &row)
+        {
+            const auto entry = std::lower_bound(row.remaining.begin(), row.remaining.end(), pivot,
+                                                [](const auto &left, uint32_t index) { return left.first < index; });
+            return entry != row.remaining.end() && entry->first == pivot ? entry->second : 0;
+        };
+        next.clear();
+        std::vector<size_t> positiveRows, negativeRows;
+        for (size_t i = 0; i < rows.size(); i++)
+        {
+            const int64_t value = valueAt(rows[i]);
+            if (value > 0)
+            {
+                positiveRows.push_back(i);
+            }
+            else if (value < 0)
+            {
+                negativeRows.push_back(i);
+            }
+            else
+            {
+                next.push_back(std::move(rows[i]));
+            }
+        }
+        if (next.size() + positiveRows.size() * negativeRows.size() > maxRows)
+        {
+            return {{}, false};
+        }
+        for (const size_t up : positiveRows)
+        {
+            for (const size_t down : negativeRows)
+            {
+                // No entry is INT64_MIN (see multiplyAdd), so the negation and the gcd stay in range
+                const int64_t upValue = valueAt(rows[up]);
+                const int64_t downValue = -valueAt(rows[down]);
+                const int64_t divisor = std::gcd(upValue, downValue);
+                if (!combine(downValue / divisor, rows[up].remaining, upValue / divisor, rows[down].remaining, combined.remaining) ||
+                    !combine(downValue / divisor, rows[up].coefficients, upValue / divisor, rows[down].coefficients, combined.coefficients))
+                {
+                    return {{}, false};
+                }
+                normalize(combined);
+                next.push_back(combined);
+            }
+        }
+        // A row whose support contains another row's support can't lead to a minimal invariant, the smaller one is kept
+        std::stable_sort(next.begin(), next.end(), [](const FarkasRow &left, const FarkasRow &right)
+                         { return left.coefficients.size() < right.coefficients.size(); });
+        rows.clear();
+        shared.clear();
+        for (std::vector<uint32_t> &kept : keptWith)
+        {
+            kept.clear();
+        }
+        for (FarkasRow &row : next)
+        {
+            // A kept support lies inside the row's support if the row shares all of its entries
+            bool minimal = true;
+            for (const auto &[index, weight] : row.coefficients)
+            {
+                for (const uint32_t kept : keptWith[index])
+                {
+                    touched.push_back(kept);
+                    minimal = minimal && ++shared[kept] < rows[kept].coefficients.size();
+                }
+            }
+            for (const uint32_t kept : touched)
+            {
+                shared[kept] = 0;
+            }
+            touched.clear();
+            if (minimal)
+            {
+                for (const auto &[index, weight] : row.coefficients)
+                {
+                    keptWith[index].push_back(static_cast<uint32_t>(rows.size()));
+                }
+                shared.push_back(0);
+                rows.push_back(std::move(row));
+            }
+        }
+    }
+
+    InvariantBasis basis;
+    for (const FarkasRow &row : rows)
+    {
+        Invariant invariant;
+        for (const auto &[index, weight] : row.coefficients)
+        {
+            invariant.support.push_back(index);
+            invariant.weights.push_back(weight);
+        }
+        basis.invariants.push_back(std::move(invariant));
+    }
+    return basis;
+}
+
+/// @brief Tableau with one unit row per place over the incidence matrix.
+static std::vector<FarkasRow> incidenceRows(const NetView &net)
+{
+    std::vector<FarkasRow> rows(net.placeCount());
+    for (uint32_t row = 0; row < rows.size(); row++)
+    {
+        rows[row].coefficients.emplace_back(row, 1);
+    }
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        // Produced minus consumed tokens of the transition, a side condition (loop) cancels out
+        SparseVector column;
+        const auto inputs = net.preset(transition);
+        const auto inputWeights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            column.emplace_back(inputs[i], -static_cast<int64_t>(inputWeights[i]));
+        }
+        const auto outputs = net.postset(transition);
+        const auto outputWeights = net.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            column.emplace_back(outputs[i], static_cast<int64_t>(outputWeights[i]));
+        }
+        std::sort(column.begin(), column.end());
+        for (size_t i = 0; i < column.size(); i++)
+        {
+            int64_t value = column[i].second;
+            while (i + 1 < column.size() && column[i + 1].first == column[i].first)
+            {
+                value += column[++i].second;
+            }
+            if (value == 0)
+            {
+                continue;
+            }
+            // Transitions come in increasing order, so the place rows stay sorted
+            rows[column[i].first].remaining.emplace_back(transition, value);
+        }
+    }
+    return rows;
+}
+
+InvariantBasis placeInvariants(const NetView &net, size_t maxRows)
+{
+    return farkas(incidenceRows(net), net.transitionCount(), maxRows);
+}
+
+/// @brief y·M, false if it overflows.
+static bool weightedSum(const Invariant &invariant, std::span<const int32_t> marking, int64_t &sum)
+{
+    sum = 0;
+    for (size_t i = 0; i < invariant.support.size(); i++)
+    {
+        if (!multiplyAdd(1, sum, invariant.weights[i], marking[invariant.support[i]], sum))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PlaceBounds::bounded() const
+{
+    return std::none_of(tokens.begin(), tokens.end(), [](int64_t bound) { return bound == UNBOUNDED_PLACE; });
+}
+
+PlaceBounds placeBounds(const NetView &net, const InvariantBasis &basis)
+{
+    PlaceBounds bounds;
+    bounds.tokens.assign(net.placeCount(), UNBOUNDED_PLACE);
+    std::vector<int32_t> initial(net.placeCount());
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        initial[place] = net.places[place].tokens;
+    }
+    for (const Invariant &invariant : basis.invariants)
+    {
+        int64_t total = 0;
+        if (!weightedSum(invariant, initial, total))
+        {
+            continue;
+        }
+        for (size_t i = 0; i < invariant.support.size(); i++)
+        {
+            int64_t &bound = bounds.tokens[invariant.support[i]];
+            bound = std::min(bound, total / invariant.weights[i]);
+        }
+    }
+    return bounds;
+}
+
+bool separates(const Invariant &invariant, std::span<const int32_t> a, std::span<const int32_t> b)
+{
+    int64_t first = 0, second = 0;
+    return weightedSum(invariant, a, first) && weightedSum(invariant, b, second) && first != second;
+}
@@ -0,0 +1,184 @@
+#include "../include/KSoundness.h"
+#include "../include/BackwardReachability.h"
+#include "../include/StateSpace.h"
+#include "../include/WorkflowStructure.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/// @brief Whether the marking holds every input token of the transition.
+static bool isEnabled(const NetView &net, TransitionId transition, std::span<const int32_t> marking)
+{
+    const auto inputs = net.preset(transition);
+    const auto inputWeights = net.presetWeights(transition);
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        if (marking[inputs[i]] < static_cast<int32_t>(inputWeights[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<KSoundnessLevel> checkKSoundness(const NetView &net, uint32_t maxK, size_t maxStates)
+{
+    const WorkflowPlaces places = findWorkflowPlaces(net);
+    const PlaceId input = places.input, output = places.output;
+    if (input == INVALID_ID || output == INVALID_ID)
+    {
+        throw std::invalid_argument("k-soundness needs a single place without producers and a single one without consumers");
+    }
+    // A transition consuming a single token finds it in one of the parts of a sum, only the others can join two cases
+    std::vector<TransitionId> joins;
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        uint32_t consumed = 0;
+        for (const uint32_t weight : net.presetWeights(transition))
+        {
+            consumed += weight;
+        }
+        if (consumed > 1)
+        {
+            joins.push_back(transition);
+        }
+    }
+
+    const size_t placeCount = net.placeCount();
+    std::vector<KSoundnessLevel> levels;
+    MarkingStore single(placeCount), previous(placeCount);
+    std::vector<bool> singleCompletes, previousCompletes;
+    std::vector<int32_t> marking(placeCount), next(placeCount);
+    for (uint32_t k = 1; k <= maxK; k++)
+    {
+        KSoundnessLevel level;
+        level.k = k;
+        MarkingStore store(placeCount);
+        std::vector<std::pair<StateId, StateId>> parts; // The previous and single state every inherited marking sums
+        std::vector<bool> known;                        // Inherited markings whose parts both complete
+        if (k == 1)
+        {
+            std::fill(marking.begin(), marking.end(), 0);
+            marking[input] = 1;
+            store.insert(marking);
+            known.push_back(false);
+        }
+        for (StateId first = 0; first < previous.size() && level.complete; first++)
+        {
+            const auto firstTokens = previous[first];
+            for (StateId second = 0; second < single.size(); second++)
+            {
+                const auto secondTokens = single[second];
+                for (PlaceId place = 0; place < placeCount; place++)
+                {
+                    marking[place] = firstTokens[place] + secondTokens[place];
+                }
+                if (maxStates != 0 && store.size() >= maxStates && store.find(marking) == INVALID_ID)
+                {
+                    level.complete = false;
+                    break;
+                }
+                const auto [state, inserted] = store.insert(marking);
+                if (inserted)
+                {
+                    parts.emplace_back(first, second);
+                    known.push_back(false);
+                }
+                known[state] = known[state] || (previousCompletes[first] && singleCompletes[second]);
+            }
+        }
+        level.inherited = parts.size();
+
+        const auto fire = [&](TransitionId transition)
+        {
+            next = marking;
+            const auto inputs = net.preset(transition);
+            const auto inputWeights = net.presetWeights(transition);
+            for (size_t i = 0; i < inputs.size(); i++)
+            {
+                next[inputs[i]] -= static_cast<int32_t>(inputWeights[i]);
+            }
+            const auto outputs = net.postset(transition);
+            const auto outputWeights = net.postsetWeights(transition);
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                next[outputs[i]] += static_cast<int32_t>(outputWeights[i]);
+            }
+            if (maxStates != 0 && store.size() >= maxStates && store.find(next) == INVALID_ID)
+            {
+                level.complete = false;
+                return;
+            }
+            if (store.insert(next).second)
+            {
+                known.push_back(false);
+            }
+        };
+        for (StateId state = 0; state < store.size(); state++)
+        {
+            // Inserting may move the stored markings, the state is copied out first
+            const auto tokens = store[state];
+            std::copy(tokens.begin(), tokens.end(), marking.begin());
+            if (state < parts.size())
+            {
+                // Whatever one part can fire on its own leads to another sum, which is already stored
+                const auto firstTokens = previous[parts[state].first];
+                const auto secondTokens = single[parts[state].second];
+                for (const TransitionId transition : joins)
+                {
+                    if (isEnabled(net, transition, marking) && !isEnabled(net, transition, firstTokens) && !isEnabled(net, transition, secondTokens))
+                    {
+                        fire(transition);
+                    }
+                }
+                continue;
+            }
+            for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+            {
+                if (isEnabled(net, transition, marking))
+                {
+                    fire(transition);
+                }
+            }
+        }
+        level.states = store.size();
+
+        // The final marking and every sum known to complete are targets of one backward search
+        std::vector<StateId> targets;
+        std::fill(marking.begin(), marking.end(), 0);
+        marking[output] = static_cast<int32_t>(k);
+        const StateId finalState = store.find(marking);
+        if (finalState != INVALID_ID)
+        {
+            targets.push_back(finalState);
+        }
+        for (StateId state = 0; state < store.size(); state++)
+        {
+            if (known[state])
+            {
+                targets.push_back(state);
+            }
+        }
+        const std::vector<uint32_t> distances = distancesToAny(net, store, targets);
+        std::vector<bool> completes(store.size());
+        for (StateId state = 0; state < store.size(); state++)
+        {
+            completes[state] = distances[state] != INVALID_ID;
+            level.stuck += completes[state] ? 0 : 1;
+        }
+        level.sound = level.complete && level.stuck == 0;
+        levels.push_back(level);
+        if (!level.complete)
+        {
+            break;
+        }
+        if (k == 1)
+        {
+            single = store;
+            singleCompletes = completes;
+        }
+        previous = std::move(store);
+        previousCompletes = std::move(completes);
+    }
+    return levels;
+}
@@ -0,0 +1,850 @@
+#include "../include/Layout.h"
+#include "../include/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PETRINETS_LAYOUT_SSE2
+#endif
+
+static const int QUADTREE_MAX_DEPTH = 24; // Deeper cells only happen for (nearly) coincident nodes, they are merged
+static const float GOLDEN_ANGLE = 2.39996323f;
+static const size_t LAYOUT_CHUNK_SIZE = 256; // Nodes per parallel work item, fixed so results don't depend on the thread count
+
+/// @brief Point masses acting on one node, gathered into arrays so the force sums run as SIMD kernels.
+struct InteractionList
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> mass;
+
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        mass.clear();
+    }
+
+    void push(float pointX, float pointY, float pointMass)
+    {
+        x.push_back(pointX);
+        y.push_back(pointY);
+        mass.push_back(pointMass);
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return x.size();
+    }
+};
+
+/// @brief Cell of a Barnes-Hut quadtree, a leaf holds one body (or several merged at the depth limit).
+struct QuadCell
+{
+    float centerX;
+    float centerY;
+    float half; // Half the side length
+    float massX = 0;
+    float massY = 0;
+    uint32_t mass = 0;
+    int32_t body = -1;
+    int32_t children[4] = {-1, -1, -1, -1};
+
+    [[nodiscard]] bool leaf() const
+    {
+        return children[0] < 0 && children[1] < 0 && children[2] < 0 && children[3] < 0;
+    }
+};
+
+/// @brief Quadtree over the node positions with the centre of mass of every cell.
+class QuadTree
+{
+public:
+    void build(const LayoutPositions &positions)
+    {
+        cells.clear();
+        const auto [minX, maxX] = std::minmax_element(positions.x.begin(), positions.x.end());
+        const auto [minY, maxY] = std::minmax_element(positions.y.begin(), positions.y.end());
+        const float half = std::max(*maxX - *minX, *maxY - *minY) / 2 + 1e-3f;
+        cells.push_back({(*minX + *maxX) / 2, (*minY + *maxY) / 2, half});
+        for (size_t body = 0; body < positions.size(); body++)
+        {
+            insert(static_cast<int32_t>(body), positions.x[body], positions.y[body], positions);
+        }
+    }
+
+    /// @brief Collects the masses repelling a body, far cells are approximated by their centre of mass.
+    void interactions(int32_t body, float x, float y, float theta2, InteractionList &list) const
+    {
+        int32_t stack[4 * QUADTREE_MAX_DEPTH + 4];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const QuadCell &cell = cells[stack[--top]];
+            const float dx = x - cell.massX;
+            const float dy = y - cell.massY;
+            const float distance2 = dx * dx + dy * dy;
+            const bool leaf = cell.leaf();
+            if (leaf || 4 * cell.half * cell.half < theta2 * distance2)
+            {
+                if ((leaf && cell.body == body && cell.mass == 1) || distance2 < 1e-12f)
+                {
+                    continue;
+                }
+                list.push(cell.massX, cell.massY, static_cast<float>(cell.mass));
+                continue;
+            }
+            for (const int32_t child : cell.children)
+            {
+                if (child >= 0)
+                {
+                    stack[top++] = child;
+                }
+            }
+        }
+    }
+
+private:
+    static int quadrant(const QuadCell &cell, float x, float y)
+    {
+        return (x >= cell.centerX ? 1 : 0) | (y >= cell.centerY ? 2 : 0);
+    }
+
+    int32_t addChild(int32_t parent, int quadrant)
+    {
+        const QuadCell &cell = cells[parent];
+        const float half = cell.half / 2;
+        const float centerX = cell.centerX + ((quadrant & 1) ? half : -half);
+        const float centerY = cell.centerY + ((quadrant & 2) ? half : -half);
+        const auto child = static_cast<int32_t>(cells.size());
+        cells.push_back({centerX, centerY, half});
+        cells[parent].children[quadrant] = child;
+        return child;
+    }
+
+    void insert(int32_t body, float x, float y, const LayoutPositions &positions)
+    {
+        int32_t index = 0;
+        for (int depth = 0;; depth++)
+        {
+            QuadCell &cell = cells[index];
+            cell.mass++;
+            cell.massX += (x - cell.massX) / static_cast<float>(cell.mass);
+            cell.massY += (y - cell.massY) / static_cast<float>(cell.mass);
+            if (cell.leaf())
+            {
+                if (cell.mass == 1)
+                {
+                    cell.body = body;
+                    return;
+                }
+                if (depth >= QUADTREE_MAX_DEPTH)
+                {
+                    return;
+                }
+                // Push the resident body one level down before descending
+                const int32_t resident = cell.body;
+                cell.body = -1;
+                const float residentX = positions.x[resident], residentY = positions.y[resident];
+                const int32_t child = addChild(index, quadrant(cells[index], residentX, residentY));
+                cells[child] = {cells[child].centerX, cells[child].centerY, cells[child].half, residentX, residentY, 1, resident};
+            }
+            const int q = quadrant(cells[index], x, y);
+            if (cells[index].children[q] < 0)
+            {
+                const int32_t child = addChild(index, q);
+                cells[child].massX = x;
+                cells[child].massY = y;
+                cells[child].mass = 1;
+                cells[child].body = body;
+                return;
+            }
+            index = cells[index].children[q];
+        }
+    }
+
+    std::vector<QuadCell> cells;
+};
+
+void spiralLayout(size_t nodeCount, LayoutPositions &positions)
+{
+    positions.x.resize(nodeCount);
+    positions.y.resize(nodeCount);
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        const float radius = std::sqrt(static_cast<float>(node) + 0.5f);
+        const float angle = static_cast<float>(node) * GOLDEN_ANGLE;
+        positions.x[node] = radius * std::cos(angle);
+        positions.y[node] = radius * std::sin(angle);
+    }
+}
+
+#ifdef PETRINETS_LAYOUT_SSE2
+/// @brief Adds the four lanes in a fixed order.
+static float horizontalSum(__m128 values)
+{
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, values);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+/// @brief Adds the repulsion k^2 * mass / d of every point in the list acting on (x, y).
+/// Coincident points are left out of the list, so no distance is zero.
+static void addRepulsion(const InteractionList &list, float x, float y, float k2, float &forceX, float &forceY)
+{
+    size_t i = 0;
+    float sumX = 0, sumY = 0;
+#ifdef PETRINETS_LAYOUT_SSE2
+    const __m128 nodeX = _mm_set1_ps(x), nodeY = _mm_set1_ps(y), constant = _mm_set1_ps(k2);
+    __m128 accumulatedX = _mm_setzero_ps(), accumulatedY = _mm_setzero_ps();
+    for (; i + 4 <= list.size(); i += 4)
+    {
+        const __m128 dx = _mm_sub_ps(nodeX, _mm_loadu_ps(&list.x[i]));
+        const __m128 dy = _mm_sub_ps(nodeY, _mm_loadu_ps(&list.y[i]));
+        const __m128 distance2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 strength = _mm_div_ps(_mm_mul_ps(constant, _mm_loadu_ps(&list.mass[i])), distance2);
+        accumulatedX = _mm_add_ps(accumulatedX, _mm_mul_ps(dx, strength));
+        accumulatedY = _mm_add_ps(accumulatedY, _mm_mul_ps(dy, strength));
+    }
+    sumX = horizontalSum(accumulatedX);
+    sumY = horizontalSum(accumulatedY);
+#endif
+    for (; i < list.size(); i++)
+    {
+        const float dx = x - list.x[i];
+        const float dy = y - list.y[i];
+        const float strength = k2 * list.mass[i] / (dx * dx + dy * dy);
+        sumX += dx * strength;
+        sumY += dy * strength;
+    }
+    forceX += sumX;
+    forceY += sumY;
+}
+
+/// @brief Adds the attraction d^2 / k of every neighbour in the list acting on (x, y).
+static void addAttraction(const InteractionList &list, float x, float y, float k, float &forceX, float &forceY)
+{
+    size_t i = 0;
+    float sumX = 0, sumY = 0;
+#ifdef PETRINETS_LAYOUT_SSE2
+    const __m128 nodeX = _mm_set1_ps(x), nodeY = _mm_set1_ps(y), inverse = _mm_set1_ps(1 / k);
+    __m128 accumulatedX = _mm_setzero_ps(), accumulatedY = _mm_setzero_ps();
+    for (; i + 4 <= list.size(); i += 4)
+    {
+        const __m128 dx = _mm_sub_ps(nodeX, _mm_loadu_ps(&list.x[i]));
+        const __m128 dy = _mm_sub_ps(nodeY, _mm_loadu_ps(&list.y[i]));
+        const __m128 strength = _mm_mul_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))), inverse);
+        accumulatedX = _mm_add_ps(accumulatedX, _mm_mul_ps(dx, strength));
+        accumulatedY = _mm_add_ps(accumulatedY, _mm_mul_ps(dy, strength));
+    }
+    sumX = horizontalSum(accumulatedX);
+    sumY = horizontalSum(accumulatedY);
+#endif
+    for (; i < list.size(); i++)
+    {
+        const float dx = x - list.x[i];
+        const float dy = y - list.y[i];
+        const float strength = std::sqrt(dx * dx + dy * dy) * (1 / k);
+        sumX += dx * strength;
+        sumY += dy * strength;
+    }
+    forceX -= sumX;
+    forceY -= sumY;
+}
+
+/// @brief Runs job(chunk, worker) for every chunk, spread over the pool if there is one.
+/// Chunks write disjoint results, so the outcome doesn't depend on which worker ran them.
+template <typename Job>
+static void forEachChunk(ThreadPool *pool, size_t chunkCount, const Job &job)
+{
+    if (pool == nullptr)
+    {
+        for (size_t chunk = 0; chunk < chunkCount; chunk++)
+        {
+            job(chunk, 0);
+        }
+        return;
+    }
+    std::atomic<size_t> next = 0;
+    for (size_t worker = 0; worker < pool->size(); worker++)
+    {
+        pool->submit([&next, &job, chunkCount, worker]
+                     {
+                         for (size_t chunk = next++; chunk < chunkCount; chunk = next++)
+                         {
+                             job(chunk, worker);
+                         }
+                     });
+    }
+    pool->wait();
+}
+
+/// @brief Symmetric adjacency of a layout graph in CSR form, self loops are left out as they exert no force.
+static void buildAdjacency(const LayoutGraph &graph, std::vector<uint32_t> &offsets, std::vector<uint32_t> &neighbours)
+{
+    const size_t n = graph.nodeCount;
+    offsets.assign(n + 1, 0);
+    for (const auto &[from, to] : graph.edges)
+    {
+        if (from != to)
+        {
+            offsets[from + 1]++;
+            offsets[to + 1]++;
+        }
+    }
+    for (size_t node = 0; node < n; node++)
+    {
+        offsets[node + 1] += offsets[node];
+    }
+    neighbours.resize(offsets[n]);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto &[from, to] : graph.edges)
+    {
+        if (from != to)
+        {
+            neighbours[cursor[from]++] = to;
+            neighbours[cursor[to]++] = from;
+        }
+    }
+}
+
+/// @brief Pool computing the forces of a graph with this many nodes, null if one thread is enough.
+/// Created once per layout, every level of a multilevel layout shares it.
+static std::unique_ptr<ThreadPool> layoutPool(size_t nodeCount, const LayoutOptions &options)
+{
+    const size_t chunkCount = (nodeCount + LAYOUT_CHUNK_SIZE - 1) / LAYOUT_CHUNK_SIZE;
+    const size_t threads = std::min(options.threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : options.threads, chunkCount);
+    return threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+}
+
+/// @brief Runs the force-directed iterations from the given positions, steps start at startTemperature edge lengths.
+/// @param pool Workers for the forces, null to compute them on the calling thread.
+static void layoutLevel(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options, float startTemperature, ThreadPool *pool)
+{
+    const size_t n = graph.nodeCount;
+    if (n < 2)
+    {
+        return;
+    }
+    std::vector<uint32_t> offsets, neighbours;
+    buildAdjacency(graph, offsets, neighbours);
+
+    const float k = 1.0f; // Ideal edge length
+    const float k2 = k * k;
+    const auto theta2 = static_cast<float>(options.theta * options.theta);
+    const auto tolerance = static_cast<float>(LAYOUT_TOLERANCE) * k;
+
+    const size_t chunkCount = (n + LAYOUT_CHUNK_SIZE - 1) / LAYOUT_CHUNK_SIZE;
+    if (chunkCount < 2)
+    {
+        pool = nullptr; // A single chunk isn't worth handing over
+    }
+    std::vector<InteractionList> lists(pool ? pool->size() : 1);
+    std::vector<float> forceX(n), forceY(n), chunkMovement(chunkCount);
+    QuadTree tree;
+    for (int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        // Cool down linearly, keeping a little movement until the end
+        const float temperature = std::max(startTemperature * (1 - static_cast<float>(iteration) / static_cast<float>(options.iterations)), k / 100);
+        tree.build(positions);
+        forEachChunk(pool, chunkCount, [&](size_t chunk, size_t worker)
+        {
+            InteractionList &list = lists[worker];
+            const size_t end = std::min(n, (chunk + 1) * LAYOUT_CHUNK_SIZE);
+            for (size_t node = chunk * LAYOUT_CHUNK_SIZE; node < end; node++)
+            {
+                const float x = positions.x[node], y = positions.y[node];
+                float fx = 0, fy = 0;
+                list.clear();
+                tree.interactions(static_cast<int32_t>(node), x, y, theta2, list);
+                addRepulsion(list, x, y, k2, fx, fy);
+                list.clear();
+                for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++)
+                {
+                    list.push(positions.x[neighbours[i]], positions.y[neighbours[i]], 1);
+                }
+                addAttraction(list, x, y, k, fx, fy);
+                forceX[node] = fx;
+                forceY[node] = fy;
+            }
+        });
+        // Move every node at once, limited by the temperature
+        forEachChunk(pool, chunkCount, [&](size_t chunk, size_t)
+        {
+            float movement = 0;
+            const size_t end = std::min(n, (chunk + 1) * LAYOUT_CHUNK_SIZE);
+            for (size_t node = chunk * LAYOUT_CHUNK_SIZE; node < end; node++)
+            {
+                const float length = std::sqrt(forceX[node] * forceX[node] + forceY[node] * forceY[node]);
+                if (length > 0)
+                {
+                    const float step = std::min(length, temperature) / length;
+                    positions.x[node] += forceX[node] * step;
+                    positions.y[node] += forceY[node] * step;
+                    movement += std::min(length, temperature);
+                }
+            }
+            chunkMovement[chunk] = movement;
+        });
+        // Sum the chunks in order so the stopping point is the same for any number of threads
+        float movement = 0;
+        for (const float chunk : chunkMovement)
+        {
+            movement += chunk;
+        }
+        if (movement < tolerance * static_cast<float>(n))
+        {
+            break;
+        }
+    }
+}
+
+/// @brief forceDirectedLayout on the given pool.
+static void forceDirectedLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options, ThreadPool *pool)
+{
+    if (positions.size() != graph.nodeCount || positions.y.size() != graph.nodeCount)
+    {
+        spiralLayout(graph.nodeCount, positions);
+    }
+    if (options.refine)
+    {
+        LayoutOptions refinement = options;
+        refinement.iterations = std::min(options.iterations, MULTILEVEL_ITERATIONS);
+        layoutLevel(graph, positions, refinement, MULTILEVEL_TEMPERATURE, pool);
+        return;
+    }
+    layoutLevel(graph, positions, options, std::sqrt(static_cast<float>(graph.nodeCount)) / 4, pool);
+}
+
+void forceDirectedLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options)
+{
+    const std::unique_ptr<ThreadPool> pool = layoutPool(graph.nodeCount, options);
+    forceDirectedLayout(graph, positions, options, pool.get());
+}
+
+/// @brief Pairs every node with the lightest unmatched neighbour, nodes left over join the lightest neighbouring cluster.
+/// Nodes are visited from the lowest degree up, so leaves are merged into their hubs instead of blocking them.
+/// @param weights Number of original nodes behind every node.
+/// @param clusterOf Receives the cluster of every node.
+/// @return (size_t) Number of clusters.
+static size_t matchNodes(const LayoutGraph &graph, const std::vector<uint32_t> &weights, std::vector<uint32_t> &clusterOf)
+{
+    const size_t n = graph.nodeCount;
+    const uint32_t unmatched = UINT32_MAX;
+    std::vector<uint32_t> offsets, neighbours;
+    buildAdjacency(graph, offsets, neighbours);
+    std::vector<uint32_t> order(n);
+    for (uint32_t node = 0; node < n; node++)
+    {
+        order[node] = node;
+    }
+    std::stable_sort(order.begin(), order.end(), [&offsets](uint32_t a, uint32_t b)
+    {
+        return offsets[a + 1] - offsets[a] < offsets[b + 1] - offsets[b];
+    });
+
+    clusterOf.assign(n, unmatched);
+    std::vector<uint32_t> clusterWeights;
+    for (const uint32_t node : order)
+    {
+        if (clusterOf[node] != unmatched)
+        {
+            continue;
+        }
+        uint32_t partner = unmatched;
+        for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++)
+        {
+            const uint32_t other = neighbours[i];
+            if (clusterOf[other] == unmatched && (partner == unmatched || weights[other] < weights[partner] || (weights[other] == weights[partner] && other < partner)))
+            {
+                partner = other;
+            }
+        }
+        if (partner != unmatched)
+        {
+            clusterOf[node] = clusterOf[partner] = static_cast<uint32_t>(clusterWeights.size());
+            clusterWeights.push_back(weights[node] + weights[partner]);
+        }
+    }
+    // Every neighbour of a node still unmatched is matched by now
+    for (const uint32_t node : order)
+    {
+        if (clusterOf[node] != unmatched)
+        {
+            continue;
+        }
+        uint32_t cluster = unmatched;
+        for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++)
+        {
+            const uint32_t other = clusterOf[neighbours[i]];
+            if (other != unmatched && (cluster == unmatched || clusterWeights[other] < clusterWeights[cluster] || (clusterWeights[other] == clusterWeights[cluster] && other < cluster)))
+            {
+                cluster = other;
+            }
+        }
+        if (cluster == unmatched)
+        {
+            cluster = static_cast<uint32_t>(clusterWeights.size());
+            clusterWeights.push_back(0);
+        }
+        clusterOf[node] = cluster;
+        clusterWeights[cluster] += weights[node];
+    }
+    return clusterWeights.size();
+}
+
+/// @brief Graph with every cluster contracted to a node, parallel edges merged and edges inside a cluster dropped.
+static LayoutGraph contract(const LayoutGraph &graph, const std::vector<uint32_t> &clusterOf, size_t clusterCount)
+{
+    LayoutGraph coarse;
+    coarse.nodeCount = clusterCount;
+    coarse.edges.reserve(graph.edges.size());
+    for (const auto &[from, to] : graph.edges)
+    {
+        const uint32_t a = clusterOf[from], b = clusterOf[to];
+        if (a != b)
+        {
+            coarse.edges.emplace_back(std::min(a, b), std::max(a, b));
+        }
+    }
+    std::sort(coarse.edges.begin(), coarse.edges.end());
+    coarse.edges.erase(std::unique(coarse.edges.begin(), coarse.edges.end()), coarse.edges.end());
+    return coarse;
+}
+
+/// @brief multilevelLayout on the given pool, shared by all levels.
+static void multilevelLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options, ThreadPool *pool)
+{
+    // Coarsen until the graph is small or matching stops shrinking it
+    std::vector<LayoutGraph> levels;
+    std::vector<std::vector<uint32_t>> clusters;
+    std::vector<uint32_t> weights(graph.nodeCount, 1);
+    const LayoutGraph *current = &graph;
+    while (current->nodeCount > MULTILEVEL_COARSEST)
+    {
+        std::vector<uint32_t> clusterOf;
+        const size_t clusterCount = matchNodes(*current, weights, clusterOf);
+        if (clusterCount * 10 > current->nodeCount * 9)
+        {
+            break;
+        }
+        std::vector<uint32_t> clusterWeights(clusterCount, 0);
+        for (size_t node = 0; node < current->nodeCount; node++)
+        {
+            clusterWeights[clusterOf[node]] += weights[node];
+        }
+        levels.push_back(contract(*current, clusterOf, clusterCount));
+        clusters.push_back(std::move(clusterOf));
+        weights = std::move(clusterWeights);
+        current = &levels.back();
+    }
+
+    spiralLayout(current->nodeCount, positions);
+    layoutLevel(*current, positions, options, std::sqrt(static_cast<float>(current->nodeCount)) / 4, pool);
+
+    // Place the nodes of every cluster around its position and refine, the finer graph needs more room
+    LayoutOptions refinement = options;
+    refinement.iterations = std::min(options.iterations, MULTILEVEL_ITERATIONS);
+    for (size_t level = levels.size(); level-- > 0;)
+    {
+        const LayoutGraph &fine = level == 0 ? graph : levels[level - 1];
+        const std::vector<uint32_t> &clusterOf = clusters[level];
+        const float spread = std::sqrt(static_cast<float>(fine.nodeCount) / static_cast<float>(levels[level].nodeCount));
+        std::vector<uint32_t> placed(levels[level].nodeCount, 0);
+        LayoutPositions finePositions;
+        finePositions.x.resize(fine.nodeCount);
+        finePositions.y.resize(fine.nodeCount);
+        for (size_t node = 0; node < fine.nodeCount; node++)
+        {
+            const uint32_t cluster = clusterOf[node];
+            const auto member = static_cast<float>(placed[cluster]++);
+            const float radius = 0.3f * std::sqrt(member);
+            const float angle = (member + static_cast<float>(cluster)) * GOLDEN_ANGLE;
+            finePositions.x[node] = positions.x[cluster] * spread + radius * std::cos(angle);
+            finePositions.y[node] = positions.y[cluster] * spread + radius * std::sin(angle);
+        }
+        positions = std::move(finePositions);
+        layoutLevel(fine, positions, refinement, MULTILEVEL_TEMPERATURE, pool);
+    }
+}
+
+void multilevelLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options)
+{
+    const std::unique_ptr<ThreadPool> pool = layoutPool(graph.nodeCount, options);
+    multilevelLayout(graph, positions, options, pool.get());
+}
+
+void placeNewNodes(const LayoutGraph &graph, LayoutPositions &positions, const std::vector<bool> &known)
+{
+    const size_t n = graph.nodeCount;
+    std::vector<uint32_t> offsets, neighbours;
+    buildAdjacency(graph, offsets, neighbours);
+    std::vector<bool> placed = known;
+    std::vector<uint32_t> queue;
+    float maxX = 0;
+    for (uint32_t node = 0; node < n; node++)
+    {
+        if (placed[node])
+        {
+            queue.push_back(node);
+            maxX = queue.size() == 1 ? positions.x[node] : std::max(maxX, positions.x[node]);
+        }
+    }
+    // Breadth-first from the placed nodes, each new node goes one edge length away from the node that reached it
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        const uint32_t node = queue[head];
+        for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++)
+        {
+            const uint32_t other = neighbours[i];
+            if (!placed[other])
+            {
+                const float angle = static_cast<float>(other) * GOLDEN_ANGLE;
+                positions.x[other] = positions.x[node] + std::cos(angle);
+                positions.y[other] = positions.y[node] + std::sin(angle);
+                placed[other] = true;
+                queue.push_back(other);
+            }
+        }
+    }
+    LayoutPositions spiral;
+    spiralLayout(n - queue.size(), spiral);
+    const float shift = maxX + std::sqrt(static_cast<float>(spiral.size())) + 1;
+    size_t next = 0;
+    for (uint32_t node = 0; node < n; node++)
+    {
+        if (!placed[node])
+        {
+            positions.x[node] = spiral.x[next] + shift;
+            positions.y[node] = spiral.y[next];
+            next++;
+        }
+    }
+}
+
+void computeLayout(const LayoutGraph &graph, LayoutPositions &positions, const LayoutOptions &options)
+{
+    // The finest level has the most chunks, the pool is sized for it and reused by the coarser ones
+    const std::unique_ptr<ThreadPool> pool = layoutPool(graph.nodeCount, options);
+    if (options.mode == LayoutMode::Multilevel && !options.refine)
+    {
+        multilevelLayout(graph, positions, options, pool.get());
+    }
+    else
+    {
+        forceDirectedLayout(graph, positions, options, pool.get());
+    }
+}
+
+/// @brief Counts the crossings between two adjacent layers with a Fenwick tree, O(E log V).
+/// @param pairs Ranks (upper, lower) of the edges between the layers, sorted on return.
+static size_t countCrossings(std::vector<std::pair<uint32_t, uint32_t>> &pairs, size_t lowerSize)
+{
+    std::sort(pairs.begin(), pairs.end());
+    // Edges seen so far ending strictly right of the current lower rank cross the current edge
+    std::vector<uint32_t> tree(lowerSize + 1, 0);
+    size_t crossings = 0, seen = 0;
+    for (const auto &[upper, lower] : pairs)
+    {
+        size_t notRight = 0;
+        for (size_t i = lower + 1; i > 0; i -= i & (~i + 1))
+        {
+            notRight += tree[i];
+        }
+        crossings += seen - notRight;
+        for (size_t i = lower + 1; i <= lowerSize; i += i & (~i + 1))
+        {
+            tree[i]++;
+        }
+        seen++;
+    }
+    return crossings;
+}
+
+void layeredLayout(const LayoutGraph &graph, std::span<const uint32_t> sources, LayeredPositions &positions, int sweeps, std::span<const float> initialOrder)
+{
+    const size_t n = graph.nodeCount;
+    const uint32_t unvisited = UINT32_MAX;
+    // Directed adjacency for the layering, symmetric adjacency for the ordering
+    std::vector<uint32_t> outOffsets(n + 1, 0), outTargets(graph.edges.size());
+    for (const auto &edge : graph.edges)
+    {
+        outOffsets[edge.first + 1]++;
+    }
+    for (size_t node = 0; node < n; node++)
+    {
+        outOffsets[node + 1] += outOffsets[node];
+    }
+    std::vector<uint32_t> cursor(outOffsets.begin(), outOffsets.end() - 1);
+    for (const auto &[from, to] : graph.edges)
+    {
+        outTargets[cursor[from]++] = to;
+    }
+    std::vector<uint32_t> offsets, neighbours;
+    buildAdjacency(graph, offsets, neighbours);
+
+    // Breadth-first layering, the discovery order is the initial order within the layers
+    positions.layer.assign(n, unvisited);
+    std::vector<std::vector<uint32_t>> layers;
+    std::vector<uint32_t> queue;
+    queue.reserve(n);
+    const auto search = [&](size_t head)
+    {
+        for (; head < queue.size(); head++)
+        {
+            const uint32_t node = queue[head];
+            if (positions.layer[node] >= layers.size())
+            {
+                layers.resize(positions.layer[node] + 1);
+            }
+            layers[positions.layer[node]].push_back(node);
+            for (uint32_t i = outOffsets[node]; i < outOffsets[node + 1]; i++)
+            {
+                const uint32_t target = outTargets[i];
+                if (positions.layer[target] == unvisited)
+                {
+                    positions.layer[target] = positions.layer[node] + 1;
+                    queue.push_back(target);
+                }
+            }
+        }
+    };
+    for (const uint32_t source : sources)
+    {
+        if (positions.layer[source] == unvisited)
+        {
+            positions.layer[source] = 0;
+            queue.push_back(source);
+        }
+    }
+    search(0);
+    for (uint32_t node = 0; node < n; node++)
+    {
+        if (positions.layer[node] == unvisited)
+        {
+            positions.layer[node] = 0;
+            const size_t head = queue.size();
+            queue.push_back(node);
+            search(head);
+        }
+    }
+
+    positions.rank.assign(n, 0);
+    const auto assignRanks = [&positions](const std::vector<uint32_t> &layerNodes)
+    {
+        for (uint32_t rank = 0; rank < layerNodes.size(); rank++)
+        {
+            positions.rank[layerNodes[rank]] = rank;
+        }
+    };
+    if (!initialOrder.empty())
+    {
+        std::vector<std::pair<float, uint32_t>> starts;
+        for (auto &layerNodes : layers)
+        {
+            starts.clear();
+            for (size_t i = 0; i < layerNodes.size(); i++)
+            {
+                const float start = initialOrder[layerNodes[i]];
+                starts.emplace_back(std::isnan(start) ? (static_cast<float>(i) + 0.5f) / static_cast<float>(layerNodes.size()) : start, layerNodes[i]);
+            }
+            std::stable_sort(starts.begin(), starts.end(), [](const auto &a, const auto &b)
+            {
+                return a.first < b.first;
+            });
+            for (size_t i = 0; i < starts.size(); i++)
+            {
+                layerNodes[i] = starts[i].second;
+            }
+        }
+    }
+    for (const auto &layerNodes : layers)
+    {
+        assignRanks(layerNodes);
+    }
+    const auto totalCrossings = [&]()
+    {
+        size_t crossings = 0;
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        for (size_t layer = 0; layer + 1 < layers.size(); layer++)
+        {
+            pairs.clear();
+            for (const uint32_t node : layers[layer])
+            {
+                for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++)
+                {
+                    if (positions.layer[neighbours[i]] == layer + 1)
+                    {
+                        pairs.emplace_back(positions.rank[node], positions.rank[neighbours[i]]);
+                    }
+                }
+            }
+            crossings += countCrossings(pairs, layers[layer + 1].size());
+        }
+        return crossings;
+    };
+    // Sorts a layer by the mean relative rank of the neighbours in the fixed layer, nodes without any keep their
+    // relative rank; relative ranks (in 0 .. 1) keep layers of different sizes comparable
+    std::vector<std::pair<double, uint32_t>> keys;
+    const auto sortLayer = [&](size_t layer, size_t fixed)
+    {
+        keys.clear();
+        for (const uint32_t node : layers[layer])
+        {
+            double sum = 0;
+            uint32_t count = 0;
+            for (uint32_t i = offsets[node]; i < offsets[node + 1]; i++)
+            {
+                if (positions.layer[neighbours[i]] == fixed)
+                {
+                    sum += positions.rank[neighbours[i]] + 0.5;
+                    count++;
+                }
+            }
+            keys.emplace_back(count > 0 ? sum / count / static_cast<double>(layers[fixed].size())
+                                        : (positions.rank[node] + 0.5) / static_cast<double>(layers[layer].size()), node);
+        }
+        std::stable_sort(keys.begin(), keys.end(), [](const auto &a, const auto &b)
+        {
+            return a.first < b.first;
+        });
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            layers[layer][i] = keys[i].second;
+        }
+        assignRanks(layers[layer]);
+    };
+
+    // Sweeps don't always improve on the previous one, so the best order seen is kept
+    positions.crossings = totalCrossings();
+    std::vector<uint32_t> best = positions.rank;
+    for (int sweep = 0; sweep < sweeps && positions.crossings > 0; sweep++)
+    {
+        for (size_t layer = 1; layer < layers.size(); layer++)
+        {
+            sortLayer(layer, layer - 1);
+        }
+        for (size_t layer = layers.size() - 1; layer-- > 0;)
+        {
+            sortLayer(layer, layer + 1);
+        }
+        const size_t crossings = totalCrossings();
+        if (crossings < positions.crossings)
+        {
+            positions.crossings = crossings;
+            best = positions.rank;
+        }
+    }
+    positions.rank = std::move(best);
+    positions.layerSizes.clear();
+    for (const auto &layerNodes : layers)
+    {
+        positions.layerSizes.push_back(static_cast<uint32_t>(layerNodes.size()));
+    }
+}
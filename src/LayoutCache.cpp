@@ -0,0 +1,325 @@
+#include "../include/LayoutCache.h"
+#include "../include/FlatHash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <thread>
+
+/// @brief Fixed-size start of a cache file, followed by the key lengths (uint32), the key bytes and the x and y arrays.
+struct LayoutCacheHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t fingerprint;
+    uint64_t nodeCount;
+    uint64_t keyBytes;
+};
+
+/// @brief Feeds bytes into an FNV-1a hash.
+static void hashBytes(uint64_t &hash, const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+uint64_t graphFingerprint(const LayoutGraph &graph, const std::vector<std::string> &keys, std::string_view kind)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hashBytes(hash, kind.data(), kind.size());
+    const uint64_t nodeCount = graph.nodeCount;
+    hashBytes(hash, &nodeCount, sizeof(nodeCount));
+    for (const std::string &key : keys)
+    {
+        // The length keeps "ab", "c" apart from "a", "bc"
+        const auto length = static_cast<uint32_t>(key.size());
+        hashBytes(hash, &length, sizeof(length));
+        hashBytes(hash, key.data(), key.size());
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> edges = graph.edges;
+    std::sort(edges.begin(), edges.end());
+    for (const auto &[from, to] : edges)
+    {
+        hashBytes(hash, &from, sizeof(from));
+        hashBytes(hash, &to, sizeof(to));
+    }
+    return mixHash(hash);
+}
+
+/// @brief Reads a cache file, checking its header.
+/// @return (bool) False if the file is missing, damaged or holds another graph.
+static bool readEntry(const std::filesystem::path &path, uint64_t fingerprint, std::vector<std::string> &keys, LayoutPositions &positions)
+{
+    std::ifstream file(path, std::ios::binary);
+    LayoutCacheHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, LAYOUT_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LAYOUT_CACHE_VERSION || header.fingerprint != fingerprint)
+    {
+        return false;
+    }
+    // Sizes are checked against the file before anything is allocated
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error || header.nodeCount > fileSize || header.keyBytes > fileSize ||
+        sizeof(header) + header.nodeCount * (sizeof(uint32_t) + 2 * sizeof(float)) + header.keyBytes != fileSize)
+    {
+        return false;
+    }
+    const auto nodeCount = static_cast<size_t>(header.nodeCount);
+    std::vector<uint32_t> lengths(nodeCount);
+    std::string characters(static_cast<size_t>(header.keyBytes), '\0');
+    positions.x.resize(nodeCount);
+    positions.y.resize(nodeCount);
+    file.read(reinterpret_cast<char *>(lengths.data()), static_cast<std::streamsize>(nodeCount * sizeof(uint32_t)));
+    file.read(characters.data(), static_cast<std::streamsize>(characters.size()));
+    file.read(reinterpret_cast<char *>(positions.x.data()), static_cast<std::streamsize>(nodeCount * sizeof(float)));
+    file.read(reinterpret_cast<char *>(positions.y.data()), static_cast<std::streamsize>(nodeCount * sizeof(float)));
+    if (!file)
+    {
+        return false;
+    }
+    const auto finite = [](float value) { return std::isfinite(value); };
+    if (!std::all_of(positions.x.begin(), positions.x.end(), finite) || !std::all_of(positions.y.begin(), positions.y.end(), finite))
+    {
+        return false;
+    }
+    keys.resize(nodeCount);
+    size_t offset = 0;
+    for (size_t node = 0; node < nodeCount; node++)
+    {
+        if (lengths[node] > characters.size() - offset)
+        {
+            return false;
+        }
+        keys[node].assign(characters, offset, lengths[node]);
+        offset += lengths[node];
+    }
+    return offset == characters.size();
+}
+
+/// @brief Writes a file under a name no other thread or process uses and renames it into place, so readers never
+/// see half a file and concurrent writers of the same entry don't mix their bytes.
+/// @param write Writes the contents, returns false on failure.
+template <typename Write>
+static void replaceFile(const std::filesystem::path &path, const Write &write)
+{
+    static const uint64_t process = (static_cast<uint64_t>(std::random_device()()) << 32) ^ std::random_device()();
+    static std::atomic<uint64_t> counter = 0;
+    const uint64_t unique = mixHash(process ^ mixHash(std::hash<std::thread::id>()(std::this_thread::get_id()) + counter++));
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp", static_cast<unsigned long long>(unique));
+    std::filesystem::path temporary = path;
+    temporary += suffix;
+    std::error_code error;
+    bool written;
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        written = write(file) && file.flush();
+    }
+    if (!written)
+    {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+std::string defaultLayoutCacheDirectory()
+{
+    for (const char *variable : {"XDG_CACHE_HOME", "LOCALAPPDATA"})
+    {
+        const char *value = std::getenv(variable);
+        if (value != nullptr && *value != '\0')
+        {
+            return (std::filesystem::path(value) / LAYOUT_CACHE_DIRECTORY).string();
+        }
+    }
+    const char *home = std::getenv("HOME");
+    if (home != nullptr && *home != '\0')
+    {
+        return (std::filesystem::path(home) / ".cache" / LAYOUT_CACHE_DIRECTORY).string();
+    }
+    std::error_code error;
+    const std::filesystem::path temporary = std::filesystem::temp_directory_path(error);
+    return error ? std::string() : (temporary / LAYOUT_CACHE_DIRECTORY).string();
+}
+
+LayoutCache::LayoutCache(const std::string &directory, uintmax_t maxBytes) : directory(directory), maxBytes(maxBytes)
+{
+}
+
+bool LayoutCache::enabled() const
+{
+    return !directory.empty();
+}
+
+std::filesystem::path LayoutCache::entryPath(uint64_t fingerprint) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.layout", static_cast<unsigned long long>(fingerprint));
+    return directory / name;
+}
+
+std::filesystem::path LayoutCache::drawingPath(const std::string &drawing) const
+{
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(drawing, error);
+    const std::string name = error ? drawing : absolute.lexically_normal().string();
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hashBytes(hash, name.data(), name.size());
+    char file[32];
+    std::snprintf(file, sizeof(file), "%016llx.last", static_cast<unsigned long long>(mixHash(hash)));
+    return directory / file;
+}
+
+bool LayoutCache::find(uint64_t fingerprint, const std::vector<std::string> &keys, LayoutPositions &positions) const
+{
+    if (!enabled())
+    {
+        return false;
+    }
+    std::vector<std::string> cachedKeys;
+    LayoutPositions cached;
+    const std::filesystem::path path = entryPath(fingerprint);
+    if (!readEntry(path, fingerprint, cachedKeys, cached) || cachedKeys != keys)
+    {
+        return false;
+    }
+    // A hit counts as a use, trim() drops the oldest files first
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    positions = std::move(cached);
+    return true;
+}
+
+size_t LayoutCache::warmStart(const std::string &drawing, const std::vector<std::string> &keys, LayoutPositions &positions, std::vector<bool> &known) const
+{
+    known.assign(keys.size(), false);
+    positions.x.assign(keys.size(), 0);
+    positions.y.assign(keys.size(), 0);
+    if (!enabled())
+    {
+        return 0;
+    }
+    uint64_t fingerprint = 0;
+    std::ifstream last(drawingPath(drawing), std::ios::binary);
+    std::vector<std::string> cachedKeys;
+    LayoutPositions cached;
+    if (!last.read(reinterpret_cast<char *>(&fingerprint), sizeof(fingerprint)) || !readEntry(entryPath(fingerprint), fingerprint, cachedKeys, cached))
+    {
+        return 0;
+    }
+    FlatHashMap<std::string_view, uint32_t> cachedNodes;
+    cachedNodes.reserve(cachedKeys.size());
+    for (uint32_t node = 0; node < cachedKeys.size(); node++)
+    {
+        cachedNodes.emplace(cachedKeys[node], node);
+    }
+    size_t matched = 0;
+    for (size_t node = 0; node < keys.size(); node++)
+    {
+        const auto entry = cachedNodes.find(keys[node]);
+        if (entry != cachedNodes.end())
+        {
+            positions.x[node] = cached.x[entry->second];
+            positions.y[node] = cached.y[entry->second];
+            known[node] = true;
+            matched++;
+        }
+    }
+    return matched;
+}
+
+void LayoutCache::store(const std::string &drawing, uint64_t fingerprint, const std::vector<std::string> &keys, const LayoutPositions &positions) const
+{
+    if (!enabled())
+    {
+        return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    LayoutCacheHeader header{};
+    std::memcpy(header.magic, LAYOUT_CACHE_MAGIC, sizeof(header.magic));
+    header.version = LAYOUT_CACHE_VERSION;
+    header.fingerprint = fingerprint;
+    header.nodeCount = keys.size();
+    std::vector<uint32_t> lengths;
+    lengths.reserve(keys.size());
+    for (const std::string &key : keys)
+    {
+        lengths.push_back(static_cast<uint32_t>(key.size()));
+        header.keyBytes += key.size();
+    }
+    replaceFile(entryPath(fingerprint), [&](std::ofstream &file)
+                {
+                    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                    file.write(reinterpret_cast<const char *>(lengths.data()), static_cast<std::streamsize>(lengths.size() * sizeof(uint32_t)));
+                    for (const std::string &key : keys)
+                    {
+                        file.write(key.data(), static_cast<std::streamsize>(key.size()));
+                    }
+                    file.write(reinterpret_cast<const char *>(positions.x.data()), static_cast<std::streamsize>(positions.x.size() * sizeof(float)));
+                    file.write(reinterpret_cast<const char *>(positions.y.data()), static_cast<std::streamsize>(positions.y.size() * sizeof(float)));
+                    return static_cast<bool>(file);
+                });
+    replaceFile(drawingPath(drawing), [&](std::ofstream &file)
+                { return static_cast<bool>(file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint))); });
+    trim();
+}
+
+void LayoutCache::trim() const
+{
+    // Only the cache's own files are counted and removed, whatever else lives in the directory stays
+    std::error_code error;
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+    uintmax_t total = 0;
+    for (std::filesystem::directory_iterator entry(directory, error), end; !error && entry != end; entry.increment(error))
+    {
+        const std::filesystem::path extension = entry->path().extension();
+        if (extension != ".layout" && extension != ".last")
+        {
+            continue;
+        }
+        std::error_code statusError;
+        const uintmax_t size = entry->file_size(statusError);
+        const auto time = entry->last_write_time(statusError);
+        if (!statusError)
+        {
+            total += size;
+            files.emplace_back(time, entry->path());
+        }
+    }
+    if (total <= maxBytes)
+    {
+        return;
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto &[time, path] : files)
+    {
+        if (total <= maxBytes)
+        {
+            break;
+        }
+        const uintmax_t size = std::filesystem::file_size(path, error);
+        if (!error && std::filesystem::remove(path, error))
+        {
+            total -= size;
+        }
+    }
+}
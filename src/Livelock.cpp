@@ -0,0 +1,203 @@
+#include "../include/Livelock.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+/// @brief State being expanded by the depth-first search.
+struct SearchFrame
+{
+    StateId state;
+    TransitionId transition = 0; // Next transition to try
+    bool enabled = false;        // Some transition was enabled
+};
+
+LivelockReport findStuckComponents(const NetView &net, std::span<const int32_t> finalMarking, bool stopAtFirst, size_t maxStates, int32_t maxTokens)
+{
+    if (!finalMarking.empty() && finalMarking.size() != net.placeCount())
+    {
+        throw std::invalid_argument("The final marking must have one entry per place");
+    }
+    LivelockReport report{{}, MarkingStore(net.placeCount())};
+    MarkingStore &store = report.markings;
+    // States get their ids in depth-first discovery order, which makes the id Tarjan's index
+    std::vector<StateId> low;
+    std::vector<uint32_t> componentOf; // INVALID_ID while the state is on the stack
+    std::vector<bool> leaves;          // An edge goes to a closed component (or was cut off by the state limit)
+    std::vector<StateId> stack;
+    std::vector<SearchFrame> frames;
+    uint32_t componentCount = 0;
+    const auto visit = [&](StateId state)
+    {
+        low.push_back(state);
+        componentOf.push_back(INVALID_ID);
+        leaves.push_back(false);
+        stack.push_back(state);
+        frames.push_back({state});
+    };
+
+    std::vector<int32_t> next(net.placeCount());
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        next[place] = net.places[place].tokens;
+    }
+    store.insert(next);
+    visit(0);
+    if (maxTokens != 0 && std::any_of(next.begin(), next.end(), [maxTokens](int32_t tokens) { return tokens > maxTokens; }))
+    {
+        frames.clear();
+        report.exceededTokens = true;
+        report.complete = false;
+    }
+    while (!frames.empty())
+    {
+        SearchFrame &frame = frames.back();
+        const StateId state = frame.state;
+        const auto marking = store[state];
+        for (; frame.transition < net.transitionCount(); frame.transition++)
+        {
+            const auto inputs = net.preset(frame.transition);
+            const auto inputWeights = net.presetWeights(frame.transition);
+            bool enabled = true;
+            for (size_t i = 0; i < inputs.size() && enabled; i++)
+            {
+                enabled = marking[inputs[i]] >= static_cast<int32_t>(inputWeights[i]);
+            }
+            if (enabled)
+            {
+                break;
+            }
+        }
+        if (frame.transition < net.transitionCount())
+        {
+            const TransitionId transition = frame.transition++;
+            frame.enabled = true;
+            std::copy(marking.begin(), marking.end(), next.begin());
+            const auto inputs = net.preset(transition);
+            const auto inputWeights = net.presetWeights(transition);
+            for (size_t i = 0; i < inputs.size(); i++)
+            {
+                next[inputs[i]] -= static_cast<int32_t>(inputWeights[i]);
+            }
+            const auto outputs = net.postset(transition);
+            const auto outputWeights = net.postsetWeights(transition);
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                next[outputs[i]] += static_cast<int32_t>(outputWeights[i]);
+            }
+            // Only the outputs gained tokens, the caller wants nothing after the first marking over the bound
+            if (maxTokens != 0 && std::any_of(outputs.begin(), outputs.end(), [&](PlaceId place) { return next[place] > maxTokens; }))
+            {
+                store.insert(next);
+                report.exceededTokens = true;
+                report.complete = false;
+                break;
+            }
+            StateId successor;
+            bool inserted = false;
+            if (maxStates != 0 && store.size() >= maxStates)
+            {
+                successor = store.find(next);
+                if (successor == INVALID_ID)
+                {
+                    leaves[state] = true;
+                    report.complete = false;
+                    continue;
+                }
+            }
+            else
+            {
+                std::tie(successor, inserted) = store.insert(next);
+            }
+            if (inserted)
+            {
+                visit(successor);
+            }
+            else if (componentOf[successor] == INVALID_ID)
+            {
+                low[state] = std::min(low[state], successor);
+            }
+            else
+            {
+                leaves[state] = true;
+            }
+            continue;
+        }
+
+        // Every successor is done, close the component if the state is its root
+        const bool enabled = frame.enabled;
+        frames.pop_back();
+        if (low[state] == state)
+        {
+            // The stack holds states in increasing id order, the component is the part from state on
+            const auto first = std::lower_bound(stack.begin(), stack.end(), state);
+            bool bottom = true;
+            bool containsFinal = false;
+            for (auto member = first; member != stack.end(); ++member)
+            {
+                componentOf[*member] = componentCount;
+                bottom = bottom && !leaves[*member];
+                const auto tokens = store[*member];
+                containsFinal = containsFinal || (!finalMarking.empty() && std::equal(tokens.begin(), tokens.end(), finalMarking.begin()));
+            }
+            componentCount++;
+            if (bottom && !containsFinal)
+            {
+                StuckComponent component;
+                component.states.assign(first, stack.end());
+                component.deadlock = !enabled && component.states.size() == 1;
+                report.components.push_back(std::move(component));
+            }
+            stack.erase(first, stack.end());
+            if (stopAtFirst && !report.components.empty())
+            {
+                report.complete = report.complete && frames.empty();
+                break;
+            }
+        }
+        if (!frames.empty())
+        {
+            const StateId parent = frames.back().state;
+            low[parent] = std::min(low[parent], low[state]);
+            if (componentOf[state] != INVALID_ID)
+            {
+                leaves[parent] = true;
+            }
+        }
+    }
+    report.states = store.size();
+    return report;
+}
+
+std::vector<StuckComponent> findStuckComponents(const ReachabilityGraph &graph)
+{
+    const StronglyConnectedComponents scc = graph.components();
+    // A component no edge leaves is stuck unless one of its states is final or lost successors
+    std::vector<bool> stuck = scc.bottom;
+    std::vector<std::vector<StateId>> members(scc.count);
+    for (StateId state = 0; state < graph.stateCount(); state++)
+    {
+        const uint32_t component = scc.componentOf[state];
+        if ((graph.flags(state) & (STATE_FINAL | STATE_TRUNCATED)) != 0)
+        {
+            stuck[component] = false;
+        }
+        if (stuck[component])
+        {
+            members[component].push_back(state);
+        }
+    }
+    std::vector<StuckComponent> components;
+    for (uint32_t component = 0; component < scc.count; component++)
+    {
+        if (!stuck[component])
+        {
+            continue;
+        }
+        StuckComponent found;
+        found.states = std::move(members[component]);
+        found.deadlock = found.states.size() == 1 && (graph.flags(found.states.front()) & STATE_DEADLOCK) != 0;
+        components.push_back(std::move(found));
+    }
+    return components;
+}
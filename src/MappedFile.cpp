@@ -0,0 +1,116 @@
+#include "../include/MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// @brief Maps a file into memory.
+/// @param path Path of the file to map.
+/// @param sequential Hint that the file is read front to back once, enables aggressive read-ahead.
+MappedFile::MappedFile(const std::string &path, [[maybe_unused]] bool sequential)
+{
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't open " + path);
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+    bytes = buffer.data();
+    length = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Can't open " + path);
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Can't stat " + path);
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0)
+    {
+        void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Can't map " + path);
+        }
+        if (sequential)
+        {
+            ::madvise(mapping, length, MADV_SEQUENTIAL);
+        }
+        bytes = static_cast<const char *>(mapping);
+    }
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    release();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+#ifdef _WIN32
+        buffer = std::move(other.buffer);
+        bytes = buffer.data();
+#else
+        bytes = other.bytes;
+#endif
+        length = other.length;
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+    return *this;
+}
+
+const char *MappedFile::data() const
+{
+    return bytes;
+}
+
+size_t MappedFile::size() const
+{
+    return length;
+}
+
+std::string_view MappedFile::view() const
+{
+    return {bytes, length};
+}
+
+void MappedFile::release()
+{
+#ifndef _WIN32
+    if (bytes != nullptr)
+    {
+        ::munmap(const_cast<char *>(bytes), length);
+    }
+#endif
+    bytes = nullptr;
+    length = 0;
+}
@@ -0,0 +1,123 @@
+#include "../include/NameTable.h"
+#include "../include/FlatHash.h"
+
+/// @brief Hashes a name (FNV-1a followed by a bit mixer).
+static size_t hashName(std::string_view name)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char c : name)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return static_cast<size_t>(mixHash(hash));
+}
+
+NameId NameTable::intern(std::string_view name)
+{
+    const size_t hash = hashName(name);
+    if (!slots.empty())
+    {
+        size_t mask = slots.size() - 1;
+        size_t index = hash & mask;
+        while (slots[index].first != INVALID_ID)
+        {
+            if (slots[index].second == static_cast<uint32_t>(hash) && this->name(slots[index].first) == name)
+            {
+                return slots[index].first;
+            }
+            index = (index + 1) & mask;
+        }
+    }
+    const auto id = static_cast<NameId>(size());
+    characters.append(name);
+    boundaries.push_back(static_cast<uint32_t>(characters.size()));
+    if (size() * 2 > slots.size())
+    {
+        rehash(slots.empty() ? 16 : slots.size() * 2);
+    }
+    size_t mask = slots.size() - 1;
+    size_t index = hash & mask;
+    while (slots[index].first != INVALID_ID)
+    {
+        index = (index + 1) & mask;
+    }
+    slots[index] = {id, static_cast<uint32_t>(hash)};
+    return id;
+}
+
+NameId NameTable::find(std::string_view name) const
+{
+    if (slots.empty())
+    {
+        return INVALID_ID;
+    }
+    const size_t hash = hashName(name);
+    size_t mask = slots.size() - 1;
+    size_t index = hash & mask;
+    while (slots[index].first != INVALID_ID)
+    {
+        if (slots[index].second == static_cast<uint32_t>(hash) && this->name(slots[index].first) == name)
+        {
+            return slots[index].first;
+        }
+        index = (index + 1) & mask;
+    }
+    return INVALID_ID;
+}
+
+std::string_view NameTable::name(NameId id) const
+{
+    return std::string_view(characters).substr(boundaries[id], boundaries[id + 1] - boundaries[id]);
+}
+
+std::string_view NameTable::pool() const
+{
+    return characters;
+}
+
+std::span<const uint32_t> NameTable::offsets() const
+{
+    return boundaries;
+}
+
+size_t NameTable::size() const
+{
+    return boundaries.size() - 1;
+}
+
+void NameTable::reserve(size_t names, size_t characterCount)
+{
+    characters.reserve(characterCount);
+    boundaries.reserve(names + 1);
+    size_t capacity = slots.empty() ? 16 : slots.size();
+    while (capacity / 2 < names)
+    {
+        capacity *= 2;
+    }
+    if (capacity > slots.size())
+    {
+        rehash(capacity);
+    }
+}
+
+void NameTable::rehash(size_t capacity)
+{
+    std::vector<std::pair<NameId, uint32_t>> old(capacity, {INVALID_ID, 0});
+    old.swap(slots);
+    size_t mask = capacity - 1;
+    // Slots keep the low 32 bits of the hash, enough to place them in any table that fits in memory
+    for (const auto &slot : old)
+    {
+        if (slot.first == INVALID_ID)
+        {
+            continue;
+        }
+        size_t index = slot.second & mask;
+        while (slots[index].first != INVALID_ID)
+        {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+}
@@ -0,0 +1,359 @@
+#include "../include/NetLoader.h"
+#include "../include/BinaryNet.h"
+#include "../include/FlatHash.h"
+#include "../include/MappedFile.h"
+#include "../include/PetriNetBuilder.h"
+#include "../include/Pnml.h"
+
+#include <charconv>
+#include <filesystem>
+#include <vector>
+
+NetParseError::NetParseError(const std::string &source, size_t line, size_t column, const std::string &message)
+    : std::runtime_error(source + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message),
+      line_(line), column_(column)
+{
+}
+
+size_t NetParseError::line() const
+{
+    return line_;
+}
+
+size_t NetParseError::column() const
+{
+    return column_;
+}
+
+/// @brief Tokenizer over the pnN.txt format, yields views into the input and tracks line/column.
+class NetTokenizer
+{
+public:
+    NetTokenizer(std::string_view text, const std::string &source) : text(text), source(source)
+    {
+    }
+
+    /// @brief Reads a non-negative integer token, written without sign or leading zeros.
+    /// @param what Description used in the error message.
+    int readInt(const char *what)
+    {
+        skipWhitespace();
+        const size_t line = currentLine, column = currentColumn;
+        std::string_view token = readToken();
+        if (!token.empty() && token[0] == '-')
+        {
+            throw NetParseError(source, line, column, std::string("expected ") + what + ", found a negative number");
+        }
+        if (token.size() > 1 && token[0] == '0')
+        {
+            throw NetParseError(source, line, column, std::string("expected ") + what + " without leading zeros");
+        }
+        int value = 0;
+        auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || error != std::errc() || end != token.data() + token.size())
+        {
+            throw NetParseError(source, line, column, std::string("expected ") + what);
+        }
+        return value;
+    }
+
+    /// @brief Reads the rest of the line after skipping leading whitespace, trailing whitespace is trimmed.
+    /// Records its position for error reporting like readWord.
+    std::string_view readLine(const char *what)
+    {
+        skipWhitespace();
+        tokenLine = currentLine;
+        tokenColumn = currentColumn;
+        if (position == text.size())
+        {
+            fail(std::string("expected ") + what);
+        }
+        const size_t start = position;
+        while (position < text.size() && text[position] != '\n')
+        {
+            advance();
+        }
+        std::string_view line = text.substr(start, position - start);
+        while (!line.empty() && (line.back() == ' ' || line.back() == '\t' || line.back() == '\r'))
+        {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    /// @brief Reads the next whitespace separated token, records its position for error reporting.
+    std::string_view readWord(const char *what)
+    {
+        skipWhitespace();
+        tokenLine = currentLine;
+        tokenColumn = currentColumn;
+        std::string_view token = readToken();
+        if (token.empty())
+        {
+            fail(std::string("expected ") + what);
+        }
+        return token;
+    }
+
+    /// @brief Number of characters not read yet.
+    size_t remaining() const
+    {
+        return text.size() - position;
+    }
+
+    /// @brief Throws an error at the position of the last word.
+    [[noreturn]] void failAtWord(const std::string &message) const
+    {
+        throw NetParseError(source, tokenLine, tokenColumn, message);
+    }
+
+    /// @brief Throws an error at the current position.
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw NetParseError(source, currentLine, currentColumn, message);
+    }
+
+private:
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    void advance()
+    {
+        if (text[position] == '\n')
+        {
+            currentLine++;
+            currentColumn = 1;
+        }
+        else
+        {
+            currentColumn++;
+        }
+        position++;
+    }
+
+    void skipWhitespace()
+    {
+        while (position < text.size() && isSpace(text[position]))
+        {
+            advance();
+        }
+    }
+
+    std::string_view readToken()
+    {
+        const size_t start = position;
+        while (position < text.size() && !isSpace(text[position]))
+        {
+            advance();
+        }
+        return text.substr(start, position - start);
+    }
+
+    std::string_view text;
+    const std::string &source;
+    size_t position = 0;
+    size_t currentLine = 1, currentColumn = 1;
+    size_t tokenLine = 1, tokenColumn = 1;
+};
+
+/// @brief Parses a 1-based index following a one letter prefix (p3, t12), written without leading zeros like the
+/// numbers read by NetTokenizer::readInt.
+/// @return (uint32_t) The index, 0 if the token isn't a valid number.
+static uint32_t parseIndex(std::string_view token)
+{
+    if (token.size() < 2 || token[1] == '0')
+    {
+        return 0;
+    }
+    uint32_t value = 0;
+    auto [end, error] = std::from_chars(token.data() + 1, token.data() + token.size(), value);
+    if (error != std::errc() || end != token.data() + token.size())
+    {
+        return 0;
+    }
+    return value;
+}
+
+/// @brief Parses a net in the pnN.txt format.
+/// Places are named i, p1 .. pN-2, o and transitions are referred to as t1 .. tM, references are
+/// resolved straight to indices without name lookups.
+/// @param text Contents of the file.
+/// @param source Name reported in error messages.
+/// @return (PetriNet) Finalized Petri net.
+PetriNet parseNet(std::string_view text, const std::string &source)
+{
+    NetTokenizer tokenizer(text, source);
+
+    const int placeCount = tokenizer.readInt("the number of places");
+    if (placeCount < 2)
+    {
+        tokenizer.fail("The number of places must be at least 2");
+    }
+    // Every count below is checked against the rest of the file before it sizes anything, each entry takes at least
+    // one character, so a corrupt header fails here instead of allocating for entries that aren't there
+    if (static_cast<size_t>(placeCount) > tokenizer.remaining())
+    {
+        tokenizer.fail("The file is too short for " + std::to_string(placeCount) + " places");
+    }
+    std::vector<int> tokens(placeCount);
+    tokens[0] = tokenizer.readInt("the number of tokens of the initial place");
+    tokens[placeCount - 1] = tokenizer.readInt("the number of tokens of the output place");
+    for (int i = 1; i < placeCount - 1; i++)
+    {
+        tokens[i] = tokenizer.readInt("a number of tokens");
+    }
+
+    const int transitionCount = tokenizer.readInt("the number of transitions");
+    if (transitionCount < 1)
+    {
+        tokenizer.fail("The number of transitions must be at least 1");
+    }
+    if (static_cast<size_t>(transitionCount) > tokenizer.remaining())
+    {
+        tokenizer.fail("The file is too short for " + std::to_string(transitionCount) + " transitions");
+    }
+    std::vector<std::string_view> transitionNames(transitionCount);
+    FlatHashSet<std::string_view> seenNames;
+    seenNames.reserve(transitionCount);
+    for (auto &name : transitionNames)
+    {
+        name = tokenizer.readLine("a transition name");
+        if (!seenNames.insert(name))
+        {
+            tokenizer.failAtWord("Duplicate transition " + std::string(name));
+        }
+    }
+
+    const int arcCount = tokenizer.readInt("the number of arcs");
+    if (arcCount < 1)
+    {
+        tokenizer.fail("The number of arcs must be at least 1");
+    }
+    if (static_cast<size_t>(arcCount) > tokenizer.remaining())
+    {
+        tokenizer.fail("The file is too short for " + std::to_string(arcCount) + " arcs");
+    }
+
+    PetriNetBuilder builder(placeCount, transitionCount, arcCount);
+    std::vector<PlaceSpec> places(placeCount);
+    std::vector<char> placeNames(static_cast<size_t>(placeCount) * 12);
+    for (int i = 0; i < placeCount; i++)
+    {
+        char *name = placeNames.data() + static_cast<size_t>(i) * 12;
+        size_t length = 1;
+        if (i == 0 || i == placeCount - 1)
+        {
+            name[0] = i == 0 ? 'i' : 'o';
+        }
+        else
+        {
+            name[0] = 'p';
+            length = std::to_chars(name + 1, name + 12, i).ptr - name;
+        }
+        places[i] = {std::string_view(name, length), tokens[i]};
+    }
+    builder.addPlaces(places);
+    builder.addTransitions(transitionNames);
+
+    // Resolves an arc endpoint; places are 0 .. placeCount-1, transitions are tagged by the return flag
+    auto resolve = [&](std::string_view token, bool &isPlace) -> uint32_t
+    {
+        isPlace = true;
+        if (token == "i")
+        {
+            return 0;
+        }
+        if (token == "o")
+        {
+            return placeCount - 1;
+        }
+        uint32_t index = parseIndex(token);
+        if (token[0] == 'p' && index >= 1 && index <= static_cast<uint32_t>(placeCount - 2))
+        {
+            return index;
+        }
+        if (token[0] == 't' && index >= 1 && index <= static_cast<uint32_t>(transitionCount))
+        {
+            isPlace = false;
+            return index - 1;
+        }
+        tokenizer.failAtWord("The place or transition " + std::string(token) + " does not exist");
+    };
+
+    std::vector<Edge> arcs(arcCount);
+    for (auto &arc : arcs)
+    {
+        bool firstIsPlace, secondIsPlace;
+        uint32_t first = resolve(tokenizer.readWord("the source of an arc"), firstIsPlace);
+        uint32_t second = resolve(tokenizer.readWord("the target of an arc"), secondIsPlace);
+        if (firstIsPlace == secondIsPlace)
+        {
+            tokenizer.failAtWord(firstIsPlace ? "Both are places" : "Both are transitions");
+        }
+        arc = {first, second, firstIsPlace ? ArcDirection::PlaceToTransition : ArcDirection::TransitionToPlace};
+    }
+    builder.addArcs(arcs);
+    return builder.build();
+}
+
+/// @brief Memory-maps a net file in the pnN.txt format and parses it.
+/// @param path Path of the file.
+/// @return (PetriNet) Finalized Petri net.
+PetriNet loadNetFromFile(const std::string &path)
+{
+    MappedFile file(path);
+    return parseNet(file.view(), path);
+}
+
+/// @brief Loads a net, picking the format from the file extension (.pnml for PNML, .pnb for the binary format,
+/// the pnN.txt format otherwise). A binary net is copied out of the mapping, since the caller gets a net it can fire
+/// and edit, use LoadedNet to read one in place.
+/// @param path Path of the file.
+/// @param layout If not null, receives the positions stored in the file (PNML only).
+/// @return (PetriNet) Finalized Petri net.
+PetriNet loadNet(const std::string &path, NetLayout *layout)
+{
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension == ".pnml")
+    {
+        return loadPnml(path, layout);
+    }
+    if (extension == ".pnb")
+    {
+        MappedNet mapped(path);
+        mapped.verify();
+        return netFromView(mapped.view());
+    }
+    return loadNetFromFile(path);
+}
+
+/// @brief Loads a net like loadNet, a binary net is verified and then read straight from the mapping.
+/// @param path Path of the file.
+LoadedNet::LoadedNet(const std::string &path)
+{
+    if (std::filesystem::path(path).extension() == ".pnb")
+    {
+        mapped.emplace(path);
+        mapped->verify();
+        netView = mapped->view();
+    }
+    else
+    {
+        net = loadNet(path);
+        netView = net.view();
+    }
+}
+
+const NetView &LoadedNet::view() const
+{
+    return netView;
+}
+
+/// @brief Checks whether a file has an extension loadNet understands.
+bool isNetFile(const std::string &path)
+{
+    const std::string extension = std::filesystem::path(path).extension().string();
+    return extension == ".txt" || extension == ".pnml" || extension == ".pnb";
+}
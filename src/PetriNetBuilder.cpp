@@ -0,0 +1,83 @@
+#include "../include/PetriNetBuilder.h"
+
+#include <stdexcept>
+#include <string>
+
+PetriNetBuilder::PetriNetBuilder(size_t placeCount, size_t transitionCount, size_t arcCount)
+{
+    reserve(placeCount, transitionCount, arcCount);
+}
+
+/// @brief Reserves capacity for the expected size of the net.
+/// @param placeCount Expected number of places.
+/// @param transitionCount Expected number of transitions.
+/// @param arcCount Expected number of arcs.
+void PetriNetBuilder::reserve(size_t placeCount, size_t transitionCount, size_t arcCount)
+{
+    net.reserve(placeCount, transitionCount, arcCount);
+}
+
+/// @brief Adds a batch of places.
+/// @param places Places to add, names must be unique.
+/// @return (PlaceId) Index of the first added place, the batch occupies consecutive indices.
+PlaceId PetriNetBuilder::addPlaces(std::span<const PlaceSpec> places)
+{
+    const auto first = static_cast<PlaceId>(net.getPlaces().size());
+    for (const auto &place : places)
+    {
+        if (!net.addPlace(place.name, place.tokens))
+        {
+            throw std::invalid_argument("Duplicate place " + std::string(place.name));
+        }
+    }
+    return first;
+}
+
+/// @brief Adds a batch of transitions.
+/// @param names Transition names, must be unique.
+/// @return (TransitionId) Index of the first added transition, the batch occupies consecutive indices.
+TransitionId PetriNetBuilder::addTransitions(std::span<const std::string_view> names)
+{
+    const auto first = static_cast<TransitionId>(net.getTransitions().size());
+    for (const auto &name : names)
+    {
+        if (!net.addTransition(name))
+        {
+            throw std::invalid_argument("Duplicate transition " + std::string(name));
+        }
+    }
+    return first;
+}
+
+/// @brief Adds a batch of arcs, duplicates are skipped in O(1) each.
+/// @param arcs Arcs to add, indices are checked when the net is built.
+/// @return (size_t) Number of arcs that were actually added.
+size_t PetriNetBuilder::addArcs(std::span<const Edge> arcs)
+{
+    size_t added = 0;
+    for (const auto &arc : arcs)
+    {
+        added += net.addArc(arc.from, arc.to, arc.direction, arc.weight);
+    }
+    return added;
+}
+
+size_t PetriNetBuilder::placeCount() const
+{
+    return net.getPlaces().size();
+}
+
+size_t PetriNetBuilder::transitionCount() const
+{
+    return net.getTransitions().size();
+}
+
+/// @brief Finalizes and returns the net, the builder is left empty.
+/// @return (PetriNet) Finalized Petri net.
+PetriNet PetriNetBuilder::build()
+{
+    net.finalize();
+    PetriNet result = std::move(net);
+    net = PetriNet();
+    return result;
+}
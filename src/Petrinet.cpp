@@ -1,64 +1,193 @@
 #include "../include/Petrinet.h"
 
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
 PetriNet::PetriNet() = default;
 
 /// @brief Adds a place to the Petri net.
-/// @param place Place to add.
+/// @param name Name of the place, interned into the net's name table.
+/// @param tokens Initial number of tokens.
 /// @return (Bool) True if the place was added, false if the place already exists.
-bool PetriNet::addPlace(Place &place) {
-    if (placeMap.find(place.name) != placeMap.end()) {
+bool PetriNet::addPlace(std::string_view name, int tokens) {
+    NameId id = names.intern(name);
+    if (placeMap.count(id)) {
         return false;
     }
-    places.push_back(place);
-    placeMap[place.name] = static_cast<int>(places.size()) - 1;
+    places.emplace_back(id, tokens);
+    placeMap.emplace(id, static_cast<PlaceId>(places.size() - 1));
+    finalized = false;
     return true;
 }
 
 /// @brief Adds a transition to the Petri net.
-/// @param transition Transition to add.
+/// @param name Name of the transition, interned into the net's name table.
 /// @return (Bool) True if the transition was added, false if the transition already exists.
-bool PetriNet::addTransition(const Transition &transition) {
-    if (transitionMap.find(transition.name) != transitionMap.end()) {
+bool PetriNet::addTransition(std::string_view name) {
+    NameId id = names.intern(name);
+    if (transitionMap.count(id)) {
         return false;
     }
-    transitions.push_back(transition);
-    transitionMap[transition.name] = static_cast<int>(transitions.size()) - 1;
-    reverseTransitionMap["t" + std::to_string(static_cast<int>(transitions.size()))] = transition;
+    transitions.emplace_back(id);
+    transitionMap.emplace(id, static_cast<TransitionId>(transitions.size() - 1));
+    finalized = false;
     return true;
 }
 
 /// @brief Adds an arc to the Petri net.
-/// @param place Place that the arc originates from.
-/// @param transition Transition that the arc goes to.
+/// @param from Index of the place (PlaceToTransition) or transition (TransitionToPlace) the arc originates from.
+/// @param to Index of the transition (PlaceToTransition) or place (TransitionToPlace) the arc goes to.
+/// @param direction Direction of the arc.
+/// @param weight Number of tokens the arc consumes or produces.
 /// @return (Bool) True if the arc was added, false if the arc already exists.
-bool PetriNet::addArc(const Place &place, const Transition &transition) {
-    int placeIndex = placeMap[place.name];
-    int transitionIndex = transitionMap[transition.name];
-    Edge edge = {placeIndex, transitionIndex, ArcDirection::PlaceToTransition};
-    for (auto &arc : arcs) {
-        if (arc.from == edge.from && arc.to == edge.to && arc.direction == edge.direction) {
-            return false;
-        }
+bool PetriNet::addArc(uint32_t from, uint32_t to, ArcDirection direction, uint32_t weight) {
+    Edge edge = {from, to, direction, weight};
+    if (!arcSet.insert(edge)) {
+        return false;
     }
     arcs.push_back(edge);
+    finalized = false;
     return true;
 }
 
-/// @brief Adds an arc to the Petri net.
-/// @param transition Transition that the arc originates from.
-/// @param place Place that the arc goes to.
-/// @return (Bool) True if the arc was added, false if the arc already exists.
-bool PetriNet::addArc(const Transition &transition, const Place &place) {
-    int placeIndex = placeMap[place.name];
-    int transitionIndex = transitionMap[transition.name];
-    Edge edge = {transitionIndex, placeIndex, ArcDirection::TransitionToPlace};
-    for (auto &arc : arcs) {
-        if (arc.from == edge.from && arc.to == edge.to && arc.direction == edge.direction) {
-            return false;
+/// @brief Reserves capacity for the given number of places, transitions and arcs.
+void PetriNet::reserve(size_t placeCount, size_t transitionCount, size_t arcCount) {
+    places.reserve(placeCount);
+    transitions.reserve(transitionCount);
+    placeMap.reserve(placeCount);
+    transitionMap.reserve(transitionCount);
+    names.reserve(placeCount + transitionCount, 0);
+    arcs.reserve(arcCount);
+    arcSet.reserve(arcCount);
+}
+
+/// @brief Builds a CSR index with one row per source from (source, target) pairs using a counting sort.
+/// @param rows Number of rows (sources).
+/// @param arcs Arcs to index.
+/// @param direction Only arcs with this direction are indexed.
+/// @param reversed Index arcs by their target instead of their source.
+static CsrIndex buildIndex(size_t rows, const Arcs &arcs, ArcDirection direction, bool reversed) {
+    CsrIndex index;
+    index.offsets.assign(rows + 1, 0);
+    for (const auto &arc : arcs) {
+        if (arc.direction == direction) {
+            uint32_t row = reversed ? arc.to : arc.from;
+            if (row >= rows) {
+                throw std::out_of_range("Arc refers to a node that does not exist");
+            }
+            index.offsets[row + 1]++;
         }
     }
-    arcs.push_back(edge);
-    return true;
+    for (size_t i = 0; i < rows; i++) {
+        index.offsets[i + 1] += index.offsets[i];
+    }
+    index.targets.resize(index.offsets[rows]);
+    index.weights.resize(index.offsets[rows]);
+    std::vector<uint32_t> cursor(index.offsets.begin(), index.offsets.end() - 1);
+    for (const auto &arc : arcs) {
+        if (arc.direction == direction) {
+            uint32_t row = reversed ? arc.to : arc.from;
+            index.weights[cursor[row]] = arc.weight;
+            index.targets[cursor[row]++] = reversed ? arc.from : arc.to;
+        }
+    }
+    return index;
+}
+
+/// @brief Builds the place/transition incidence indices in O(V+E).
+/// Must be called after the structure is complete and before the net is explored.
+void PetriNet::finalize() {
+    for (const auto &arc : arcs) {
+        if (arc.weight == 0) {
+            throw std::invalid_argument("Arc weights must be positive");
+        }
+        const bool fromPlace = arc.direction == ArcDirection::PlaceToTransition;
+        if ((fromPlace ? arc.from : arc.to) >= places.size() || (fromPlace ? arc.to : arc.from) >= transitions.size()) {
+            throw std::out_of_range("Arc refers to a node that does not exist");
+        }
+    }
+    ordinary = std::all_of(arcs.begin(), arcs.end(), [](const Edge &arc) { return arc.weight == 1; });
+    transitionInputs = buildIndex(transitions.size(), arcs, ArcDirection::PlaceToTransition, true);
+    transitionOutputs = buildIndex(transitions.size(), arcs, ArcDirection::TransitionToPlace, false);
+    placeInputs = buildIndex(places.size(), arcs, ArcDirection::TransitionToPlace, true);
+    placeOutputs = buildIndex(places.size(), arcs, ArcDirection::PlaceToTransition, false);
+    finalized = true;
+}
+
+bool PetriNet::isFinalized() const {
+    return finalized;
+}
+
+/// @return (std::span) Input places of the transition, requires a finalized net.
+std::span<const PlaceId> PetriNet::preset(TransitionId transition) const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before querying the incidence");
+    }
+    return transitionInputs[transition];
+}
+
+/// @return (std::span) Output places of the transition, requires a finalized net.
+std::span<const PlaceId> PetriNet::postset(TransitionId transition) const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before querying the incidence");
+    }
+    return transitionOutputs[transition];
+}
+
+/// @return (std::span) Weights of the arcs of preset(transition), requires a finalized net.
+std::span<const uint32_t> PetriNet::presetWeights(TransitionId transition) const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before querying the incidence");
+    }
+    return transitionInputs.weightsOf(transition);
+}
+
+/// @return (std::span) Weights of the arcs of postset(transition), requires a finalized net.
+std::span<const uint32_t> PetriNet::postsetWeights(TransitionId transition) const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before querying the incidence");
+    }
+    return transitionOutputs.weightsOf(transition);
+}
+
+/// @return (Bool) True if every arc has weight 1, requires a finalized net.
+bool PetriNet::isOrdinary() const {
+    return ordinary;
+}
+
+/// @return (std::span) Transitions that put tokens into the place, requires a finalized net.
+std::span<const TransitionId> PetriNet::placePreset(PlaceId place) const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before querying the incidence");
+    }
+    return placeInputs[place];
+}
+
+/// @return (std::span) Transitions that take tokens from the place, requires a finalized net.
+std::span<const TransitionId> PetriNet::placePostset(PlaceId place) const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before querying the incidence");
+    }
+    return placeOutputs[place];
+}
+
+/// @return (NetView) Read-only view of the net, requires a finalized net and is invalidated by structural changes.
+NetView PetriNet::view() const {
+    if (!finalized) {
+        throw std::logic_error("PetriNet::finalize must be called before taking a view");
+    }
+    NetView view;
+    view.places = places;
+    view.transitions = transitions;
+    view.transitionInputs = transitionInputs;
+    view.transitionOutputs = transitionOutputs;
+    view.placeInputs = placeInputs;
+    view.placeOutputs = placeOutputs;
+    view.namePool = names.pool();
+    view.nameOffsets = names.offsets();
+    view.ordinary = ordinary;
+    return view;
 }
 
 const Places &PetriNet::getPlaces() const {
@@ -75,6 +204,7 @@ const Transitions &PetriNet::getTransitions() const {
 
 [[maybe_unused]] void PetriNet::setTransitions(const Transitions &t) {
     PetriNet::transitions = t;
+    finalized = false;
 }
 
 const PlaceMap &PetriNet::getPlaceMap() const {
@@ -93,26 +223,65 @@ const TransitionMap &PetriNet::getTransitionMap() const {
     PetriNet::transitionMap = t;
 }
 
-const ReverseTransitionMap &PetriNet::getReverseTransitionMap() const {
-    return reverseTransitionMap;
+const Arcs &PetriNet::getArcs() const {
+    return arcs;
+}
+
+[[maybe_unused]] void PetriNet::setArcs(const Arcs &a) {
+    PetriNet::arcs.clear();
+    arcSet.clear();
+    for (const auto &arc : a) {
+        if (arcSet.insert(arc)) {
+            PetriNet::arcs.push_back(arc);
+        }
+    }
+    finalized = false;
 }
 
-[[maybe_unused]] void PetriNet::setReverseTransitionMap(const ReverseTransitionMap &map) {
-    PetriNet::reverseTransitionMap = map;
+const NameTable &PetriNet::getNames() const {
+    return names;
 }
 
-const Arcs &PetriNet::getArcs() const {
-    return arcs;
+/// @brief Resolves a place name to its index.
+/// @return (PlaceId) Index of the place, INVALID_ID if there is no such place.
+PlaceId PetriNet::findPlace(std::string_view name) const {
+    auto it = placeMap.find(names.find(name));
+    return it == placeMap.end() ? INVALID_ID : it->second;
 }
 
-[[maybe_unused]] void PetriNet::setArcs(const Arcs &a) {
-    PetriNet::arcs = a;
+/// @brief Resolves a transition name to its index.
+/// @return (TransitionId) Index of the transition, INVALID_ID if there is no such transition.
+TransitionId PetriNet::findTransition(std::string_view name) const {
+    auto it = transitionMap.find(names.find(name));
+    return it == transitionMap.end() ? INVALID_ID : it->second;
+}
+
+/// @brief Resolves a transition label (t1, t2, ..) to its index.
+/// @return (TransitionId) Index of the transition, INVALID_ID if there is no such label.
+TransitionId PetriNet::findTransitionLabel(std::string_view label) const {
+    TransitionId number = 0;
+    if (label.size() < 2 || label[0] != 't') {
+        return INVALID_ID;
+    }
+    auto [end, error] = std::from_chars(label.data() + 1, label.data() + label.size(), number);
+    if (error != std::errc() || end != label.data() + label.size() || number < 1 || number > transitions.size()) {
+        return INVALID_ID;
+    }
+    return number - 1;
+}
+
+std::string_view PetriNet::placeName(PlaceId place) const {
+    return names.name(places[place].name);
+}
+
+std::string_view PetriNet::transitionName(TransitionId transition) const {
+    return names.name(transitions[transition].name);
 }
 
-void PetriNet::addToken(const int tokenId)  {
-    PetriNet::places[tokenId].tokens++;
+void PetriNet::addToken(const PlaceId tokenId, const int count)  {
+    PetriNet::places[tokenId].tokens += count;
 }
 
-void PetriNet::consumeToken(const int tokenId) {
-    PetriNet::places[tokenId].tokens--;
+void PetriNet::consumeToken(const PlaceId tokenId, const int count) {
+    PetriNet::places[tokenId].tokens -= count;
 }
@@ -0,0 +1,342 @@
+#include "../include/Pnml.h"
+#include "../include/XmlReader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+/// @brief Kind of PNML object being read.
+enum class PnmlObject
+{
+    None,
+    Place,
+    Transition,
+    Arc
+};
+
+/// @brief Labels of a PNML object whose <text> child is captured.
+enum class PnmlLabel
+{
+    None,
+    Name,
+    InitialMarking,
+    Inscription
+};
+
+/// @brief Parses the integer in a PNML <text> label, surrounding whitespace is ignored.
+static long long parsePnmlNumber(const std::string &text, const XmlReader &reader)
+{
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    size_t end = text.find_last_not_of(" \t\r\n");
+    long long value = 0;
+    if (begin == std::string::npos)
+    {
+        reader.fail("Expected a number");
+    }
+    auto [last, error] = std::from_chars(text.data() + begin, text.data() + end + 1, value);
+    if (error != std::errc() || last != text.data() + end + 1 || value < 0)
+    {
+        reader.fail("Expected a non-negative number, got '" + text + "'");
+    }
+    return value;
+}
+
+/// @brief Reads the first net of a PNML document (place/transition nets) with a streaming parser.
+/// Places and transitions are named after their <name> label, or their id if the label is missing or
+/// the name is already taken. Pages are flattened and tool specific data is skipped.
+/// @param input Stream positioned at the start of the document.
+/// @param layout If not null, receives the positions found in the <graphics> elements (only as many as the file has).
+/// @param source Name reported in error messages.
+/// @return (PetriNet) Finalized Petri net.
+PetriNet readPnml(std::istream &input, NetLayout *layout, const std::string &source)
+{
+    XmlReader reader(input, source);
+    PetriNet net;
+    // PNML ids are interned, each id maps to the place or transition it names
+    NameTable ids;
+    std::vector<std::pair<PnmlObject, uint32_t>> idTargets;
+    struct PendingArc
+    {
+        NameId source;
+        NameId target;
+        uint32_t weight;
+        size_t line;
+    };
+    std::vector<PendingArc> arcs;
+
+    int depth = 0, objectDepth = 0, skipDepth = 0, netDepth = 0;
+    bool netDone = false;
+    PnmlObject object = PnmlObject::None;
+    PnmlLabel label = PnmlLabel::None;
+    bool inText = false;
+    std::string id, name, arcSource, arcTarget, text;
+    long long number = 0;
+    bool hasPosition = false;
+    Node position;
+
+    auto registerId = [&](PnmlObject kind, uint32_t index)
+    {
+        NameId key = ids.intern(id);
+        if (key >= idTargets.size())
+        {
+            idTargets.resize(key + 1, {PnmlObject::None, 0});
+        }
+        if (idTargets[key].first != PnmlObject::None)
+        {
+            reader.fail("Duplicate id " + id);
+        }
+        idTargets[key] = {kind, index};
+    };
+
+    while (!netDone)
+    {
+        XmlReader::Event event = reader.next();
+        if (event == XmlReader::Event::EndOfDocument)
+        {
+            break;
+        }
+        if (event == XmlReader::Event::StartElement)
+        {
+            depth++;
+            const std::string &element = reader.name();
+            if (skipDepth)
+            {
+                continue;
+            }
+            if (element == "toolspecific")
+            {
+                skipDepth = depth;
+            }
+            else if (element == "net")
+            {
+                netDepth = depth;
+            }
+            else if (netDepth && object == PnmlObject::None && (element == "place" || element == "transition" || element == "arc"))
+            {
+                object = element == "place" ? PnmlObject::Place : element == "transition" ? PnmlObject::Transition : PnmlObject::Arc;
+                objectDepth = depth;
+                id = reader.attribute("id");
+                arcSource = reader.attribute("source");
+                arcTarget = reader.attribute("target");
+                if (id.empty())
+                {
+                    reader.fail("Missing id of a " + element);
+                }
+                name.clear();
+                number = object == PnmlObject::Arc ? 1 : 0;
+                hasPosition = false;
+            }
+            else if (object != PnmlObject::None && depth == objectDepth + 1)
+            {
+                label = element == "name" ? PnmlLabel::Name
+                        : element == "initialMarking" ? PnmlLabel::InitialMarking
+                        : element == "inscription" ? PnmlLabel::Inscription
+                                                   : PnmlLabel::None;
+            }
+            else if (label != PnmlLabel::None && depth == objectDepth + 2 && element == "text")
+            {
+                inText = true;
+                text.clear();
+            }
+            else if (object != PnmlObject::None && depth == objectDepth + 2 && element == "position")
+            {
+                // <graphics><position x=".." y=".."/></graphics> of the object itself
+                auto coordinate = [&](std::string_view value)
+                {
+                    double result = 0;
+                    std::from_chars(value.data(), value.data() + value.size(), result);
+                    return result;
+                };
+                position = Node(coordinate(reader.attribute("x")), coordinate(reader.attribute("y")));
+                hasPosition = true;
+            }
+        }
+        else if (event == XmlReader::Event::Text)
+        {
+            // A <text> may arrive in pieces, split by comments or CDATA sections, it's parsed once it ends
+            if (inText && !skipDepth)
+            {
+                text += reader.text();
+            }
+        }
+        else
+        {
+            const std::string &element = reader.name();
+            if (skipDepth)
+            {
+                if (depth-- == skipDepth)
+                {
+                    skipDepth = 0;
+                }
+                continue;
+            }
+            if (inText && element == "text")
+            {
+                inText = false;
+                if (label == PnmlLabel::Name)
+                {
+                    name += text;
+                }
+                else if (text.find_first_not_of(" \t\r\n") != std::string::npos)
+                {
+                    number = parsePnmlNumber(text, reader);
+                }
+            }
+            else if (object != PnmlObject::None && depth == objectDepth + 1)
+            {
+                label = PnmlLabel::None;
+            }
+            else if (object != PnmlObject::None && depth == objectDepth)
+            {
+                if (object == PnmlObject::Arc)
+                {
+                    // Weights are added to and taken from 32-bit token counts
+                    if (number < 1 || number > INT32_MAX)
+                    {
+                        reader.fail("Arc " + id + " has an invalid weight");
+                    }
+                    arcs.push_back({ids.intern(arcSource), ids.intern(arcTarget), static_cast<uint32_t>(number), reader.line()});
+                }
+                else
+                {
+                    if (object == PnmlObject::Place && number > INT32_MAX)
+                    {
+                        reader.fail("Place " + id + " holds too many tokens");
+                    }
+                    if (name.empty() || (object == PnmlObject::Place ? net.findPlace(name) : net.findTransition(name)) != INVALID_ID)
+                    {
+                        name = id;
+                    }
+                    const bool added = object == PnmlObject::Place ? net.addPlace(name, static_cast<int>(number)) : net.addTransition(name);
+                    if (!added)
+                    {
+                        reader.fail("Duplicate name " + name);
+                    }
+                    const uint32_t index = static_cast<uint32_t>((object == PnmlObject::Place ? net.getPlaces().size() : net.getTransitions().size()) - 1);
+                    registerId(object, index);
+                    if (layout && hasPosition)
+                    {
+                        auto &positions = object == PnmlObject::Place ? layout->places : layout->transitions;
+                        positions.resize(std::max<size_t>(positions.size(), index + 1));
+                        positions[index] = position;
+                    }
+                }
+                object = PnmlObject::None;
+            }
+            else if (element == "net" && depth == netDepth)
+            {
+                netDone = true;
+            }
+            depth--;
+        }
+    }
+
+    for (const auto &arc : arcs)
+    {
+        if (arc.source >= idTargets.size() || arc.target >= idTargets.size() ||
+            idTargets[arc.source].first == PnmlObject::None || idTargets[arc.target].first == PnmlObject::None)
+        {
+            throw std::runtime_error(source + ":" + std::to_string(arc.line) + ": Arc refers to an unknown node");
+        }
+        const auto [sourceKind, sourceIndex] = idTargets[arc.source];
+        const auto [targetKind, targetIndex] = idTargets[arc.target];
+        if (sourceKind == targetKind)
+        {
+            throw std::runtime_error(source + ":" + std::to_string(arc.line) + ": " +
+                                     (sourceKind == PnmlObject::Place ? "Both are places" : "Both are transitions"));
+        }
+        net.addArc(sourceIndex, targetIndex,
+                   sourceKind == PnmlObject::Place ? ArcDirection::PlaceToTransition : ArcDirection::TransitionToPlace,
+                   arc.weight);
+    }
+    net.finalize();
+    return net;
+}
+
+/// @brief Loads a PNML file.
+/// @param path Path of the file.
+/// @param layout If not null, receives the positions stored in the file.
+/// @return (PetriNet) Finalized Petri net.
+PetriNet loadPnml(const std::string &path, NetLayout *layout)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't open " + path);
+    }
+    return readPnml(file, layout, path);
+}
+
+/// @brief Writes a position element if the layout has one for the node.
+static void writePosition(std::ostream &out, const std::vector<Node> *positions, uint32_t index)
+{
+    if (positions && index < positions->size())
+    {
+        out << "<graphics><position x=\"" << (*positions)[index].x << "\" y=\"" << (*positions)[index].y << "\"/></graphics>";
+    }
+}
+
+/// @brief Streams a Petri net as a PNML place/transition net.
+/// Places get the ids p0, p1, .., transitions t0, t1, .. and the net's names become <name> labels.
+/// @param net Petri net to write.
+/// @param out Output stream.
+/// @param layout If not null, node positions are written as <graphics> elements.
+void writePnml(const PetriNet &net, std::ostream &out, const NetLayout *layout)
+{
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           "<pnml xmlns=\"http://www.pnml.org/version-2009/grammar/pnml\">\n"
+           "<net id=\"net0\" type=\"http://www.pnml.org/version-2009/grammar/ptnet\">\n"
+           "<page id=\"page0\">\n";
+    for (PlaceId place = 0; place < net.getPlaces().size(); place++)
+    {
+        out << "<place id=\"p" << place << "\"><name><text>";
+        writeXmlEscaped(out, net.placeName(place));
+        out << "</text></name>";
+        if (net.getPlaces()[place].tokens > 0)
+        {
+            out << "<initialMarking><text>" << net.getPlaces()[place].tokens << "</text></initialMarking>";
+        }
+        writePosition(out, layout ? &layout->places : nullptr, place);
+        out << "</place>\n";
+    }
+    for (TransitionId transition = 0; transition < net.getTransitions().size(); transition++)
+    {
+        out << "<transition id=\"t" << transition << "\"><name><text>";
+        writeXmlEscaped(out, net.transitionName(transition));
+        out << "</text></name>";
+        writePosition(out, layout ? &layout->transitions : nullptr, transition);
+        out << "</transition>\n";
+    }
+    for (size_t i = 0; i < net.getArcs().size(); i++)
+    {
+        const Edge &arc = net.getArcs()[i];
+        const bool fromPlace = arc.direction == ArcDirection::PlaceToTransition;
+        out << "<arc id=\"a" << i << "\" source=\"" << (fromPlace ? 'p' : 't') << arc.from << "\" target=\""
+            << (fromPlace ? 't' : 'p') << arc.to << "\"";
+        if (arc.weight != 1)
+        {
+            out << "><inscription><text>" << arc.weight << "</text></inscription></arc>\n";
+        }
+        else
+        {
+            out << "/>\n";
+        }
+    }
+    out << "</page>\n</net>\n</pnml>\n";
+}
+
+/// @brief Saves a Petri net as a PNML file.
+/// @param net Petri net to write.
+/// @param path Path of the file.
+/// @param layout If not null, node positions are written as well.
+void savePnml(const PetriNet &net, const std::string &path, const NetLayout *layout)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path);
+    }
+    writePnml(net, file, layout);
+}
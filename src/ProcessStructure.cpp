@@ -0,0 +1,591 @@
+#include "../include/ProcessStructure.h"
+#include "../include/BackwardReachability.h"
+#include "../include/Livelock.h"
+#include "../include/StateSpace.h"
+#include "../include/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <numeric>
+#include <string>
+#include <utility>
+
+/// @brief Calls visit with every successor (forward) or predecessor of a node. Nodes are places first, then
+/// transitions offset by the place count.
+template <typename Visit>
+static void forEachNeighbour(const NetView &net, uint32_t node, bool forward, const Visit &visit)
+{
+    const auto placeCount = static_cast<uint32_t>(net.placeCount());
+    if (node < placeCount)
+    {
+        for (const TransitionId transition : forward ? net.placePostset(node) : net.placePreset(node))
+        {
+            visit(placeCount + transition);
+        }
+    }
+    else
+    {
+        for (const PlaceId place : forward ? net.postset(node - placeCount) : net.preset(node - placeCount))
+        {
+            visit(place);
+        }
+    }
+}
+
+/// @brief Immediate postdominator of every node (every path from it to o passes there), o is its own.
+/// Cooper, Harvey and Kennedy's iteration over the reversed net in reverse postorder, usually two passes.
+static std::vector<uint32_t> postdominators(const NetView &net, PlaceId output)
+{
+    const size_t nodeCount = net.placeCount() + net.transitionCount();
+    // Postorder of a depth-first search from o against the arcs
+    std::vector<uint32_t> order(nodeCount, INVALID_ID);
+    std::vector<uint32_t> postorder;
+    std::vector<std::pair<uint32_t, std::vector<uint32_t>>> stack;
+    std::vector<bool> seen(nodeCount, false);
+    const auto push = [&](uint32_t node)
+    {
+        seen[node] = true;
+        std::vector<uint32_t> next;
+        forEachNeighbour(net, node, false, [&](uint32_t predecessor) { next.push_back(predecessor); });
+        stack.emplace_back(node, std::move(next));
+    };
+    push(output);
+    while (!stack.empty())
+    {
+        auto &[node, next] = stack.back();
+        if (next.empty())
+        {
+            order[node] = static_cast<uint32_t>(postorder.size());
+            postorder.push_back(node);
+            stack.pop_back();
+            continue;
+        }
+        const uint32_t predecessor = next.back();
+        next.pop_back();
+        if (!seen[predecessor])
+        {
+            push(predecessor);
+        }
+    }
+
+    std::vector<uint32_t> dominator(nodeCount, INVALID_ID);
+    dominator[output] = output;
+    const auto intersect = [&](uint32_t a, uint32_t b)
+    {
+        while (a != b)
+        {
+            while (order[a] < order[b])
+            {
+                a = dominator[a];
+            }
+            while (order[b] < order[a])
+            {
+                b = dominator[b];
+            }
+        }
+        return a;
+    };
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = postorder.size() - 1; i-- > 0;)
+        {
+            const uint32_t node = postorder[i];
+            uint32_t nearest = INVALID_ID;
+            forEachNeighbour(net, node, true, [&](uint32_t successor)
+                             {
+                                 if (dominator[successor] != INVALID_ID)
+                                 {
+                                     nearest = nearest == INVALID_ID ? successor : intersect(successor, nearest);
+                                 }
+                             });
+            if (nearest != dominator[node])
+            {
+                dominator[node] = nearest;
+                changed = true;
+            }
+        }
+    }
+    return dominator;
+}
+
+ProcessStructureTree decomposeWorkflowNet(const NetView &net, const WorkflowStructure &structure)
+{
+    ProcessStructureTree tree;
+    if (!structure.valid())
+    {
+        return tree;
+    }
+    const auto placeCount = static_cast<uint32_t>(net.placeCount());
+    const size_t nodeCount = placeCount + net.transitionCount();
+    const std::vector<uint32_t> dominator = postdominators(net, structure.output);
+
+    // Candidate fragments, at most one per entry: the nearest exit that closes it off
+    std::vector<uint32_t> stamp(nodeCount, INVALID_ID);
+    std::vector<std::vector<uint32_t>> interiors;
+    std::vector<std::pair<PlaceId, PlaceId>> borders;
+    std::vector<uint32_t> interior;
+    uint32_t attempt = 0;
+    const auto closedOff = [&](PlaceId entry, PlaceId exit)
+    {
+        attempt++;
+        stamp[entry] = stamp[exit] = attempt;
+        interior.clear();
+        bool valid = true;
+        const auto enter = [&](uint32_t node)
+        {
+            if (node == entry || (node == structure.output && exit != structure.output))
+            {
+                valid = false; // A cycle back into the entry, or a way around the exit
+            }
+            else if (stamp[node] != attempt)
+            {
+                stamp[node] = attempt;
+                interior.push_back(node);
+            }
+        };
+        forEachNeighbour(net, entry, true, enter);
+        for (size_t head = 0; valid && head < interior.size(); head++)
+        {
+            forEachNeighbour(net, interior[head], true, enter);
+        }
+        // Nothing but the entry may lead inside, and the exit may only be fed from inside
+        const auto fedFromInside = [&](uint32_t node, bool allowEntry)
+        {
+            forEachNeighbour(net, node, false, [&](uint32_t predecessor)
+                             { valid = valid && stamp[predecessor] == attempt && predecessor != exit && (allowEntry || predecessor != entry); });
+        };
+        for (size_t i = 0; valid && i < interior.size(); i++)
+        {
+            fedFromInside(interior[i], true);
+        }
+        if (valid)
+        {
+            fedFromInside(exit, false);
+        }
+        const auto transitions = std::count_if(interior.begin(), interior.end(), [&](uint32_t node) { return node >= placeCount; });
+        return valid && transitions > 1;
+    };
+    for (PlaceId entry = 0; entry < placeCount; entry++)
+    {
+        if (entry == structure.output || dominator[entry] == INVALID_ID)
+        {
+            continue;
+        }
+        for (uint32_t exit = dominator[entry];; exit = dominator[exit])
+        {
+            if (exit < placeCount && !(entry == structure.input && exit == structure.output) && closedOff(entry, exit))
+            {
+                borders.emplace_back(entry, exit);
+                interiors.push_back(interior);
+                break;
+            }
+            if (exit == structure.output)
+            {
+                break;
+            }
+        }
+    }
+
+    // Nest them from the smallest up, a fragment only partly inside a larger one makes the larger one go
+    std::vector<size_t> bySize(interiors.size());
+    std::iota(bySize.begin(), bySize.end(), 0);
+    std::stable_sort(bySize.begin(), bySize.end(), [&](size_t a, size_t b) { return interiors[a].size() < interiors[b].size(); });
+    std::vector<uint32_t> owner(nodeCount, INVALID_ID); // Innermost kept fragment holding the node
+    std::vector<uint32_t> inside(nodeCount, INVALID_ID);
+    std::vector<size_t> topmost(interiors.size(), SIZE_MAX); // Candidate that last found the fragment among its children
+    std::vector<std::vector<uint32_t>> kept;
+    for (const size_t candidate : bySize)
+    {
+        const auto id = static_cast<uint32_t>(tree.fragments.size());
+        const std::vector<uint32_t> &nodes = interiors[candidate];
+        const auto [entry, exit] = borders[candidate];
+        for (const uint32_t node : nodes)
+        {
+            inside[node] = id;
+        }
+        inside[entry] = inside[exit] = id;
+        std::vector<uint32_t> children;
+        for (const uint32_t node : nodes)
+        {
+            if (owner[node] == INVALID_ID)
+            {
+                continue;
+            }
+            uint32_t child = owner[node];
+            while (tree.fragments[child].parent != INVALID_ID)
+            {
+                child = tree.fragments[child].parent;
+            }
+            if (topmost[child] != candidate)
+            {
+                topmost[child] = candidate;
+                children.push_back(child);
+            }
+        }
+        const bool nested = std::all_of(children.begin(), children.end(), [&](uint32_t child)
+                                        {
+                                            const Fragment &fragment = tree.fragments[child];
+                                            return inside[fragment.entry] == id && inside[fragment.exit] == id &&
+                                                   std::all_of(kept[child].begin(), kept[child].end(), [&](uint32_t node) { return inside[node] == id; });
+                                        });
+        for (const uint32_t node : nodes)
+        {
+            inside[node] = INVALID_ID;
+        }
+        inside[entry] = inside[exit] = INVALID_ID;
+        if (!nested)
+        {
+            continue;
+        }
+        for (const uint32_t child : children)
+        {
+            tree.fragments[child].parent = id;
+        }
+        Fragment fragment;
+        fragment.entry = entry;
+        fragment.exit = exit;
+        for (const uint32_t node : nodes)
+        {
+            owner[node] = owner[node] == INVALID_ID ? id : owner[node];
+            if (node < placeCount)
+            {
+                fragment.places.push_back(node);
+            }
+            else
+            {
+                fragment.transitions.push_back(node - placeCount);
+            }
+        }
+        std::sort(fragment.places.begin(), fragment.places.end());
+        std::sort(fragment.transitions.begin(), fragment.transitions.end());
+        tree.fragments.push_back(std::move(fragment));
+        kept.push_back(nodes);
+    }
+
+    // The whole net closes the tree
+    Fragment root;
+    root.entry = structure.input;
+    root.exit = structure.output;
+    for (PlaceId place = 0; place < placeCount; place++)
+    {
+        if (place != structure.input && place != structure.output)
+        {
+            root.places.push_back(place);
+        }
+    }
+    root.transitions.resize(net.transitionCount());
+    std::iota(root.transitions.begin(), root.transitions.end(), 0);
+    const auto rootId = static_cast<uint32_t>(tree.fragments.size());
+    for (Fragment &fragment : tree.fragments)
+    {
+        fragment.parent = fragment.parent == INVALID_ID ? rootId : fragment.parent;
+    }
+    tree.fragments.push_back(std::move(root));
+    return tree;
+}
+
+/// @brief A fragment with its children contracted, as a workflow net of its own.
+struct ContractedFragment
+{
+    PetriNet net;
+    TransitionIds transitions;               // Transition of the whole net behind every transition
+    std::vector<std::vector<uint32_t>> runs; // Children a token passes through in every place, in order
+    bool closed = false;                     // The children lead from the entry straight to the exit, i is all that is left
+};
+
+/// @brief Builds the workflow net of a fragment: its entry as i holding one token, its exit as o, and the places and
+/// transitions no child holds. A child would become a transition taking a token from its entry and putting it into
+/// its exit, the only consumer of the one and the only producer of the other. Fusing such series places keeps
+/// liveness, boundedness and safeness (Murata), so every child merges its entry and exit into one place instead:
+/// a sequence of children becomes a single place and a block of parallel ones a single split and join.
+/// @param owner Innermost fragment holding every node, places first.
+/// @param children Child fragments of the fragment.
+static ContractedFragment contractFragment(const NetView &net, const ProcessStructureTree &tree, uint32_t id,
+                                           const std::vector<uint32_t> &owner, const std::vector<uint32_t> &children)
+{
+    const Fragment &fragment = tree.fragments[id];
+    const auto placeCount = static_cast<uint32_t>(net.placeCount());
+    ContractedFragment contracted;
+
+    // Places of the fragment in increasing id, merged along the children
+    std::vector<PlaceId> places{fragment.entry, fragment.exit};
+    for (const PlaceId place : fragment.places)
+    {
+        if (owner[place] == id)
+        {
+            places.push_back(place);
+        }
+    }
+    std::sort(places.begin(), places.end());
+    const auto local = [&](PlaceId place) { return static_cast<uint32_t>(std::lower_bound(places.begin(), places.end(), place) - places.begin()); };
+    std::vector<uint32_t> next(places.size(), INVALID_ID), entered(places.size(), INVALID_ID), child(places.size(), INVALID_ID);
+    for (const uint32_t nested : children)
+    {
+        const uint32_t from = local(tree.fragments[nested].entry);
+        next[from] = local(tree.fragments[nested].exit);
+        child[from] = nested;
+        entered[next[from]] = from;
+    }
+    // Every place is the entry and the exit of one child at most, so the merged places are chains
+    std::vector<PlaceId> merged(places.size(), INVALID_ID);
+    std::vector<uint32_t> ends; // Last place of every chain
+    const auto addPlace = [&](uint32_t first, std::string_view name, int tokens)
+    {
+        const auto added = static_cast<PlaceId>(contracted.runs.size());
+        contracted.net.addPlace(name, tokens);
+        contracted.runs.emplace_back();
+        uint32_t place = first;
+        for (size_t steps = 0; steps < places.size() && merged[place] == INVALID_ID; steps++)
+        {
+            merged[place] = added;
+            if (next[place] == INVALID_ID)
+            {
+                break;
+            }
+            contracted.runs[added].push_back(child[place]);
+            place = next[place];
+        }
+    };
+    const uint32_t input = local(fragment.entry), output = local(fragment.exit);
+    addPlace(input, "i", 1);
+    if (merged[output] != INVALID_ID)
+    {
+        contracted.closed = true;
+        contracted.net.finalize();
+        return contracted;
+    }
+    uint32_t first = output;
+    while (entered[first] != INVALID_ID && merged[entered[first]] == INVALID_ID)
+    {
+        first = entered[first];
+    }
+    addPlace(first, "o", 0);
+    for (uint32_t place = 0; place < places.size(); place++)
+    {
+        if (merged[place] == INVALID_ID && entered[place] == INVALID_ID)
+        {
+            addPlace(place, net.placeName(places[place]), 0);
+        }
+    }
+    for (uint32_t place = 0; place < places.size(); place++)
+    {
+        if (merged[place] == INVALID_ID)
+        {
+            addPlace(place, net.placeName(places[place]), 0); // A cycle of children, which no workflow net has
+        }
+    }
+
+    for (const TransitionId transition : fragment.transitions)
+    {
+        if (owner[placeCount + transition] != id)
+        {
+            continue;
+        }
+        contracted.net.addTransition(net.transitionName(transition));
+        const auto added = static_cast<TransitionId>(contracted.transitions.size());
+        contracted.transitions.push_back(transition);
+        const auto inputs = net.preset(transition);
+        const auto inputWeights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            contracted.net.addArc(merged[local(inputs[i])], added, ArcDirection::PlaceToTransition, inputWeights[i]);
+        }
+        const auto outputs = net.postset(transition);
+        const auto outputWeights = net.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            contracted.net.addArc(added, merged[local(outputs[i])], ArcDirection::TransitionToPlace, outputWeights[i]);
+        }
+    }
+    contracted.net.finalize();
+    return contracted;
+}
+
+/// @brief Explores a contracted fragment: sound if every marking can complete, the final marking is reached and
+/// every transition fires somewhere, safe if no marking holds two tokens in a place. The exploration ends at the
+/// first marking that isn't safe. The witness of a sound fragment
+/// is searched backwards over the same markings.
+/// @param transitionCount Transitions of the whole net.
+/// @param witness Set to the shortest completion: transitions of the whole net, and transitionCount plus the child's
+/// index wherever a token passes through a child.
+static FragmentVerdict verifyFragment(const ContractedFragment &fragment, uint32_t transitionCount, size_t maxStates, std::vector<uint32_t> &witness)
+{
+    FragmentVerdict verdict;
+    const NetView net = fragment.net.view();
+    if (fragment.closed)
+    {
+        // A sequence of children, each of them safe and sound
+        verdict.sound = verdict.safe = verdict.complete = true;
+        for (const uint32_t nested : fragment.runs[0])
+        {
+            witness.push_back(transitionCount + nested);
+        }
+        return verdict;
+    }
+    // The verdict needs a single forward pass that stops at the first stuck component or the first unsafe marking,
+    // an unsafe fragment decides nothing however far it is explored
+    // i and o are the first two places, a loop may still lead back into i
+    std::vector<int32_t> finalMarking(net.placeCount(), 0);
+    finalMarking[1] = 1;
+    LivelockReport stuck = findStuckComponents(net, finalMarking, true, maxStates, 1);
+    verdict.complete = stuck.complete;
+    verdict.states = stuck.states;
+    verdict.safe = !stuck.exceededTokens;
+    std::vector<bool> fired(net.transitionCount(), false);
+    for (StateId state = 0; state < stuck.markings.size(); state++)
+    {
+        const auto marking = stuck.markings[state];
+        for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+        {
+            if (fired[transition])
+            {
+                continue;
+            }
+            const auto inputs = net.preset(transition);
+            const auto weights = net.presetWeights(transition);
+            bool enabled = true;
+            for (size_t i = 0; enabled && i < inputs.size(); i++)
+            {
+                enabled = marking[inputs[i]] >= static_cast<int32_t>(weights[i]);
+            }
+            fired[transition] = enabled;
+        }
+    }
+    // Every bottom component of a complete search holds the final marking, so every marking can complete
+    verdict.sound = stuck.complete && stuck.components.empty() && stuck.markings.find(finalMarking) != INVALID_ID &&
+                    std::all_of(fired.begin(), fired.end(), [](bool any) { return any; });
+    if (!verdict.sound)
+    {
+        return verdict;
+    }
+    // The witness comes from a backward search over the markings just explored
+    const CompletionReport completion = checkOptionToComplete(net, std::move(stuck.markings), finalMarking, stuck.complete);
+    // A token leaves a merged place through its children before anything takes it
+    const auto pass = [&](PlaceId place)
+    {
+        for (const uint32_t nested : fragment.runs[place])
+        {
+            witness.push_back(transitionCount + nested);
+        }
+    };
+    for (const TransitionId transition : shortestCompletion(net, completion))
+    {
+        for (const PlaceId place : net.preset(transition))
+        {
+            pass(place);
+        }
+        witness.push_back(fragment.transitions[transition]);
+    }
+    pass(1);
+    return verdict;
+}
+
+/// @brief Appends the witness of a fragment to a firing sequence of the whole net, a child's step by the child's witness.
+static void expandWitness(const std::vector<std::vector<uint32_t>> &witnesses, uint32_t id, size_t transitionCount, TransitionIds &out) // NOLINT(misc-no-recursion)
+{
+    for (const uint32_t step : witnesses[id])
+    {
+        if (step < transitionCount)
+        {
+            out.push_back(step);
+        }
+        else
+        {
+            expandWitness(witnesses, static_cast<uint32_t>(step - transitionCount), transitionCount, out);
+        }
+    }
+}
+
+DecomposedSoundness verifyFragments(const NetView &view, const ProcessStructureTree &tree, size_t threads, size_t maxStates)
+{
+    DecomposedSoundness result;
+    const size_t count = tree.fragments.size();
+    result.verdicts.resize(count);
+    if (count == 0)
+    {
+        return result;
+    }
+    const size_t placeCount = view.placeCount();
+    // Children come first, so the first fragment to claim a node is the innermost one
+    std::vector<uint32_t> owner(placeCount + view.transitionCount(), INVALID_ID);
+    std::vector<std::vector<uint32_t>> children(count);
+    std::vector<size_t> size(count, 0); // Nodes of the contracted fragment
+    for (uint32_t id = 0; id < count; id++)
+    {
+        const Fragment &fragment = tree.fragments[id];
+        for (const PlaceId place : fragment.places)
+        {
+            size[id] += owner[place] == INVALID_ID;
+            owner[place] = owner[place] == INVALID_ID ? id : owner[place];
+        }
+        for (const TransitionId transition : fragment.transitions)
+        {
+            size[id] += owner[placeCount + transition] == INVALID_ID;
+            owner[placeCount + transition] = owner[placeCount + transition] == INVALID_ID ? id : owner[placeCount + transition];
+        }
+        if (fragment.parent != INVALID_ID)
+        {
+            children[fragment.parent].push_back(id);
+            size[fragment.parent]++;
+        }
+    }
+
+    // The largest fragments go first so they don't hold up the end, one failure makes the rest pointless
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return size[a] > size[b]; });
+    std::vector<std::vector<uint32_t>> witnesses(count);
+    std::atomic<bool> failed = false;
+    const auto verify = [&](uint32_t id)
+    {
+        if (failed)
+        {
+            return;
+        }
+        try
+        {
+            const ContractedFragment contracted = contractFragment(view, tree, id, owner, children[id]);
+            result.verdicts[id] = verifyFragment(contracted, static_cast<uint32_t>(view.transitionCount()), maxStates, witnesses[id]);
+        }
+        catch (const std::exception &)
+        {
+            result.verdicts[id] = {};
+        }
+        if (!result.verdicts[id].sound || !result.verdicts[id].safe)
+        {
+            failed = true;
+        }
+    };
+    const size_t workers = std::min(threads == 0 ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads, count);
+    if (workers > 1)
+    {
+        ThreadPool pool(workers);
+        for (const uint32_t id : order)
+        {
+            pool.submit([&verify, id] { verify(id); });
+        }
+        pool.wait();
+    }
+    else
+    {
+        for (const uint32_t id : order)
+        {
+            verify(id);
+        }
+    }
+
+    for (const FragmentVerdict &verdict : result.verdicts)
+    {
+        result.states += verdict.states;
+        result.largest = std::max(result.largest, verdict.states);
+    }
+    result.sound = !failed;
+    if (result.sound)
+    {
+        expandWitness(witnesses, static_cast<uint32_t>(count - 1), view.transitionCount(), result.witness);
+    }
+    return result;
+}
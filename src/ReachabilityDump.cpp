@@ -0,0 +1,198 @@
+#include "../include/ReachabilityDump.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+static_assert(sizeof(StateEdge) == 8 && std::is_trivially_copyable_v<StateEdge>, "Edge records are stored verbatim");
+static_assert(sizeof(ReachabilityDumpHeader) % 8 == 0, "Edges after the header must stay 8 byte aligned");
+
+static const size_t DUMP_BUFFER_SIZE = 1 << 20;
+
+/// @brief Sets a bit in a packed bitmap, growing it as needed.
+static void setBit(std::vector<uint64_t> &bits, StateId state)
+{
+    if (state / 64 >= bits.size())
+    {
+        bits.resize(state / 64 + 1, 0);
+    }
+    bits[state / 64] |= uint64_t(1) << (state % 64);
+}
+
+/// @brief Opens the dump and reserves room for the header, which is written once the exploration finishes.
+/// @param path Path of the dump file.
+/// @param markings Store of the explorer this writer observes, read in onFinish.
+ReachabilityDumpWriter::ReachabilityDumpWriter(const std::string &path, const MarkingStore &markings)
+    : buffer(DUMP_BUFFER_SIZE), path(path), markings(markings)
+{
+    file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.open(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path);
+    }
+    const ReachabilityDumpHeader placeholder{};
+    file.write(reinterpret_cast<const char *>(&placeholder), sizeof(placeholder));
+}
+
+void ReachabilityDumpWriter::onEdge(StateId /*from*/, TransitionId transition, StateId to)
+{
+    const StateEdge edge = {to, transition};
+    file.write(reinterpret_cast<const char *>(&edge), sizeof(edge));
+    edgeCount++;
+}
+
+void ReachabilityDumpWriter::onExpanded(StateId state, std::span<const int32_t> /*marking*/, uint8_t flags)
+{
+    offsets.push_back(edgeCount);
+    if (flags & STATE_INITIAL)
+    {
+        setBit(initialBits, state);
+    }
+    if (flags & STATE_FINAL)
+    {
+        setBit(finalBits, state);
+    }
+    if (flags & STATE_DEADLOCK)
+    {
+        setBit(deadlockBits, state);
+    }
+}
+
+void ReachabilityDumpWriter::onFinish(const StateSpaceResult &result)
+{
+    ReachabilityDumpHeader header{};
+    std::memcpy(header.magic, REACHABILITY_DUMP_MAGIC, sizeof(header.magic));
+    header.version = REACHABILITY_DUMP_VERSION;
+    header.byteOrder = BINARY_NET_BYTE_ORDER;
+    header.placeCount = static_cast<uint32_t>(markings.placeCount());
+    header.tokenBytes = sizeof(int32_t);
+    header.stateCount = result.states;
+    header.edgeCount = edgeCount;
+    header.flags = result.complete ? 1 : 0;
+
+    const size_t words = (result.states + 63) / 64;
+    initialBits.resize(words, 0);
+    finalBits.resize(words, 0);
+    deadlockBits.resize(words, 0);
+
+    auto &sections = header.sections;
+    sections[static_cast<size_t>(ReachabilitySection::Edges)] = {sizeof(header), edgeCount * sizeof(StateEdge)};
+    const auto writeSection = [this, &sections](ReachabilitySection section, const void *data, size_t length)
+    {
+        pad();
+        sections[static_cast<size_t>(section)] = {static_cast<uint64_t>(file.tellp()), length};
+        file.write(static_cast<const char *>(data), static_cast<std::streamsize>(length));
+    };
+    const auto tokens = markings.tokens();
+    writeSection(ReachabilitySection::Markings, tokens.data(), tokens.size_bytes());
+    writeSection(ReachabilitySection::EdgeOffsets, offsets.data(), offsets.size() * sizeof(uint64_t));
+    writeSection(ReachabilitySection::InitialBits, initialBits.data(), words * sizeof(uint64_t));
+    writeSection(ReachabilitySection::FinalBits, finalBits.data(), words * sizeof(uint64_t));
+    writeSection(ReachabilitySection::DeadlockBits, deadlockBits.data(), words * sizeof(uint64_t));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write " + path);
+    }
+}
+
+/// @brief Pads the file to the next 8 byte boundary.
+void ReachabilityDumpWriter::pad()
+{
+    const char padding[8] = {};
+    const auto position = static_cast<size_t>(file.tellp());
+    file.write(padding, static_cast<std::streamsize>((8 - position % 8) % 8));
+}
+
+/// @brief Maps a dump written by ReachabilityDumpWriter.
+/// @param path Path of the dump.
+MappedReachabilityGraph::MappedReachabilityGraph(const std::string &path) : file(path, false), header{}
+{
+    if (file.size() < sizeof(header))
+    {
+        throw std::runtime_error(path + ": Truncated reachability graph header");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, REACHABILITY_DUMP_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error(path + ": Not a reachability graph dump");
+    }
+    if (header.byteOrder != BINARY_NET_BYTE_ORDER || header.tokenBytes != sizeof(int32_t))
+    {
+        throw std::runtime_error(path + ": Reachability graph was written with a different byte order or token width");
+    }
+    if (header.version != REACHABILITY_DUMP_VERSION)
+    {
+        throw std::runtime_error(path + ": Unsupported reachability graph version " + std::to_string(header.version));
+    }
+    const auto section = [this](ReachabilitySection section) -> const BinaryNetSectionEntry &
+    {
+        return header.sections[static_cast<size_t>(section)];
+    };
+    edgeRecords = mappedSection<StateEdge>(file, section(ReachabilitySection::Edges), path);
+    markings = mappedSection<int32_t>(file, section(ReachabilitySection::Markings), path);
+    offsets = mappedSection<uint64_t>(file, section(ReachabilitySection::EdgeOffsets), path);
+    initialBits = mappedSection<uint64_t>(file, section(ReachabilitySection::InitialBits), path);
+    finalBits = mappedSection<uint64_t>(file, section(ReachabilitySection::FinalBits), path);
+    deadlockBits = mappedSection<uint64_t>(file, section(ReachabilitySection::DeadlockBits), path);
+    const size_t words = (header.stateCount + 63) / 64;
+    if (edgeRecords.size() != header.edgeCount || markings.size() != header.stateCount * header.placeCount ||
+        offsets.size() != header.stateCount + 1 || offsets.front() != 0 || offsets.back() != header.edgeCount ||
+        initialBits.size() != words || finalBits.size() != words || deadlockBits.size() != words)
+    {
+        throw std::runtime_error(path + ": Section sizes don't match the header");
+    }
+}
+
+size_t MappedReachabilityGraph::stateCount() const
+{
+    return header.stateCount;
+}
+
+size_t MappedReachabilityGraph::edgeCount() const
+{
+    return header.edgeCount;
+}
+
+size_t MappedReachabilityGraph::placeCount() const
+{
+    return header.placeCount;
+}
+
+bool MappedReachabilityGraph::complete() const
+{
+    return (header.flags & 1) != 0;
+}
+
+std::span<const int32_t> MappedReachabilityGraph::marking(StateId state) const
+{
+    return markings.subspan(size_t(state) * header.placeCount, header.placeCount);
+}
+
+std::span<const StateEdge> MappedReachabilityGraph::edges(StateId state) const
+{
+    return edgeRecords.subspan(offsets[state], offsets[state + 1] - offsets[state]);
+}
+
+uint8_t MappedReachabilityGraph::flags(StateId state) const
+{
+    const uint64_t bit = uint64_t(1) << (state % 64);
+    return ((initialBits[state / 64] & bit) ? STATE_INITIAL : 0) | ((finalBits[state / 64] & bit) ? STATE_FINAL : 0) |
+           ((deadlockBits[state / 64] & bit) ? STATE_DEADLOCK : 0);
+}
+
+/// @brief Explores the reachability graph of a net and writes it to a dump file.
+/// For nets with places i and o the final workflow marking is flagged.
+/// @param net Net to explore from its current marking.
+/// @param path Path of the dump.
+/// @param maxStates State limit, 0 for none.
+/// @return (StateSpaceResult) Size of the explored graph.
+StateSpaceResult dumpReachabilityGraph(const NetView &net, const std::string &path, size_t maxStates)
+{
+    StateSpaceExplorer explorer(net, workflowFinalMarking(net));
+    ReachabilityDumpWriter writer(path, explorer.markings());
+    return explorer.explore(writer, maxStates);
+}
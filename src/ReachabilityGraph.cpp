@@ -0,0 +1,259 @@
+#include "../include/ReachabilityGraph.h"
+
+#include <algorithm>
+#include <numeric>
+
+StronglyConnectedComponents stronglyConnectedComponents(const CsrView &graph)
+{
+    const size_t nodeCount = graph.rows();
+    StronglyConnectedComponents result;
+    result.componentOf.assign(nodeCount, INVALID_ID);
+    std::vector<uint32_t> index(nodeCount, INVALID_ID);
+    std::vector<uint32_t> low(nodeCount);
+    std::vector<uint32_t> stack;
+    std::vector<std::pair<uint32_t, uint32_t>> calls; // Node and its next edge
+    uint32_t visited = 0;
+    for (uint32_t root = 0; root < nodeCount; root++)
+    {
+        if (index[root] != INVALID_ID)
+        {
+            continue;
+        }
+        index[root] = low[root] = visited++;
+        stack.push_back(root);
+        calls.emplace_back(root, graph.offsets[root]);
+        while (!calls.empty())
+        {
+            const uint32_t node = calls.back().first;
+            if (calls.back().second < graph.offsets[node + 1])
+            {
+                const uint32_t target = graph.targets[calls.back().second++];
+                if (index[target] == INVALID_ID)
+                {
+                    index[target] = low[target] = visited++;
+                    stack.push_back(target);
+                    calls.emplace_back(target, graph.offsets[target]);
+                }
+                else if (result.componentOf[target] == INVALID_ID)
+                {
+                    low[node] = std::min(low[node], index[target]);
+                }
+                continue;
+            }
+            if (low[node] == index[node])
+            {
+                // Every edge out of the closed component leads to an earlier one, unless it stays inside
+                bool bottom = true;
+                const auto component = static_cast<uint32_t>(result.count++);
+                const size_t top = std::find(stack.rbegin(), stack.rend(), node).base() - stack.begin() - 1;
+                for (size_t i = top; i < stack.size(); i++)
+                {
+                    result.componentOf[stack[i]] = component;
+                }
+                for (size_t i = top; i < stack.size() && bottom; i++)
+                {
+                    for (const uint32_t target : graph[stack[i]])
+                    {
+                        if (result.componentOf[target] != component)
+                        {
+                            bottom = false;
+                            break;
+                        }
+                    }
+                }
+                stack.resize(top);
+                result.bottom.push_back(bottom);
+            }
+            calls.pop_back();
+            if (!calls.empty())
+            {
+                low[calls.back().first] = std::min(low[calls.back().first], low[node]);
+            }
+        }
+    }
+    return result;
+}
+
+/// @brief Builds the forward rows while the explorer reports the edges, they arrive grouped by source state.
+class ReachabilityGraphBuilder : public StateSpaceObserver
+{
+public:
+    ReachabilityGraphBuilder(std::vector<uint8_t> &flags, CsrIndex &outgoing) : flags(flags), outgoing(outgoing)
+    {
+        outgoing.offsets.push_back(0);
+    }
+
+    void onState(StateId /*state*/, std::span<const int32_t> /*marking*/, uint8_t stateFlags) override
+    {
+        flags.push_back(stateFlags);
+    }
+
+    void onEdge(StateId /*from*/, TransitionId transition, StateId to) override
+    {
+        outgoing.targets.push_back(to);
+        outgoing.weights.push_back(transition);
+    }
+
+    void onExpanded(StateId state, std::span<const int32_t> /*marking*/, uint8_t stateFlags) override
+    {
+        flags[state] = stateFlags;
+        outgoing.offsets.push_back(static_cast<uint32_t>(outgoing.targets.size()));
+    }
+
+private:
+    std::vector<uint8_t> &flags;
+    CsrIndex &outgoing;
+};
+
+ReachabilityGraph::ReachabilityGraph(const NetView &net, std::vector<int32_t> finalMarking, size_t maxStates) : store(net.placeCount())
+{
+    StateSpaceExplorer explorer(net, std::move(finalMarking));
+    ReachabilityGraphBuilder builder(stateFlags, outgoing);
+    finished = explorer.explore(builder, maxStates).complete;
+    store = explorer.releaseMarkings();
+
+    // Backward rows by counting sort on the target, sources stay in increasing order within a row
+    const size_t states = stateCount();
+    incoming.offsets.assign(states + 1, 0);
+    for (const uint32_t target : outgoing.targets)
+    {
+        incoming.offsets[target + 1]++;
+    }
+    std::partial_sum(incoming.offsets.begin(), incoming.offsets.end(), incoming.offsets.begin());
+    incoming.targets.resize(outgoing.targets.size());
+    incoming.weights.resize(outgoing.targets.size());
+    std::vector<uint32_t> next(incoming.offsets.begin(), incoming.offsets.end() - 1);
+    for (StateId state = 0; state < states; state++)
+    {
+        for (uint32_t edge = outgoing.offsets[state]; edge < outgoing.offsets[state + 1]; edge++)
+        {
+            const uint32_t position = next[outgoing.targets[edge]]++;
+            incoming.targets[position] = state;
+            incoming.weights[position] = outgoing.weights[edge];
+        }
+    }
+}
+
+size_t ReachabilityGraph::stateCount() const
+{
+    return stateFlags.size();
+}
+
+size_t ReachabilityGraph::edgeCount() const
+{
+    return outgoing.targets.size();
+}
+
+bool ReachabilityGraph::complete() const
+{
+    return finished;
+}
+
+std::span<const int32_t> ReachabilityGraph::marking(StateId state) const
+{
+    return store[state];
+}
+
+uint8_t ReachabilityGraph::flags(StateId state) const
+{
+    return stateFlags[state];
+}
+
+std::span<const uint32_t> ReachabilityGraph::successors(StateId state) const
+{
+    return outgoing[state];
+}
+
+std::span<const uint32_t> ReachabilityGraph::successorTransitions(StateId state) const
+{
+    return outgoing.weightsOf(state);
+}
+
+std::span<const uint32_t> ReachabilityGraph::predecessors(StateId state) const
+{
+    return incoming[state];
+}
+
+std::span<const uint32_t> ReachabilityGraph::predecessorTransitions(StateId state) const
+{
+    return incoming.weightsOf(state);
+}
+
+const CsrIndex &ReachabilityGraph::forward() const
+{
+    return outgoing;
+}
+
+const CsrIndex &ReachabilityGraph::backward() const
+{
+    return incoming;
+}
+
+std::vector<LabeledEdge> ReachabilityGraph::labeledEdges() const
+{
+    std::vector<LabeledEdge> edges;
+    edges.reserve(edgeCount());
+    for (StateId state = 0; state < stateCount(); state++)
+    {
+        for (uint32_t edge = outgoing.offsets[state]; edge < outgoing.offsets[state + 1]; edge++)
+        {
+            edges.push_back({state, outgoing.weights[edge], outgoing.targets[edge]});
+        }
+    }
+    return edges;
+}
+
+std::vector<StateId> ReachabilityGraph::statesWith(uint8_t flag) const
+{
+    std::vector<StateId> states;
+    for (StateId state = 0; state < stateCount(); state++)
+    {
+        if ((stateFlags[state] & flag) == flag)
+        {
+            states.push_back(state);
+        }
+    }
+    return states;
+}
+
+/// @brief Breadth-first search along the rows of a graph.
+static std::vector<bool> search(const CsrIndex &graph, std::span<const StateId> sources)
+{
+    std::vector<bool> seen(graph.rows(), false);
+    std::vector<StateId> queue;
+    for (const StateId source : sources)
+    {
+        if (!seen[source])
+        {
+            seen[source] = true;
+            queue.push_back(source);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        for (const uint32_t next : graph[queue[head]])
+        {
+            if (!seen[next])
+            {
+                seen[next] = true;
+                queue.push_back(next);
+            }
+        }
+    }
+    return seen;
+}
+
+std::vector<bool> ReachabilityGraph::reachableFrom(std::span<const StateId> sources) const
+{
+    return search(outgoing, sources);
+}
+
+std::vector<bool> ReachabilityGraph::canReach(std::span<const StateId> targets) const
+{
+    return search(incoming, targets);
+}
+
+StronglyConnectedComponents ReachabilityGraph::components() const
+{
+    return stronglyConnectedComponents(outgoing);
+}
@@ -0,0 +1,430 @@
+#include "../include/Renderer.h"
+#include "../include/XmlReader.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+static const size_t RENDER_BUFFER_SIZE = 1 << 20;
+
+static const char *colorCode(DrawingColor color)
+{
+    return color == DrawingColor::Blue ? "#38B6FF" : "#121420";
+}
+
+static const char *arrowhead(DrawingColor color)
+{
+    return color == DrawingColor::Blue ? "url(#arrowheadBlue)" : "url(#arrowhead)";
+}
+
+/// @brief Escapes a string for use inside a JSON string literal.
+std::string jsonEscape(std::string_view text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                const char *digits = "0123456789abcdef";
+                escaped += "\\u00";
+                escaped += digits[(c >> 4) & 0xf];
+                escaped += digits[c & 0xf];
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+    }
+    return escaped;
+}
+
+/// @brief Writes a string as a quoted DOT identifier.
+void writeDotQuoted(std::ostream &out, std::string_view text)
+{
+    out << '"';
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+void SvgRenderer::render(const Drawing &drawing, std::ostream &out) const
+{
+    // Token dots of every circle in every frame, a still drawing is a single frame
+    const size_t frames = std::max<size_t>(drawing.frames.size(), 1);
+    std::vector<std::vector<bool>> marked(drawing.nodes.size());
+    for (uint32_t node = 0; node < drawing.nodes.size(); node++)
+    {
+        if (drawing.nodes[node].shape == NodeShape::Circle)
+        {
+            marked[node].assign(frames, drawing.frames.empty() && drawing.nodes[node].tokens > 0);
+        }
+    }
+    for (size_t frame = 0; frame < drawing.frames.size(); frame++)
+    {
+        for (const uint32_t node : drawing.frames[frame].marked)
+        {
+            marked[node][frame] = true;
+        }
+    }
+    const auto everMarked = [&marked](uint32_t node)
+    {
+        return std::find(marked[node].begin(), marked[node].end(), true) != marked[node].end();
+    };
+
+    out << R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1" width=")" << drawing.width << "\" height=\"" << drawing.height << "\">\n";
+    // Arrowheads in Xiketic and Blue Jeans
+    out << "<defs>\n";
+    for (const DrawingColor color : {DrawingColor::Blue, DrawingColor::Dark})
+    {
+        out << "<marker id=\"" << (color == DrawingColor::Blue ? "arrowheadBlue" : "arrowhead")
+            << R"(" viewBox="0 0 10 10" refX="1" refY="5" markerUnits="strokeWidth" markerWidth="5" markerHeight="5" orient="auto">)"
+            << R"(<path d="M 0 0 L 10 5 L 0 10 z" fill=")" << colorCode(color) << "\"/></marker>\n";
+    }
+    out << "</defs>\n";
+
+    for (uint32_t node = 0; node < drawing.nodes.size(); node++)
+    {
+        const DrawingNode &shape = drawing.nodes[node];
+        switch (shape.shape)
+        {
+        case NodeShape::Circle:
+        {
+            out << "<circle cx=\"" << shape.x << "\" cy=\"" << shape.y << "\" r=\"" << NODE_RADIUS
+                << R"(" stroke="#121420" stroke-width="2" fill="white"/>)" << '\n';
+            // The label moves above the circle if a token dot takes its place
+            const int offset = everMarked(node) ? NODE_RADIUS + 20 : -5;
+            out << "<text x=\"" << shape.x << "\" y=\"" << shape.y - offset << R"(" font-size="20" text-anchor="middle">)";
+            writeXmlEscaped(out, shape.label);
+            out << "</text>\n";
+            break;
+        }
+        case NodeShape::Box:
+            out << "<rect x=\"" << shape.x - NODE_RADIUS << "\" y=\"" << shape.y - NODE_RADIUS << "\" width=\"" << 2 * NODE_RADIUS
+                << "\" height=\"" << 2 * NODE_RADIUS << R"(" stroke="#121420" stroke-width="2" fill="white"/>)" << '\n';
+            out << "<text x=\"" << shape.x << "\" y=\"" << shape.y + 5 << R"(" font-size="20" text-anchor="middle">)";
+            writeXmlEscaped(out, shape.label);
+            out << "</text>\n";
+            out << "<text x=\"" << shape.x << "\" y=\"" << shape.y + NODE_RADIUS + 20 << R"(" font-size="20" text-anchor="middle">)";
+            writeXmlEscaped(out, shape.caption);
+            out << "</text>\n";
+            break;
+        case NodeShape::Text:
+            out << "<text x=\"" << shape.x << "\" y=\"" << shape.y
+                << R"(" text-anchor="middle" fill="black" font-size="20px" dy=".3em" font-weight="bold">)";
+            writeXmlEscaped(out, shape.label);
+            out << "</text>\n";
+            break;
+        }
+    }
+
+    for (const DrawingEdge &edge : drawing.edges)
+    {
+        if (edge.curved)
+        {
+            out << "<path d=\"M " << edge.x1 << ' ' << edge.y1 << " Q " << edge.controlX << ' ' << edge.controlY << ' '
+                << edge.x2 << ' ' << edge.y2 << "\" fill=\"none\"";
+        }
+        else
+        {
+            out << "<line x1=\"" << edge.x1 << "\" y1=\"" << edge.y1 << "\" x2=\"" << edge.x2 << "\" y2=\"" << edge.y2 << '"';
+        }
+        out << " stroke=\"" << colorCode(edge.color) << "\" stroke-width=\"2\" marker-end=\"" << arrowhead(edge.color) << "\"/>\n";
+        if (!edge.label.empty())
+        {
+            out << "<text x=\"" << edge.labelX << "\" y=\"" << edge.labelY << "\" text-anchor=\"middle\" fill=\"" << colorCode(edge.labelColor)
+                << R"(" font-size="20px" dy=".3em" font-weight="bold">)";
+            writeXmlEscaped(out, edge.label);
+            out << "</text>\n";
+        }
+    }
+
+    // Frames switch visibility with discrete SMIL animations sharing one timeline
+    std::ostringstream times;
+    for (size_t frame = 0; frame < frames; frame++)
+    {
+        times << (frame > 0 ? ";" : "") << static_cast<double>(frame) / static_cast<double>(frames);
+    }
+    const std::string keyTimes = times.str();
+    const auto animateVisibility = [&](const auto &visible)
+    {
+        out << R"(<animate attributeName="visibility" calcMode="discrete" repeatCount="indefinite" dur=")"
+            << drawing.frameSeconds * static_cast<double>(frames) << "s\" keyTimes=\"" << keyTimes << "\" values=\"";
+        for (size_t frame = 0; frame < frames; frame++)
+        {
+            out << (frame > 0 ? ";" : "") << (visible(frame) ? "visible" : "hidden");
+        }
+        out << "\"/>";
+    };
+    std::vector<bool> highlighted(drawing.nodes.size(), false);
+    for (const DrawingFrame &frame : drawing.frames)
+    {
+        if (frame.highlighted == UINT32_MAX || highlighted[frame.highlighted])
+        {
+            continue;
+        }
+        const uint32_t node = frame.highlighted;
+        highlighted[node] = true;
+        const DrawingNode &shape = drawing.nodes[node];
+        if (shape.shape == NodeShape::Box)
+        {
+            out << "<rect x=\"" << shape.x - NODE_RADIUS << "\" y=\"" << shape.y - NODE_RADIUS << "\" width=\"" << 2 * NODE_RADIUS
+                << "\" height=\"" << 2 * NODE_RADIUS << '"';
+        }
+        else
+        {
+            out << "<circle cx=\"" << shape.x << "\" cy=\"" << shape.y << "\" r=\"" << NODE_RADIUS << '"';
+        }
+        out << R"( stroke="#38B6FF" stroke-width="5" fill="none" visibility="hidden">)";
+        animateVisibility([&](size_t frame)
+        {
+            return drawing.frames[frame].highlighted == node;
+        });
+        out << (shape.shape == NodeShape::Box ? "</rect>\n" : "</circle>\n");
+    }
+    for (uint32_t node = 0; node < drawing.nodes.size(); node++)
+    {
+        if (marked[node].empty() || !everMarked(node))
+        {
+            continue;
+        }
+        out << "<circle cx=\"" << drawing.nodes[node].x << "\" cy=\"" << drawing.nodes[node].y << "\" r=\"" << NODE_RADIUS / 2
+            << R"(" stroke="none" fill="#121420")";
+        if (std::find(marked[node].begin(), marked[node].end(), false) == marked[node].end())
+        {
+            out << "/>\n";
+            continue;
+        }
+        out << (marked[node][0] ? ">" : R"( visibility="hidden">)");
+        animateVisibility([&](size_t frame)
+        {
+            return marked[node][frame];
+        });
+        out << "</circle>\n";
+    }
+    for (size_t frame = 0; frame < drawing.frames.size(); frame++)
+    {
+        out << R"(<text x="10" y="30" font-size="20" visibility="hidden">)";
+        writeXmlEscaped(out, drawing.frames[frame].caption);
+        animateVisibility([frame](size_t shown)
+        {
+            return shown == frame;
+        });
+        out << "</text>\n";
+    }
+    out << "</svg>\n";
+}
+
+void DotRenderer::render(const Drawing &drawing, std::ostream &out) const
+{
+    // DOT measures y upwards, positions are in points
+    out << "digraph drawing {\n";
+    out << "graph [bb=\"0,0," << drawing.width << ',' << drawing.height << "\"];\n";
+    out << "node [fixedsize=true, width=" << 2.0 * NODE_RADIUS / 72 << ", height=" << 2.0 * NODE_RADIUS / 72 << "];\n";
+    for (const DrawingNode &node : drawing.nodes)
+    {
+        out << node.id << " [shape=" << (node.shape == NodeShape::Circle ? "circle" : node.shape == NodeShape::Box ? "box" : "plaintext") << ", label=";
+        writeDotQuoted(out, node.label);
+        if (!node.caption.empty())
+        {
+            out << ", xlabel=";
+            writeDotQuoted(out, node.caption);
+        }
+        else if (node.tokens > 0)
+        {
+            out << ", xlabel=\"" << node.tokens << '"';
+        }
+        out << ", pos=\"" << node.x << ',' << drawing.height - node.y << "!\"];\n";
+    }
+    for (const DrawingEdge &edge : drawing.edges)
+    {
+        out << drawing.nodes[edge.from].id << " -> " << drawing.nodes[edge.to].id << " [color=\"" << colorCode(edge.color) << '"';
+        if (!edge.label.empty())
+        {
+            out << ", label=";
+            writeDotQuoted(out, edge.label);
+        }
+        out << "];\n";
+    }
+    out << "}\n";
+}
+
+void JsonRenderer::render(const Drawing &drawing, std::ostream &out) const
+{
+    static const char *shapes[] = {"circle", "box", "text"};
+    out << "{\"width\":" << drawing.width << ",\"height\":" << drawing.height << ",\n\"nodes\":[";
+    for (size_t i = 0; i < drawing.nodes.size(); i++)
+    {
+        const DrawingNode &node = drawing.nodes[i];
+        out << (i ? ",\n" : "\n") << "{\"id\":\"" << jsonEscape(node.id) << "\",\"shape\":\"" << shapes[static_cast<int>(node.shape)]
+            << "\",\"x\":" << node.x << ",\"y\":" << node.y << ",\"label\":\"" << jsonEscape(node.label) << '"';
+        if (!node.caption.empty())
+        {
+            out << ",\"caption\":\"" << jsonEscape(node.caption) << '"';
+        }
+        if (node.tokens != 0)
+        {
+            out << ",\"tokens\":" << node.tokens;
+        }
+        out << '}';
+    }
+    out << "],\n\"edges\":[";
+    for (size_t i = 0; i < drawing.edges.size(); i++)
+    {
+        const DrawingEdge &edge = drawing.edges[i];
+        out << (i ? ",\n" : "\n") << "{\"from\":\"" << jsonEscape(drawing.nodes[edge.from].id) << "\",\"to\":\""
+            << jsonEscape(drawing.nodes[edge.to].id) << "\",\"color\":\"" << colorCode(edge.color) << "\",\"points\":[["
+            << edge.x1 << ',' << edge.y1 << ']';
+        if (edge.curved)
+        {
+            out << ",[" << edge.controlX << ',' << edge.controlY << ']';
+        }
+        out << ",[" << edge.x2 << ',' << edge.y2 << "]]";
+        if (!edge.label.empty())
+        {
+            out << ",\"label\":\"" << jsonEscape(edge.label) << "\",\"labelPosition\":[" << edge.labelX << ',' << edge.labelY << ']';
+        }
+        out << '}';
+    }
+    out << "],\n\"frames\":[";
+    for (size_t i = 0; i < drawing.frames.size(); i++)
+    {
+        const DrawingFrame &frame = drawing.frames[i];
+        out << (i ? ",\n" : "\n") << "{\"caption\":\"" << jsonEscape(frame.caption) << "\",\"marked\":[";
+        for (size_t j = 0; j < frame.marked.size(); j++)
+        {
+            out << (j ? "," : "") << '"' << jsonEscape(drawing.nodes[frame.marked[j]].id) << '"';
+        }
+        out << ']';
+        if (frame.highlighted != UINT32_MAX)
+        {
+            out << ",\"highlighted\":\"" << jsonEscape(drawing.nodes[frame.highlighted].id) << '"';
+        }
+        out << '}';
+    }
+    out << "]}\n";
+}
+
+std::unique_ptr<Renderer> rendererFor(const std::string &path)
+{
+    const std::string extension = std::filesystem::path(path).extension().string();
+    if (extension == ".svg")
+    {
+        return std::make_unique<SvgRenderer>();
+    }
+    if (extension == ".dot")
+    {
+        return std::make_unique<DotRenderer>();
+    }
+    if (extension == ".json")
+    {
+        return std::make_unique<JsonRenderer>();
+    }
+    throw std::invalid_argument("No renderer for " + path + " (expected .svg, .dot or .json)");
+}
+
+BufferedFile::BufferedFile(const std::string &path) : buffer(RENDER_BUFFER_SIZE), path(path)
+{
+    file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    file.open(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Can't create " + path);
+    }
+}
+
+std::ostream &BufferedFile::stream()
+{
+    return file;
+}
+
+void BufferedFile::close()
+{
+    file.close();
+    if (!file)
+    {
+        throw std::runtime_error("Can't write " + path);
+    }
+}
+
+void renderToFile(const Drawing &drawing, const std::string &path)
+{
+    const std::unique_ptr<Renderer> renderer = rendererFor(path);
+    BufferedFile file(path);
+    renderer->render(drawing, file.stream());
+    file.close();
+}
+
+RenderQueue::RenderQueue(size_t threads) : pool(threads)
+{
+}
+
+void RenderQueue::submit(Drawing drawing, const std::string &path)
+{
+    // Resolved here so a bad extension fails at the call, the job itself only touches the disk
+    std::shared_ptr<const Renderer> renderer = rendererFor(path);
+    auto job = std::make_shared<const Drawing>(std::move(drawing));
+    pool.submit([this, renderer, job, path]
+                {
+                    try
+                    {
+                        BufferedFile file(path);
+                        renderer->render(*job, file.stream());
+                        file.close();
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!failure)
+                        {
+                            failure = std::current_exception();
+                        }
+                    }
+                });
+}
+
+void RenderQueue::wait()
+{
+    pool.wait();
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::swap(error, failure);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+RenderQueue &renderQueue()
+{
+    static RenderQueue queue;
+    return queue;
+}
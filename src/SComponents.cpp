@@ -0,0 +1,259 @@
+#include "../include/SComponents.h"
+
+#include <algorithm>
+#include <utility>
+
+/// @brief Adjacency of a net read off its arc list, every entry a (neighbour, weight) pair.
+struct ArcIncidence
+{
+    std::vector<std::vector<std::pair<TransitionId, uint32_t>>> producers; // Per place
+    std::vector<std::vector<std::pair<TransitionId, uint32_t>>> consumers; // Per place
+    std::vector<std::vector<std::pair<PlaceId, uint32_t>>> inputs;         // Per transition
+    std::vector<std::vector<std::pair<PlaceId, uint32_t>>> outputs;        // Per transition
+};
+
+/// @brief Partial S-component: a branch of the search.
+struct SComponentBranch
+{
+    std::vector<int8_t> places;   // 1 in the set, -1 left out, 0 undecided
+    std::vector<uint8_t> inputs;  // Input places of every transition in the set
+    std::vector<uint8_t> outputs; // Output places of every transition in the set
+    TransitionIds transitions;    // Transitions touching the set, in the order they were reached
+    size_t settled = 0;           // transitions[0 .. settled) have an input and an output in the set
+};
+
+/// @brief Adds a place and whatever its transitions force in.
+/// @return (bool) false on a conflict: a transition with two inputs or two outputs in the set, a weighted arc, or one
+/// without candidates left.
+static bool addPlace(const ArcIncidence &net, SComponentBranch &branch, PlaceId first)
+{
+    std::vector<PlaceId> queue{first};
+    while (true)
+    {
+        while (!queue.empty())
+        {
+            const PlaceId place = queue.back();
+            queue.pop_back();
+            if (branch.places[place] == 1)
+            {
+                continue;
+            }
+            if (branch.places[place] == -1)
+            {
+                return false;
+            }
+            branch.places[place] = 1;
+            for (const auto &[transition, weight] : net.producers[place])
+            {
+                if (weight != 1 || ++branch.outputs[transition] > 1)
+                {
+                    return false;
+                }
+                if (branch.inputs[transition] == 0)
+                {
+                    branch.transitions.push_back(transition);
+                }
+            }
+            for (const auto &[transition, weight] : net.consumers[place])
+            {
+                if (weight != 1 || ++branch.inputs[transition] > 1)
+                {
+                    return false;
+                }
+                if (branch.outputs[transition] == 0)
+                {
+                    branch.transitions.push_back(transition);
+                }
+            }
+        }
+        // A transition missing a side with a single candidate left takes it
+        while (branch.settled < branch.transitions.size())
+        {
+            const TransitionId transition = branch.transitions[branch.settled];
+            if (branch.inputs[transition] > 0 && branch.outputs[transition] > 0)
+            {
+                branch.settled++;
+                continue;
+            }
+            const bool input = branch.inputs[transition] == 0;
+            PlaceId candidate = INVALID_ID;
+            size_t candidates = 0;
+            for (const auto &[place, weight] : input ? net.inputs[transition] : net.outputs[transition])
+            {
+                if (branch.places[place] == 0 && weight == 1)
+                {
+                    candidate = place;
+                    candidates++;
+                }
+            }
+            if (candidates == 0)
+            {
+                return false;
+            }
+            if (candidates > 1)
+            {
+                return true; // The caller branches
+            }
+            queue.push_back(candidate);
+            break;
+        }
+        if (queue.empty())
+        {
+            return true;
+        }
+    }
+}
+
+/// @brief Whether the places of a closed branch and its transitions form a strongly connected subnet.
+static bool stronglyConnected(const ArcIncidence &net, const SComponentBranch &branch, PlaceId start)
+{
+    // Every transition of the set has one input and one output in it, so it is an edge between two of its places
+    const auto reachesAll = [&](bool forward)
+    {
+        std::vector<bool> seen(branch.places.size(), false);
+        std::vector<PlaceId> queue{start};
+        seen[start] = true;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            for (const auto &[transition, weight] : forward ? net.consumers[queue[head]] : net.producers[queue[head]])
+            {
+                for (const auto &[place, placeWeight] : forward ? net.outputs[transition] : net.inputs[transition])
+                {
+                    if (branch.places[place] == 1 && !seen[place])
+                    {
+                        seen[place] = true;
+                        queue.push_back(place);
+                    }
+                }
+            }
+        }
+        return std::count(branch.places.begin(), branch.places.end(), 1) == static_cast<std::ptrdiff_t>(queue.size());
+    };
+    return reachesAll(true) && reachesAll(false);
+}
+
+/// @brief Depth-first search for an S-component holding a place.
+/// @param complete Set to false if the search gave up.
+/// @return (SComponentBranch) The closed branch, one with no places in the set if there is none.
+static SComponentBranch findSComponent(const ArcIncidence &net, PlaceId start, size_t maxSubproblems, bool &complete)
+{
+    SComponentBranch first;
+    first.places.assign(net.producers.size(), 0);
+    first.inputs.assign(net.inputs.size(), 0);
+    first.outputs.assign(net.inputs.size(), 0);
+    std::vector<std::pair<SComponentBranch, PlaceId>> branches{{first, start}};
+    size_t explored = 0;
+    while (!branches.empty())
+    {
+        if (explored++ == maxSubproblems)
+        {
+            complete = false;
+            break;
+        }
+        auto [branch, place] = std::move(branches.back());
+        branches.pop_back();
+        if (!addPlace(net, branch, place))
+        {
+            continue;
+        }
+        if (branch.settled == branch.transitions.size())
+        {
+            if (stronglyConnected(net, branch, start))
+            {
+                return branch;
+            }
+            continue;
+        }
+        // One branch per candidate for the missing side, each leaving the ones before it out
+        const TransitionId transition = branch.transitions[branch.settled];
+        const bool input = branch.inputs[transition] == 0;
+        std::vector<PlaceId> candidates;
+        for (const auto &[candidate, weight] : input ? net.inputs[transition] : net.outputs[transition])
+        {
+            if (branch.places[candidate] == 0 && weight == 1)
+            {
+                candidates.push_back(candidate);
+            }
+        }
+        for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); candidate++)
+        {
+            SComponentBranch next = branch;
+            for (auto before = candidates.begin(); *before != *candidate; before++)
+            {
+                next.places[*before] = -1;
+            }
+            branches.emplace_back(std::move(next), *candidate);
+        }
+    }
+    return {};
+}
+
+SComponentCover sComponentCover(const PetriNet &net, size_t maxSubproblems)
+{
+    const size_t placeCount = net.getPlaces().size();
+    const size_t transitionCount = net.getTransitions().size();
+    ArcIncidence incidence;
+    incidence.producers.resize(placeCount);
+    incidence.consumers.resize(placeCount);
+    incidence.inputs.resize(transitionCount);
+    incidence.outputs.resize(transitionCount);
+    for (const Edge &arc : net.getArcs())
+    {
+        if (arc.direction == ArcDirection::PlaceToTransition)
+        {
+            incidence.consumers[arc.from].emplace_back(arc.to, arc.weight);
+            incidence.inputs[arc.to].emplace_back(arc.from, arc.weight);
+        }
+        else
+        {
+            incidence.producers[arc.to].emplace_back(arc.from, arc.weight);
+            incidence.outputs[arc.from].emplace_back(arc.to, arc.weight);
+        }
+    }
+
+    SComponentCover cover;
+    std::vector<bool> covered(placeCount, false);
+    for (PlaceId place = 0; place < placeCount; place++)
+    {
+        if (covered[place])
+        {
+            continue;
+        }
+        bool complete = true;
+        const SComponentBranch found = findSComponent(incidence, place, maxSubproblems, complete);
+        cover.complete = cover.complete && complete;
+        if (found.places.empty())
+        {
+            cover.uncovered.push_back(place);
+            continue;
+        }
+        SComponent component;
+        for (PlaceId member = 0; member < placeCount; member++)
+        {
+            if (found.places[member] == 1)
+            {
+                component.places.push_back(member);
+                component.tokens += net.getPlaces()[member].tokens;
+                covered[member] = true;
+            }
+        }
+        component.transitions = found.transitions;
+        std::sort(component.transitions.begin(), component.transitions.end());
+        cover.components.push_back(std::move(component));
+    }
+    return cover;
+}
+
+PlaceBounds placeBounds(const NetView &net, const SComponentCover &cover)
+{
+    PlaceBounds bounds;
+    bounds.tokens.assign(net.placeCount(), UNBOUNDED_PLACE);
+    for (const SComponent &component : cover.components)
+    {
+        for (const PlaceId place : component.places)
+        {
+            bounds.tokens[place] = std::min(bounds.tokens[place], component.tokens);
+        }
+    }
+    return bounds;
+}
@@ -0,0 +1,242 @@
+#include "../include/Siphons.h"
+
+#include <algorithm>
+
+/// @brief maximalSiphon, or maximalTrap with the arcs reversed.
+static std::vector<bool> maximalSet(const NetView &net, std::vector<bool> within, bool trap)
+{
+    // A transition feeding the set must take from it (a siphon), one taking from the set must feed it (a trap)
+    const auto guarded = [&](PlaceId place) { return trap ? net.placePostset(place) : net.placePreset(place); };
+    const auto guards = [&](TransitionId transition) { return trap ? net.postset(transition) : net.preset(transition); };
+    const auto guarding = [&](PlaceId place) { return trap ? net.placePreset(place) : net.placePostset(place); };
+    const auto dependents = [&](TransitionId transition) { return trap ? net.preset(transition) : net.postset(transition); };
+
+    std::vector<uint32_t> inside(net.transitionCount(), 0); // Places of the set on the guarding side of every transition
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        for (const PlaceId place : guards(transition))
+        {
+            inside[transition] += within[place] ? 1 : 0;
+        }
+    }
+    std::vector<PlaceId> removed;
+    const auto remove = [&](PlaceId place)
+    {
+        if (within[place])
+        {
+            within[place] = false;
+            removed.push_back(place);
+        }
+    };
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        if (within[place] && std::any_of(guarded(place).begin(), guarded(place).end(), [&](TransitionId transition) { return inside[transition] == 0; }))
+        {
+            remove(place);
+        }
+    }
+    for (size_t head = 0; head < removed.size(); head++)
+    {
+        for (const TransitionId transition : guarding(removed[head]))
+        {
+            if (--inside[transition] == 0)
+            {
+                for (const PlaceId place : dependents(transition))
+                {
+                    remove(place);
+                }
+            }
+        }
+    }
+    return within;
+}
+
+std::vector<bool> maximalSiphon(const NetView &net, std::vector<bool> within)
+{
+    return maximalSet(net, std::move(within), false);
+}
+
+std::vector<bool> maximalTrap(const NetView &net, std::vector<bool> within)
+{
+    return maximalSet(net, std::move(within), true);
+}
+
+/// @brief Subproblem of the minimal set enumeration.
+struct PlaceSetProblem
+{
+    std::vector<bool> allowed;
+    std::vector<bool> required;
+};
+
+/// @brief minimalSiphons, or minimalTraps with the arcs reversed.
+static MinimalPlaceSets minimalSets(const NetView &net, size_t maxSubproblems, bool trap)
+{
+    const size_t placeCount = net.placeCount();
+    const auto guarding = [&](PlaceId place) { return trap ? net.placePreset(place) : net.placePostset(place); };
+    const auto dependents = [&](TransitionId transition) { return trap ? net.preset(transition) : net.postset(transition); };
+    const auto contains = [&](const std::vector<bool> &set, const std::vector<bool> &subset)
+    {
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            if (subset[place] && !set[place])
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+    const auto empty = [](const std::vector<bool> &set) { return std::none_of(set.begin(), set.end(), [](bool member) { return member; }); };
+    // A place of a minimal siphon (with other places) feeds another place of it through some consumer, or the siphon
+    // would still be one without it. Traps the other way around.
+    const auto needed = [&](PlaceId place, const std::vector<bool> &set)
+    {
+        for (const TransitionId transition : guarding(place))
+        {
+            for (const PlaceId other : dependents(transition))
+            {
+                if (other != place && set[other])
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    MinimalPlaceSets result;
+    std::vector<PlaceSetProblem> problems{{std::vector<bool>(placeCount, true), std::vector<bool>(placeCount, false)}};
+    size_t solved = 0;
+    while (!problems.empty())
+    {
+        if (solved++ == maxSubproblems)
+        {
+            result.complete = false;
+            break;
+        }
+        const PlaceSetProblem problem = std::move(problems.back());
+        problems.pop_back();
+        const std::vector<bool> largest = maximalSet(net, problem.allowed, trap);
+        if (empty(largest) || !contains(largest, problem.required))
+        {
+            continue;
+        }
+        // Shrink to a set minimal among the ones holding the required places
+        std::vector<bool> current = largest;
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            if (!current[place] || problem.required[place])
+            {
+                continue;
+            }
+            std::vector<bool> smaller = current;
+            smaller[place] = false;
+            smaller = maximalSet(net, std::move(smaller), trap);
+            if (!empty(smaller) && contains(smaller, problem.required))
+            {
+                current = std::move(smaller);
+            }
+        }
+        // It is minimal outright unless dropping a required place still leaves a set inside
+        bool minimal = true;
+        bool split = true;
+        std::vector<PlaceId> members;
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            if (!current[place])
+            {
+                continue;
+            }
+            members.push_back(place);
+            if (minimal && problem.required[place])
+            {
+                std::vector<bool> smaller = current;
+                smaller[place] = false;
+                minimal = empty(maximalSet(net, std::move(smaller), trap));
+            }
+            // Every other set of the subproblem is larger than one place, so its required places must be needed
+            split = split && (!problem.required[place] || needed(place, largest));
+        }
+        if (split)
+        {
+            // Any other set of the subproblem misses a place of this one, split by the first one it misses
+            std::vector<bool> required = problem.required;
+            for (const PlaceId place : members)
+            {
+                if (problem.required[place])
+                {
+                    continue;
+                }
+                PlaceSetProblem next{problem.allowed, required};
+                next.allowed[place] = false;
+                problems.push_back(std::move(next));
+                required[place] = true;
+            }
+        }
+        if (minimal)
+        {
+            result.sets.push_back(std::move(members));
+        }
+    }
+    std::sort(result.sets.begin(), result.sets.end());
+    return result;
+}
+
+MinimalPlaceSets minimalSiphons(const NetView &net, size_t maxSubproblems)
+{
+    return minimalSets(net, maxSubproblems, false);
+}
+
+MinimalPlaceSets minimalTraps(const NetView &net, size_t maxSubproblems)
+{
+    return minimalSets(net, maxSubproblems, true);
+}
+
+CommonerReport checkCommonerProperty(const NetView &net, size_t maxSubproblems)
+{
+    CommonerReport report;
+    const MinimalPlaceSets siphons = minimalSiphons(net, maxSubproblems);
+    for (const std::vector<PlaceId> &siphon : siphons.sets)
+    {
+        std::vector<bool> within(net.placeCount(), false);
+        for (const PlaceId place : siphon)
+        {
+            within[place] = true;
+        }
+        const std::vector<bool> trap = maximalTrap(net, std::move(within));
+        bool marked = false;
+        for (const PlaceId place : siphon)
+        {
+            marked = marked || (trap[place] && net.places[place].tokens > 0);
+        }
+        if (!marked)
+        {
+            report.unmarkedSiphon = siphon;
+            return report;
+        }
+    }
+    report.complete = siphons.complete;
+    report.holds = siphons.complete;
+    return report;
+}
+
+bool isFreeChoice(const NetView &net)
+{
+    std::vector<std::vector<PlaceId>> presets(net.transitionCount());
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        presets[transition].assign(net.preset(transition).begin(), net.preset(transition).end());
+        std::sort(presets[transition].begin(), presets[transition].end());
+    }
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        const auto consumers = net.placePostset(place);
+        for (size_t i = 1; i < consumers.size(); i++)
+        {
+            if (presets[consumers[i]] != presets[consumers[0]])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,220 @@
+#include "../include/StateSpace.h"
+#include "../include/FlatHash.h"
+#include "../include/WorkflowStructure.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+/// @brief Hashes a marking word by word, the final mix spreads the bits for power-of-two tables.
+static uint32_t hashMarking(std::span<const int32_t> marking)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const int32_t tokens : marking)
+    {
+        hash ^= static_cast<uint32_t>(tokens);
+        hash *= 0x100000001b3ULL;
+    }
+    return static_cast<uint32_t>(mixHash(hash));
+}
+
+MarkingStore::MarkingStore(size_t placeCount) : stride(placeCount)
+{
+}
+
+std::pair<StateId, bool> MarkingStore::insert(std::span<const int32_t> marking)
+{
+    const uint32_t hash = hashMarking(marking);
+    if ((size() + 1) * 2 > slots.size())
+    {
+        rehash(slots.empty() ? 64 : slots.size() * 2);
+    }
+    const size_t mask = slots.size() - 1;
+    size_t index = hash & mask;
+    while (slots[index] != INVALID_ID)
+    {
+        const StateId state = slots[index];
+        if (hashes[state] == hash && std::equal(marking.begin(), marking.end(), arena.begin() + state * stride))
+        {
+            return {state, false};
+        }
+        index = (index + 1) & mask;
+    }
+    if (size() >= INVALID_ID)
+    {
+        throw std::length_error("Too many states");
+    }
+    const auto state = static_cast<StateId>(size());
+    arena.insert(arena.end(), marking.begin(), marking.end());
+    hashes.push_back(hash);
+    slots[index] = state;
+    return {state, true};
+}
+
+StateId MarkingStore::find(std::span<const int32_t> marking) const
+{
+    if (slots.empty())
+    {
+        return INVALID_ID;
+    }
+    const uint32_t hash = hashMarking(marking);
+    const size_t mask = slots.size() - 1;
+    size_t index = hash & mask;
+    while (slots[index] != INVALID_ID)
+    {
+        const StateId state = slots[index];
+        if (hashes[state] == hash && std::equal(marking.begin(), marking.end(), arena.begin() + state * stride))
+        {
+            return state;
+        }
+        index = (index + 1) & mask;
+    }
+    return INVALID_ID;
+}
+
+std::span<const int32_t> MarkingStore::operator[](StateId state) const
+{
+    return {arena.data() + state * stride, stride};
+}
+
+size_t MarkingStore::size() const
+{
+    return hashes.size();
+}
+
+size_t MarkingStore::placeCount() const
+{
+    return stride;
+}
+
+std::span<const int32_t> MarkingStore::tokens() const
+{
+    return arena;
+}
+
+void MarkingStore::rehash(size_t capacity)
+{
+    slots.assign(capacity, INVALID_ID);
+    const size_t mask = capacity - 1;
+    for (StateId state = 0; state < size(); state++)
+    {
+        size_t index = hashes[state] & mask;
+        while (slots[index] != INVALID_ID)
+        {
+            index = (index + 1) & mask;
+        }
+        slots[index] = state;
+    }
+}
+
+StateSpaceExplorer::StateSpaceExplorer(const NetView &net, std::vector<int32_t> finalMarking)
+    : net(net), finalMarking(std::move(finalMarking)), store(net.placeCount())
+{
+    if (!this->finalMarking.empty() && this->finalMarking.size() != net.placeCount())
+    {
+        throw std::invalid_argument("The final marking must have one entry per place");
+    }
+}
+
+StateSpaceResult StateSpaceExplorer::explore(StateSpaceObserver &observer, size_t maxStates)
+{
+    store = MarkingStore(net.placeCount());
+    StateSpaceResult result;
+    std::vector<int32_t> current(net.placeCount()), next(net.placeCount());
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        current[place] = net.places[place].tokens;
+    }
+    const auto finalFlag = [this](std::span<const int32_t> marking) -> uint8_t
+    {
+        return !finalMarking.empty() && std::equal(marking.begin(), marking.end(), finalMarking.begin()) ? STATE_FINAL : 0;
+    };
+    store.insert(current);
+    observer.onState(0, store[0], STATE_INITIAL | finalFlag(current));
+    for (StateId state = 0; state < store.size(); state++)
+    {
+        // Copy, inserting successors may move the arena
+        const auto marking = store[state];
+        std::copy(marking.begin(), marking.end(), current.begin());
+        bool deadlock = true, truncated = false;
+        for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+        {
+            const auto inputs = net.preset(transition);
+            const auto inputWeights = net.presetWeights(transition);
+            bool enabled = true;
+            for (size_t i = 0; i < inputs.size() && enabled; i++)
+            {
+                enabled = current[inputs[i]] >= static_cast<int32_t>(inputWeights[i]);
+            }
+            if (!enabled)
+            {
+                continue;
+            }
+            deadlock = false;
+            next = current;
+            for (size_t i = 0; i < inputs.size(); i++)
+            {
+                next[inputs[i]] -= static_cast<int32_t>(inputWeights[i]);
+            }
+            const auto outputs = net.postset(transition);
+            const auto outputWeights = net.postsetWeights(transition);
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                next[outputs[i]] += static_cast<int32_t>(outputWeights[i]);
+            }
+            StateId successor;
+            if (maxStates != 0 && store.size() >= maxStates)
+            {
+                // Full, only edges into known states are kept
+                successor = store.find(next);
+                if (successor == INVALID_ID)
+                {
+                    result.complete = false;
+                    truncated = true;
+                    continue;
+                }
+            }
+            else
+            {
+                auto [id, inserted] = store.insert(next);
+                successor = id;
+                if (inserted)
+                {
+                    observer.onState(successor, store[successor], finalFlag(next));
+                }
+            }
+            observer.onEdge(state, transition, successor);
+            result.edges++;
+        }
+        // Reaching the final marking ends a run, it isn't a deadlock
+        const uint8_t finalBit = finalFlag(current);
+        const uint8_t flags = (state == 0 ? STATE_INITIAL : 0) | finalBit | (deadlock && !finalBit ? STATE_DEADLOCK : 0) |
+                              (truncated ? STATE_TRUNCATED : 0);
+        observer.onExpanded(state, current, flags);
+    }
+    result.states = store.size();
+    observer.onFinish(result);
+    return result;
+}
+
+const MarkingStore &StateSpaceExplorer::markings() const
+{
+    return store;
+}
+
+MarkingStore StateSpaceExplorer::releaseMarkings()
+{
+    return std::exchange(store, MarkingStore(net.placeCount()));
+}
+
+std::vector<int32_t> workflowFinalMarking(const NetView &net)
+{
+    const WorkflowPlaces places = findWorkflowPlaces(net);
+    if (places.input == INVALID_ID || places.output == INVALID_ID)
+    {
+        return {};
+    }
+    std::vector<int32_t> marking(net.placeCount(), 0);
+    marking[places.output] = net.places[places.input].tokens;
+    return marking;
+}
@@ -1,16 +1,32 @@
 #include "../include/Utility.h"
+#include "../include/BackwardReachability.h"
+#include "../include/Bisimulation.h"
+#include "../include/Invariants.h"
 #include "../include/Constants.h"
-
+#include "../include/Layout.h"
+#include "../include/LayoutCache.h"
+#include "../include/Livelock.h"
+#include "../include/ProcessStructure.h"
+#include "../include/ReachabilityGraph.h"
+#include "../include/Renderer.h"
+#include "../include/SComponents.h"
+#include "../include/Siphons.h"
+#include "../include/StateSpace.h"
+#include "../include/WorkflowStructure.h"
+
+#include <algorithm>
 #include <vector>
 #include <unordered_set>
 #include <fstream>
 #include <sstream>
 #include <queue>
 #include <set>
+#include <map>
 #include <cmath>
 #include <iostream>
+#include <limits>
 
- Transitions latestFiredTransitions;
+ TransitionIds latestFiredTransitions;
 
 
 /// @brief Converts a positive integer to its ordinal form.
@@ -60,25 +76,21 @@ Places getEnabledPlaces(const PetriNet &net)
 
 /// @brief Gets a vector of transitions that can be fired in the given Petri net.
 /// @param net Petri net state.
-/// @return (std::vector<Transition>) A vector containing the transitions that can be fired/are enabled.
-Transitions getEnabledTransitions(const PetriNet &net)
+/// @return (std::vector<TransitionId>) A vector containing the transitions that can be fired/are enabled.
+TransitionIds getEnabledTransitions(const PetriNet &net)
 {
-    Transitions enabledTransitions;
-    for (auto &transition : net.getTransitions())
+    TransitionIds enabledTransitions;
+    for (TransitionId transition = 0; transition < net.getTransitions().size(); transition++)
     {
         bool enabled = true;
-        for (const auto &arc : net.getArcs())
+        const auto inputs = net.preset(transition);
+        const auto weights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
         {
-            if (arc.direction == ArcDirection::PlaceToTransition)
+            if (net.getPlaces()[inputs[i]].tokens < static_cast<int>(weights[i]))
             {
-                if (arc.to == net.getTransitionMap().at(transition.name))
-                {
-                    if (net.getPlaces().at(arc.from).tokens < 1)
-                    {
-                        enabled = false;
-                        break;
-                    }
-                }
+                enabled = false;
+                break;
             }
         }
         if (enabled)
@@ -92,410 +104,643 @@ Transitions getEnabledTransitions(const PetriNet &net)
 /// @brief Fires a transition in the given Petri net.
 /// @param net Petri net state.
 /// @param transition Transition to be fired, must be enabled.
-void fireTransition(PetriNet &net, const Transition &transition)
+void fireTransition(PetriNet &net, TransitionId transition)
 {
-    for (auto &arc : net.getArcs())
+    const auto inputs = net.preset(transition);
+    const auto inputWeights = net.presetWeights(transition);
+    for (size_t i = 0; i < inputs.size(); i++)
     {
-        if (arc.direction == ArcDirection::PlaceToTransition)
+        net.consumeToken(inputs[i], static_cast<int>(inputWeights[i]));
+    }
+    const auto outputs = net.postset(transition);
+    const auto outputWeights = net.postsetWeights(transition);
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        net.addToken(outputs[i], static_cast<int>(outputWeights[i]));
+    }
+}
+
+/// @brief Reverses a transition firing in the given Petri net.
+/// @param net Petri net state.
+/// @param transition Transition to be unfired, must be valid to unfire.
+void unFireTransition(PetriNet &net, TransitionId transition)
+{
+    const auto outputs = net.postset(transition);
+    const auto outputWeights = net.postsetWeights(transition);
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        net.consumeToken(outputs[i], static_cast<int>(outputWeights[i]));
+    }
+    const auto inputs = net.preset(transition);
+    const auto inputWeights = net.presetWeights(transition);
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        net.addToken(inputs[i], static_cast<int>(inputWeights[i]));
+    }
+}
+
+/// @brief Rebuilds a layered layout from its cached form, the layer in x and the relative rank in y.
+/// @return (bool) false if the cached layers aren't whole numbers below the node count, the layout has to be computed then.
+static bool layeredFromCache(const LayoutPositions &cached, LayeredPositions &layout)
+{
+    const size_t n = cached.size();
+    layout.layer.resize(n);
+    std::vector<std::vector<std::pair<float, uint32_t>>> layers;
+    for (uint32_t node = 0; node < n; node++)
+    {
+        // A layer is a breadth-first distance, so there are fewer layers than nodes
+        const float layer = cached.x[node];
+        if (!(layer >= 0 && layer < static_cast<float>(n)) || layer != std::floor(layer))
         {
-            if (arc.to == net.getTransitionMap().at(transition.name))
-            {
-                net.consumeToken(arc.from);
-            }
+            return false;
         }
-        else
+        layout.layer[node] = static_cast<uint32_t>(layer);
+        if (layout.layer[node] >= layers.size())
         {
-            if (arc.from == net.getTransitionMap().at(transition.name))
-            {
-                net.addToken(arc.to);
-            }
+            layers.resize(layout.layer[node] + 1);
+        }
+        layers[layout.layer[node]].emplace_back(cached.y[node], node);
+    }
+    layout.rank.resize(n);
+    layout.layerSizes.clear();
+    for (auto &layerNodes : layers)
+    {
+        std::sort(layerNodes.begin(), layerNodes.end());
+        for (uint32_t rank = 0; rank < layerNodes.size(); rank++)
+        {
+            layout.rank[layerNodes[rank].second] = rank;
         }
+        layout.layerSizes.push_back(static_cast<uint32_t>(layerNodes.size()));
     }
+    return true;
 }
 
-/// @brief Reverses a transition firing in the given Petri net.
-/// @param net Petri net state.
-/// @param transition Transition to be unfired, must be valid to unfire.
-void unFireTransition(PetriNet &net, const Transition &transition)
+/// @brief Lays out a net drawing in layers, see writePetriNetToSVG.
+/// Places are nodes p0 .. and transitions t0 .., in the order of the net; the places hold their current tokens.
+static Drawing drawNet(const PetriNet &net, const std::string &filename, const LayoutOptions &options)
 {
-    for (auto &arc : net.getArcs())
+    LayoutGraph graph; // Places are nodes 0 .. P - 1 and transitions P .. P + T - 1
+    LayeredPositions layout;
+    const auto placeCount = static_cast<uint32_t>(net.getPlaces().size());
+    graph.nodeCount = placeCount + net.getTransitions().size();
+    std::vector<bool> hasInputs(placeCount, false);
+    for (const Edge &arc : net.getArcs())
     {
         if (arc.direction == ArcDirection::PlaceToTransition)
         {
-            if (arc.to == net.getTransitionMap().at(transition.name))
-            {
-                net.addToken(arc.from);
-            }
+            graph.edges.emplace_back(arc.from, placeCount + arc.to);
         }
         else
         {
-            if (arc.from == net.getTransitionMap().at(transition.name))
+            graph.edges.emplace_back(placeCount + arc.from, arc.to);
+            hasInputs[arc.to] = true;
+        }
+    }
+    // Structural sources keep the layout the same whatever the marking, marked places are the fallback
+    std::vector<uint32_t> sources;
+    for (PlaceId place = 0; place < placeCount; place++)
+    {
+        if (!hasInputs[place])
+        {
+            sources.push_back(place);
+        }
+    }
+    if (sources.empty())
+    {
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            if (net.getPlaces()[place].tokens > 0)
             {
-                net.consumeToken(arc.to);
+                sources.push_back(place);
             }
         }
     }
-}
+    std::vector<std::string> keys;
+    keys.reserve(graph.nodeCount);
+    for (PlaceId place = 0; place < placeCount; place++)
+    {
+        keys.push_back("p " + std::string(net.placeName(place)));
+    }
+    for (TransitionId transition = 0; transition < net.getTransitions().size(); transition++)
+    {
+        keys.push_back("t " + std::string(net.transitionName(transition)));
+    }
 
-/// @brief Checks if the given Petri net is in a final state.
-/// @param net Petri net state.
-/// @return (Bool) True if the Petri net is in a final state, false otherwise.
-bool isFinalState(const PetriNet &net, int target)
-{
-    for (const auto &place : net.getPlaces())
+    const LayoutCache cache(options.cacheDirectory);
+    const uint64_t fingerprint = graphFingerprint(graph, keys, "layered");
+    LayoutPositions cached;
+    if (!cache.find(fingerprint, keys, cached) || !layeredFromCache(cached, layout))
     {
-        if (place.tokens > 0 && place.name != "o")
+        // Nodes of the previous version of the drawing start in the order they had there
+        std::vector<bool> known;
+        std::vector<float> initialOrder;
+        if (cache.warmStart(filename, keys, cached, known) > 0)
         {
-            return false;
+            initialOrder.assign(graph.nodeCount, std::numeric_limits<float>::quiet_NaN());
+            for (size_t node = 0; node < graph.nodeCount; node++)
+            {
+                if (known[node])
+                {
+                    initialOrder[node] = cached.y[node];
+                }
+            }
         }
-        if ((place.tokens == 0 || place.tokens != target) && place.name == "o")
+        layeredLayout(graph, sources, layout, LAYERED_SWEEPS, initialOrder);
+        for (size_t node = 0; node < graph.nodeCount; node++)
         {
-            return false;
+            cached.x[node] = static_cast<float>(layout.layer[node]);
+            cached.y[node] = (static_cast<float>(layout.rank[node]) + 0.5f) / static_cast<float>(layout.layerSizes[layout.layer[node]]);
+        }
+        cache.store(filename, fingerprint, keys, cached);
+    }
+
+    // Layers go from left to right, each centred vertically
+    Drawing drawing;
+    const int margin = SPACE_BETWEEN_NODES / 2;
+    const uint32_t tallest = layout.layerSizes.empty() ? 1 : *std::max_element(layout.layerSizes.begin(), layout.layerSizes.end());
+    drawing.width = 2 * margin + LAYER_SPACING * std::max(0, static_cast<int>(layout.layerSizes.size()) - 1);
+    drawing.height = 2 * margin + LAYER_NODE_SPACING * (static_cast<int>(tallest) - 1) + 2 * NODE_RADIUS;
+    drawing.nodes.resize(graph.nodeCount);
+    for (size_t node = 0; node < graph.nodeCount; node++)
+    {
+        const uint32_t layer = layout.layer[node];
+        DrawingNode &shape = drawing.nodes[node];
+        shape.x = margin + layer * LAYER_SPACING;
+        shape.y = margin + NODE_RADIUS + LAYER_NODE_SPACING * (layout.rank[node] + (tallest - layout.layerSizes[layer]) / 2.0);
+        if (node < placeCount)
+        {
+            shape.id = "p" + std::to_string(node);
+            shape.label = net.placeName(static_cast<PlaceId>(node));
+            shape.tokens = net.getPlaces()[node].tokens;
+        }
+        else
+        {
+            const auto transition = static_cast<TransitionId>(node - placeCount);
+            shape.id = "t" + std::to_string(transition);
+            shape.shape = NodeShape::Box;
+            shape.label = "t" + std::to_string(transition + 1);
+            shape.caption = net.transitionName(transition);
         }
     }
-    return true;
+
+    // Arcs are straight between adjacent layers and bent otherwise so they go around the nodes in between
+    drawing.edges.reserve(graph.edges.size());
+    for (const auto &[from, to] : graph.edges)
+    {
+        DrawingEdge &arc = drawing.edges.emplace_back();
+        arc.from = from;
+        arc.to = to;
+        arc.color = from < placeCount ? DrawingColor::Dark : DrawingColor::Blue;
+        const double x1 = drawing.nodes[from].x, y1 = drawing.nodes[from].y;
+        const double x2 = drawing.nodes[to].x, y2 = drawing.nodes[to].y;
+        if (layout.layer[to] == layout.layer[from] + 1)
+        {
+            // Calculate normalized direction vector
+            const double length = std::max(std::hypot(x2 - x1, y2 - y1), 1.0);
+            const double nx = (x2 - x1) / length;
+            const double ny = (y2 - y1) / length;
+            arc.x1 = x1 + nx * NODE_RADIUS;
+            arc.y1 = y1 + ny * NODE_RADIUS;
+            arc.x2 = x2 - nx * (NODE_RADIUS + 10);
+            arc.y2 = y2 - ny * (NODE_RADIUS + 10);
+            continue;
+        }
+        // Bend below the straight line for backward arcs and above it for long forward arcs
+        const double bend = (layout.layer[to] <= layout.layer[from] ? 1 : -1) * LAYER_NODE_SPACING * 0.75;
+        arc.curved = true;
+        arc.controlX = (x1 + x2) / 2;
+        arc.controlY = (y1 + y2) / 2 + bend;
+        const double startLength = std::max(std::hypot(arc.controlX - x1, arc.controlY - y1), 1.0);
+        const double endLength = std::max(std::hypot(x2 - arc.controlX, y2 - arc.controlY), 1.0);
+        arc.x1 = x1 + (arc.controlX - x1) / startLength * NODE_RADIUS;
+        arc.y1 = y1 + (arc.controlY - y1) / startLength * NODE_RADIUS;
+        arc.x2 = x2 - (x2 - arc.controlX) / endLength * (NODE_RADIUS + 10);
+        arc.y2 = y2 - (y2 - arc.controlY) / endLength * (NODE_RADIUS + 10);
+    }
+    return drawing;
 }
 
-/// @brief Converts a Petri net to an SVG file.
+/// @brief Converts a Petri net to an SVG file, written in the background by renderQueue().
+/// Nodes are drawn in layers from the places without inputs (i in a workflow net) onwards, see layeredLayout.
+/// The layout is kept in the layout cache, the frames of a witness share it and a changed net starts from it.
 /// @param net Petri net to convert.
-/// @param filename Filename to save the SVG file to. (Must include .svg in the end)
-void writePetriNetToSVG(const PetriNet &net, const std::string &filename)
+/// @param filename Filename to save the drawing to, the extension picks the format (.svg, .dot or .json).
+/// @param options Only the cache directory is used
+void writePetriNetToSVG(const PetriNet &net, const std::string &filename, const LayoutOptions &options)
 {
-    // Constants
-    const int width = SPACE_BETWEEN_NODES * std::max((int)net.getPlaces().size(), (int)net.getTransitions().size()) + 100;
-    const int height = SPACE_BETWEEN_NODES * 2 + 100;
-
-    std::ofstream file(filename);
-    // Define SVG header
-    file << R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1" width=")" << width << "\" height=\"" << height
-         << "\">" << std::endl;
-    file << "<defs>" << std::endl;
-    // Define arrowheads using Xiketic and Blue Jeans colors
-    file << R"(<marker
-      id="arrowheadBlue"
-      viewBox="0 0 10 10"
-      refX="1"
-      refY="5"
-      markerUnits="strokeWidth"
-      markerWidth="5"
-      markerHeight="5"
-      orient="auto">
-      <path d="M 0 0 L 10 5 L 0 10 z" fill="#38B6FF" />)"
-         << std::endl;
-    file << "</marker>" << std::endl;
-    file << R"(<marker
-      id="arrowhead"
-      viewBox="0 0 10 10"
-      refX="1"
-      refY="5"
-      markerUnits="strokeWidth"
-      markerWidth="5"
-      markerHeight="5"
-      orient="auto">
-      <path d="M 0 0 L 10 5 L 0 10 z" fill="#121420" />)"
-         << std::endl;
-    file << "</marker>" << std::endl;
-    file << "</defs>" << std::endl;
-    // Write places
-    for (int i = 0; i < net.getPlaces().size(); i++)
-    {
-        const int x = SPACE_BETWEEN_NODES + i * SPACE_BETWEEN_NODES;
-        const int y = SPACE_BETWEEN_NODES;
-        file << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"" << NODE_RADIUS
-             << R"(" stroke="#121420" stroke-width="2" fill="white" />)" << std::endl;
-        int offset = -5;
-        if (net.getPlaces()[i].tokens)
-        {
-            file << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"" << NODE_RADIUS / 2
-                 << R"(" stroke="none" fill="#121420" />)" << std::endl;
-            offset = NODE_RADIUS + 20;
-        }
-
-        file << "<text x=\"" << x << "\" y=\"" << y - offset << R"(" font-size="20" text-anchor="middle">)"
-             << net.getPlaces()[i].name << "</text>" << std::endl;
-    }
-
-    // Write transitions
-    for (int i = 0; i < net.getTransitions().size(); i++)
-    {
-        const int x = SPACE_BETWEEN_NODES + i * SPACE_BETWEEN_NODES;
-        const int y = SPACE_BETWEEN_NODES * 2;
-        file << "<rect x=\"" << x - NODE_RADIUS << "\" y=\"" << y - NODE_RADIUS << "\" width=\"" << 2 * NODE_RADIUS << "\" height=\""
-             << 2 * NODE_RADIUS << R"(" stroke="#121420" stroke-width="2" fill="white" />)" << std::endl;
-        file << "<text x=\"" << x << "\" y=\"" << y + 5 << R"(" font-size="20" text-anchor="middle">)"
-             << "t" + std::to_string(i + 1) << "</text>" << std::endl;
-        file << "<text x=\"" << x << "\" y=\"" << y + NODE_RADIUS + 20 << R"(" font-size="20" text-anchor="middle">)"
-             << net.getTransitions()[i].name << "</text>" << std::endl;
-    }
-
-    // Write arcs
-    for (auto &entry : net.getArcs())
-    {
-        // Constants, calculate start and end points coordinates
-        const int from = entry.from;
-        const int to = entry.to;
-        const int x1 = SPACE_BETWEEN_NODES + from * SPACE_BETWEEN_NODES;
-        const int y1 = SPACE_BETWEEN_NODES;
-        const int x2 = SPACE_BETWEEN_NODES + to * SPACE_BETWEEN_NODES;
-        const int y2 = SPACE_BETWEEN_NODES * 2;
-
-        // Calculate normalized direction vector
-        const int dx = x2 - x1;
-        const int dy = y2 - y1;
-        const double length = std::sqrt(dx * dx + dy * dy) - 20;
-        const double nx = dx / length;
-        const double ny = dy / length;
-        // Decide direction based on ArcDirection
-        if (entry.direction == ArcDirection::PlaceToTransition)
-            file << "<line x1=\"" << x1 + nx * NODE_RADIUS << "\" y1=\"" << y1 + ny * NODE_RADIUS << "\" x2=\"" << x2 - nx * NODE_RADIUS << "\" y2=\"" << y2 - ny * NODE_RADIUS << "\" stroke=\"#121420\" stroke-width=\"2\" marker-end=\"url(#arrowhead)\"/>" << std::endl;
-        else
-            file << "<line x1=\"" << x1 + nx * NODE_RADIUS << "\" y2=\"" << y1 + ny * NODE_RADIUS << "\" x2=\"" << x2 - nx * NODE_RADIUS << "\" y1=\"" << y2 - ny * NODE_RADIUS << "\" stroke=\"#38B6FF\" stroke-width=\"2\" marker-end=\"url(#arrowheadBlue)\"/>" << std::endl;
-    }
-    // End SVG file
-    file << "</svg>" << std::endl;
-    file.close();
+    renderQueue().submit(drawNet(net, filename, options), filename);
 }
 
-/// @brief Determines if a Petri net is a workflow net
+/// @brief Determines if a Petri net is a workflow net, see validateWorkflowNet for the defects it looks for
 /// @param net Petri net to check
 /// @return (bool) true if the net is a workflow net, false otherwise
 bool isWorkflowNet(const PetriNet &net)
 {
-    int iCount = 0, oCount = 0;
-    int iIndex = -1, oIndex = -1;
-    // Check if there is a specific input place i and output place o
-    for (int i = 0; i < net.getPlaces().size(); i++)
+    return validateWorkflowNet(net.view()).valid();
+}
+
+/// @brief Proves a workflow net with one initial token sound without exploring it. The net is sound exactly if its
+/// short-circuited net is live and bounded (van der Aalst). A free-choice net is live exactly if every siphon holds a
+/// marked trap (Commoner), and S-components covering every place bound it.
+/// @param net Workflow net to check
+/// @param structure Result of validateWorkflowNet for the net, without defects
+/// @return (bool) true if the net is proven sound, false if it isn't free-choice or the proof fails
+bool provenSound(const NetView &net, const WorkflowStructure &structure)
+{
+    if (!net.ordinary || net.places[structure.input].tokens != 1 || !isFreeChoice(net))
     {
-        const Place &place = net.getPlaces()[i];
-        if (place.name == "i")
+        return false;
+    }
+    const PetriNet loop = shortCircuitNet(net, structure.input, structure.output);
+    const NetView loopView = loop.view();
+    // A live and bounded free-choice net is covered by S-components, the invariants are only needed if the search gives up
+    const SComponentCover cover = sComponentCover(loop);
+    const bool bounded = cover.complete ? cover.covers() : placeBounds(loopView, placeInvariants(loopView)).bounded();
+    return bounded && checkCommonerProperty(loopView).holds;
+}
+
+/// @brief Fires one enabled transition after the other, the one fired least so far first (the lowest id among equals),
+/// until the final marking is reached. Every marking of a sound net can still complete, so this finds a witness
+/// without storing any state unless the net keeps choosing a loop.
+/// @param net Net to run, its current tokens are the initial marking
+/// @param finalMarking Marking to reach
+/// @param maxSteps Give up after this many firings
+/// @return (TransitionIds) The firing sequence, empty if the final marking wasn't reached
+static TransitionIds simulateCompletion(const NetView &net, std::span<const int32_t> finalMarking, size_t maxSteps)
+{
+    std::vector<int32_t> marking(net.placeCount());
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        marking[place] = net.places[place].tokens;
+    }
+    std::vector<uint32_t> fired(net.transitionCount(), 0);
+    TransitionIds run;
+    while (!std::equal(marking.begin(), marking.end(), finalMarking.begin(), finalMarking.end()))
+    {
+        TransitionId next = INVALID_ID;
+        for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
         {
-            if (place.tokens < 1)
+            const auto inputs = net.preset(transition);
+            const auto weights = net.presetWeights(transition);
+            bool enabled = true;
+            for (size_t i = 0; enabled && i < inputs.size(); i++)
+            {
+                enabled = marking[inputs[i]] >= static_cast<int32_t>(weights[i]);
+            }
+            if (enabled && (next == INVALID_ID || fired[transition] < fired[next]))
             {
-                return false;
+                next = transition;
             }
-            iCount++;
-            iIndex = i;
         }
-        else if (place.tokens > 0)
+        if (next == INVALID_ID || run.size() == maxSteps)
         {
-            // If there is a non-input place with tokens, return false
-            return false;
+            return {};
         }
-        else if (place.name == "o")
+        const auto inputs = net.preset(next);
+        const auto inputWeights = net.presetWeights(next);
+        for (size_t i = 0; i < inputs.size(); i++)
         {
-            oCount++;
-            oIndex = i;
+            marking[inputs[i]] -= static_cast<int32_t>(inputWeights[i]);
         }
+        const auto outputs = net.postset(next);
+        const auto outputWeights = net.postsetWeights(next);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            marking[outputs[i]] += static_cast<int32_t>(outputWeights[i]);
+        }
+        fired[next]++;
+        run.push_back(next);
     }
-    if (iCount != 1 || oCount != 1)
-    {
-        // If there is not exactly one input place i and one output place o, return false
-        return false;
-    }
-    // Check that i has no incoming edges and o has no outgoing edges
-    return std::all_of(net.getArcs().begin(), net.getArcs().end(), [&](const Edge &arc)
-    {
-        if (arc.to == iIndex && arc.direction == ArcDirection::TransitionToPlace) {
-            return false;
+    return run;
+}
+
+/// @brief First run to the final marking that a depth-first search over the graph finds, trying the transitions in id
+/// order: the witness the interactive mode has always shown.
+/// @param graph Graph explored with the final marking, the initial state isn't final
+/// @return (TransitionIds) The firing sequence, empty if no state is final
+static TransitionIds firstCompletion(const ReachabilityGraph &graph)
+{
+    std::vector<bool> seen(graph.stateCount(), false);
+    std::vector<std::pair<StateId, size_t>> stack{{0, 0}}; // State and the next of its edges to follow
+    TransitionIds run;                                     // Transitions leading to the states on the stack
+    seen[0] = true;
+    while (!stack.empty())
+    {
+        const auto [state, edge] = stack.back();
+        const auto successors = graph.successors(state);
+        if (edge == successors.size())
+        {
+            stack.pop_back();
+            if (!run.empty())
+            {
+                run.pop_back();
+            }
+            continue;
         }
-        if (arc.from == oIndex && arc.direction == ArcDirection::PlaceToTransition) {
-            return false;
+        stack.back().second++;
+        const StateId successor = successors[edge];
+        if (graph.flags(successor) & STATE_FINAL)
+        {
+            run.push_back(graph.successorTransitions(state)[edge]);
+            return run;
         }
-
-        return true; });
+        if (!seen[successor])
+        {
+            seen[successor] = true;
+            run.push_back(graph.successorTransitions(state)[edge]);
+            stack.emplace_back(successor, 0);
+        }
+    }
+    return {};
 }
 
-
-/// @brief Performs a depth-first search on a Petri net to find a valid path
-/// @param states states found
-/// @param statesSet set to keep track of duplicate states
-/// @param initialTokens Initial tokens in the input place
-/// @param net  Petri net to search
-/// @param firedTransitions Transitions that have already been fired
-/// @param depth Current depth of the search
-/// @return (bool) true if a valid path was found, false otherwise
-bool getFinalSpace(PetriNet net, std::vector<std::pair<Places, Transitions>> &states, std::unordered_set<Places, PlacesHash> &statesSet, int initialTokens = 1, Transitions firedTransitions = {}, int depth = 0) // NOLINT(misc-no-recursion)
+/// @brief Checks the soundness of a Petri net without printing or writing any files.
+/// @param view View of the net to check, e.g. of a mapped binary net, which is used in place
+/// @param fragmentThreads Threads verifying the fragments of a decomposed net (see verifyFragments), 1 verifies them
+/// on the calling thread, e.g. from a worker of a pool already using every core
+/// @return (SoundnessReport) Verdict together with the diagnostics that led to it
+SoundnessReport verifySoundness(const NetView &view, size_t fragmentThreads)
 {
-    // Instant termination conditions
-    bool flag = false;
-    if (depth > 100)
+    SoundnessReport report;
+    // The structure is checked first, malformed nets never reach the state-space searches
+    const WorkflowStructure structure = validateWorkflowNet(view);
+    report.structureIssues = structure.issues;
+    report.workflowNet = report.structureIssues.empty();
+    if (!report.workflowNet)
+    {
+        return report;
+    }
+    if (provenSound(view, structure))
+    {
+        // Only the witness is left to find, a live net reaches the final marking
+        report.sound = report.finalReachable = report.provenStructurally = report.coveredByInvariants = true;
+        const std::vector<int32_t> finalMarking = workflowFinalMarking(view);
+        report.witness = simulateCompletion(view, finalMarking, 16 * (view.placeCount() + view.transitionCount()));
+        if (report.witness.empty())
+        {
+            report.witness = shortestCompletion(view, checkOptionToComplete(view, finalMarking));
+        }
+        return report;
+    }
+    // A well-structured net splits into fragments, each explored on its own
+    if (view.places[structure.input].tokens == 1)
     {
-        return false;
+        const ProcessStructureTree tree = decomposeWorkflowNet(view, structure);
+        if (tree.fragments.size() > 1)
+        {
+            const DecomposedSoundness fragments = verifyFragments(view, tree, fragmentThreads);
+            if (fragments.sound)
+            {
+                report.sound = report.finalReachable = true;
+                report.fragments = tree.fragments.size();
+                report.states = fragments.states;
+                report.witness = fragments.witness;
+                return report;
+            }
+        }
     }
-    if (depth == 0 && !isWorkflowNet(net))
+    const std::vector<int32_t> finalMarking = workflowFinalMarking(view);
+    // Every question is answered by one exploration
+    const ReachabilityGraph graph(view, finalMarking, DEFAULT_STATE_LIMIT);
+    report.states = graph.stateCount();
+    report.complete = graph.complete();
+    const std::vector<StateId> finalStates = graph.statesWith(STATE_FINAL);
+    report.finalReachable = !finalStates.empty();
+    if (report.finalReachable)
     {
-        return false;
+        report.witness = firstCompletion(graph);
     }
-    // Get all enabled transitions
-    Transitions enabledTransitions = getEnabledTransitions(net);
-    if (!statesSet.count(net.getPlaces()))
+    if (!graph.complete())
     {
-        statesSet.insert(net.getPlaces());
-        states.emplace_back(net.getPlaces(), firedTransitions);
+        // The invariants can still bound the net, and the final marking is unreachable if one weighs it differently
+        // from the initial marking. A complete graph answers both, so they are only computed here
+        const InvariantBasis invariants = placeInvariants(view);
+        report.coveredByInvariants = placeBounds(view, invariants).bounded();
+        std::vector<int32_t> initialMarking(view.placeCount());
+        for (PlaceId place = 0; place < view.placeCount(); place++)
+        {
+            initialMarking[place] = view.places[place].tokens;
+        }
+        report.finalExcluded = std::any_of(invariants.invariants.begin(), invariants.invariants.end(),
+                                           [&](const Invariant &invariant) { return separates(invariant, initialMarking, finalMarking); });
     }
-    else
+    // A transition labelling no edge never fires, unless the state limit hid the edge
+    if (graph.complete())
     {
-        return false;
+        std::vector<bool> fired(view.transitionCount(), false);
+        for (StateId state = 0; state < graph.stateCount(); state++)
+        {
+            for (const TransitionId transition : graph.successorTransitions(state))
+            {
+                fired[transition] = true;
+            }
+        }
+        for (TransitionId transition = 0; transition < view.transitionCount(); transition++)
+        {
+            if (!fired[transition])
+            {
+                report.deadTransitions.push_back(transition);
+            }
+        }
     }
-    // If there are no enabled transitions, return false
-    if (enabledTransitions.empty())
+    // Option to complete: the final states are searched backwards from, over the edges just explored
+    const std::vector<bool> completes = graph.canReach(finalStates);
+    const bool allComplete = std::all_of(completes.begin(), completes.end(), [](bool value) { return value; });
+    report.sound = report.complete && report.finalReachable && allComplete && report.deadTransitions.empty();
+    if (allComplete)
     {
-        return false;
+        return report;
     }
-    // Enable each transition and check if the net is in a final state
-    for (auto &transition : enabledTransitions)
+    // Some states can't complete, the bottom components they end up in tell deadlocks from livelocks
+    PlaceSet deadlocks;
+    for (const StuckComponent &component : findStuckComponents(graph))
     {
-        fireTransition(net, transition);
-        firedTransitions.push_back(transition);
-        if (isFinalState(net, initialTokens))
+        std::vector<bool> marked(view.placeCount(), false);
+        for (const StateId state : component.states)
         {
-            // If the net is in a final state, print all states leading to it, then return true
-            latestFiredTransitions = firedTransitions;
-            writePetriNetToSVG(net, convertToOrdinal((int)firedTransitions.size() + 1) + ".svg");
-            for (int i = (int)firedTransitions.size() - 1; i >= 0; i--)
+            const auto tokens = graph.marking(state);
+            for (PlaceId place = 0; place < view.placeCount(); place++)
             {
-                Places enabledPlaces = getEnabledPlaces(net);
-                unFireTransition(net, firedTransitions[i]);
-                writePetriNetToSVG(net, convertToOrdinal(i + 1) + ".svg");
+                marked[place] = marked[place] || tokens[place] > 0;
             }
-            Places enabledPlaces = getEnabledPlaces(net);
-            return true;
         }
-        if (getFinalSpace(net, states, statesSet, initialTokens, firedTransitions, depth + 1))
+        std::vector<PlaceId> places;
+        for (PlaceId place = 0; place < view.placeCount(); place++)
         {
-            flag = true;
+            if (marked[place])
+            {
+                places.push_back(place);
+            }
+        }
+        if (!component.deadlock)
+        {
+            report.livelocks.push_back(std::move(places));
+            continue;
+        }
+        for (const PlaceId place : places)
+        {
+            if (deadlocks.insert(place))
+            {
+                report.deadlockPlaces.push_back(place);
+            }
         }
-        firedTransitions.pop_back();
-        // Undo the transition
-        unFireTransition(net, transition);
     }
-    return flag;
+    return report;
 }
 
-/// @brief Determines if all transitions in a PetriNet could be enabled
-/// @param net Petri net to check
-/// @param possibleTransitions Set of transitions that could be enabled
-/// @param initialTokens Number of tokens initially in the input place
-/// @param depth Maximum depth of the search
-/// @return (bool) True if all transitions could be enabled, false otherwise
-bool allTransitionsEnabled(PetriNet net, TransitionSet &possibleTransitions, int initialTokens = 1, int depth = 0) // NOLINT(misc-no-recursion)
+/// @brief Checks the soundness of a Petri net without printing or writing any files, see verifySoundness(const NetView &, size_t).
+SoundnessReport verifySoundness(const PetriNet &net, size_t fragmentThreads)
 {
-    // Instant termination conditions
-    if (depth > 100)
-    {
-        return false;
-    }
-    if (depth == 0 && !isWorkflowNet(net))
-    {
-        return false;
-    }
-    // Get all enabled transitions
-    Transitions enabledTransitions = getEnabledTransitions(net);
-    // If there are no enabled transitions, return false
-    if (enabledTransitions.empty())
+    return verifySoundness(net.view(), fragmentThreads);
+}
+
+/// @brief Saves the states along a firing sequence, as the animated witness.svg or (ANIMATE_WITNESS off) as 1st.svg, 2nd.svg, ..
+/// @param net Petri net in its initial state
+/// @param witness Firing sequence to replay
+void writeWitnessToSVG(const PetriNet &net, const TransitionIds &witness)
+{
+    if (ANIMATE_WITNESS)
     {
-        return false;
+        writeAnimatedWitnessToSVG(net, witness, "witness.svg");
+        return;
     }
-    else if (possibleTransitions.size() == net.getTransitions().size())
+    PetriNet current = net;
+    writePetriNetToSVG(current, convertToOrdinal(1) + ".svg");
+    for (size_t i = 0; i < witness.size(); i++)
     {
-        return true;
+        fireTransition(current, witness[i]);
+        writePetriNetToSVG(current, convertToOrdinal(static_cast<int>(i) + 2) + ".svg");
     }
-    // Enable each transition and check if the net is in a final state
-    for (auto &transition : enabledTransitions)
-    {
-        possibleTransitions.insert(transition);
-        fireTransition(net, transition);
-        if (isFinalState(net, initialTokens))
+}
+
+/// @brief Writes a firing sequence as one animated drawing: the net is drawn once and the frames switch the
+/// tokens, the highlighted transition and the caption every WITNESS_STEP_SECONDS, starting over at the end.
+/// @param net Petri net in its initial marking.
+/// @param witness Transitions to fire, in order.
+/// @param filename Filename to save the drawing to, written in the background by renderQueue().
+/// @param options Only the cache directory is used, the layout is shared with writePetriNetToSVG.
+void writeAnimatedWitnessToSVG(const PetriNet &net, const TransitionIds &witness, const std::string &filename, const LayoutOptions &options)
+{
+    Drawing drawing = drawNet(net, filename, options);
+    const auto placeCount = static_cast<uint32_t>(net.getPlaces().size());
+    // Frame 0 is the initial marking, every other frame outlines the transition that led to it
+    drawing.frames.resize(witness.size() + 1);
+    PetriNet current = net;
+    for (size_t frame = 0; frame < drawing.frames.size(); frame++)
+    {
+        DrawingFrame &step = drawing.frames[frame];
+        if (frame == 0)
         {
-            return enabledTransitions.size() == net.getTransitions().size();
+            step.caption = "Initial marking";
         }
-        if (allTransitionsEnabled(net, possibleTransitions, initialTokens, depth + 1))
+        else
         {
-            return true;
+            fireTransition(current, witness[frame - 1]);
+            step.highlighted = placeCount + witness[frame - 1];
+            step.caption = "Step " + std::to_string(frame) + "/" + std::to_string(witness.size()) + ": " + std::string(net.transitionName(witness[frame - 1]));
+        }
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            if (current.getPlaces()[place].tokens > 0)
+            {
+                step.marked.push_back(place);
+            }
         }
-        // Undo the transition
-        unFireTransition(net, transition);
     }
-    return false;
+    renderQueue().submit(std::move(drawing), filename);
 }
 
-/// @brief Determines if a Petri net is sound
+/// @brief Determines if a Petri net is sound, printing the diagnostics and saving the path to the final state
 /// @param net Petri net to check
 /// @return (bool) true if the net is sound, false otherwise
 bool isSound(const PetriNet &net)
 {
-    if (!isWorkflowNet(net))
+    SoundnessReport report = verifySoundness(net);
+    if (!report.workflowNet)
     {
         std::cout << "Not a workflow net" << std::endl;
+        for (const WorkflowIssue &issue : report.structureIssues)
+        {
+            std::cout << describeWorkflowIssue(net.view(), issue) << std::endl;
+        }
         return false;
     }
-    bool flag = true;
-    TransitionSet possibleTransitions;
-    if (!allTransitionsEnabled(net, possibleTransitions))
+    for (const TransitionId transition : report.deadTransitions)
     {
-        for (auto &transition : net.getTransitions())
-        {
-            if (possibleTransitions.find(transition) == possibleTransitions.end())
-            {
-                std::cout << "Transition " << transition.name << " couldn't be enabled" << std::endl;
-            }
-        }
-        flag = false;
+        std::cout << "Transition " << net.transitionName(transition) << " couldn't be enabled" << std::endl;
+    }
+    if (!report.complete)
+    {
+        std::cout << "Stopped after " << report.states << " states" << (report.coveredByInvariants ? "" : ", the net may be unbounded") << std::endl;
     }
-    std::vector<std::pair<Places, Transitions>> places;
-    std::unordered_set<Places, PlacesHash> statesSet;
-    std::vector<std::pair<Places, Transitions>> states;
-    int initialTokens = net.getPlaces()[net.getPlaceMap().at("i")].tokens;
-    if (!getFinalSpace(net, states, statesSet, initialTokens, {}, 0))
+    if (!report.finalReachable && (report.complete || report.finalExcluded))
     {
         std::cout << "Can't reach final state" << std::endl;
-        flag = false;
     }
-    PetriNet net2 = net;
-    PlaceSet deadlocks;
-    for (int i = 0; i < states.size(); i++)
+    if (!report.deadlockPlaces.empty())
     {
-        net2.setPlaces(states[i].first) ;
-        if (!getFinalSpace(net2, states, statesSet, initialTokens, states[i].second, 10))
+        std::cout << "Deadlocks found: ";
+        for (const PlaceId place : report.deadlockPlaces)
         {
-            if (getEnabledTransitions(net2).empty())
-            {
-                for (auto &place : net2.getPlaces())
-                {
-                    if (place.tokens > 0)
-                    {
-                        deadlocks.insert(place);
-                    }
-                }
-            }
+            std::cout << net.placeName(place) << " ";
         }
+        std::cout << std::endl;
     }
-    if (!deadlocks.empty())
+    for (const std::vector<PlaceId> &livelock : report.livelocks)
     {
-        std::cout << "Deadlocks found: ";
-        for (auto &place : deadlocks)
+        std::cout << "Livelock found: ";
+        for (const PlaceId place : livelock)
         {
-            std::cout << place.name << " ";
+            std::cout << net.placeName(place) << " ";
         }
         std::cout << std::endl;
-        flag = false;
     }
-    // Soundness Check is Complete
-    return flag;
+    if (report.finalReachable)
+    {
+        // Rendering happens after the search so the search itself has no side effects
+        latestFiredTransitions = report.witness;
+        writeWitnessToSVG(net, report.witness);
+    }
+    return report.sound;
 }
 
-//
+/// @brief Describes a marking by its marked places, places holding more than one token get the count after a colon
+/// @param net Net the marking belongs to, used to resolve place names
+/// @param marking Token count of every place
+/// @return (string) String representation of the marking, e.g. "p1,p3:2"
+std::string markingToString(const NetView &net, std::span<const int32_t> marking)
+{
+    std::string label;
+    for (PlaceId place = 0; place < marking.size(); place++)
+    {
+        if (marking[place] == 0)
+        {
+            continue;
+        }
+        if (!label.empty())
+        {
+            label += ',';
+        }
+        label += net.placeName(place);
+        if (marking[place] != 1)
+        {
+            label += ':' + std::to_string(marking[place]);
+        }
+    }
+    return label;
+}
 
 /// @brief Helper function to generate a unique string identifier for a marking
+/// @param net Petri net the marking belongs to, used to resolve place names
 /// @param places Vector of places to generate a marking for
 /// @return (string) String representation of the marking
-std::string markingToString(const Places &places)
+std::string markingToString(const PetriNet &net, const Places &places)
 {
     std::stringstream ss;
     for (const auto &place : places)
     {
         if (place.tokens > 0)
-            ss << place.name << ",";
+            ss << net.getNames().name(place.name) << ",";
     }
     std::string s = ss.str();
     if (!s.empty())
@@ -505,238 +750,133 @@ std::string markingToString(const Places &places)
     return s;
 }
 
-/// @brief Function to save a reachability graph of a petri net to an SVG file
+/// @brief Function to save a reachability graph of a petri net to an SVG file, written in the background by renderQueue()
+/// Bisimilar states are drawn as one node, labelled with the marking of its first state and the number of states merged into it.
 /// @param net Petri net to generate the reachability graph for
 /// @param filename Name of the file to save the SVG to
-void drawReachabilityGraphToSVG(const PetriNet &net, const std::string &filename)
+/// @param options Layout algorithm and tuning, including the number of threads and the layout cache
+/// @param reduction Equivalence the states are merged by, Equivalence::None draws every reachable marking
+void drawReachabilityGraphToSVG(const PetriNet &net, const std::string &filename, const LayoutOptions &options, const BisimulationOptions &reduction)
 {
-    std::queue<std::pair<Places, Transitions>> statesQueue;
-    std::set<std::string> visitedStates;
-    std::vector<std::tuple<std::string, std::string, std::string>> edges;
-
-    statesQueue.push({net.getPlaces(), {}});
-
-    while (!statesQueue.empty())
+    const NetView view = net.view();
+    const ReachabilityGraph reachability(view, workflowFinalMarking(view), DEFAULT_STATE_LIMIT);
+    // Final states are never merged with others
+    std::vector<uint32_t> colors(reachability.stateCount());
+    for (StateId state = 0; state < reachability.stateCount(); state++)
     {
-        auto current = statesQueue.front();
-        statesQueue.pop();
-
-        auto currentState = current.first;
-        auto currentTransitions = current.second;
-
-        std::string currentStateStr = markingToString(currentState);
-        if (visitedStates.find(currentStateStr) != visitedStates.end())
-        {
-            continue;
-        }
-        visitedStates.insert(currentStateStr);
-
-        PetriNet currentStateNet = net;
-        currentStateNet.setPlaces(currentState);
-
-        Transitions enabledTransitions = getEnabledTransitions(currentStateNet);
-        for (const auto &transition : enabledTransitions)
-        {
-            PetriNet nextStateNet = currentStateNet;
-            fireTransition(nextStateNet, transition);
-            std::string nextStateStr = markingToString(nextStateNet.getPlaces());
-            edges.emplace_back(currentStateStr, nextStateStr, transition.name);
-
-            statesQueue.emplace(nextStateNet.getPlaces(), currentTransitions);
-        }
+        colors[state] = reachability.flags(state) & STATE_FINAL;
     }
-    std::map<std::string, Node> positions;
-
-    int start = 450;
-    int incr = 100 / (int)visitedStates.size();
-
-    std::set<std::string> visitedStates2 = visitedStates;
-
-    std::map<std::string, std::string> isConnected;
-    for (auto x : edges)
+    const Quotient quotient = drawingQuotient(reachability.stateCount(), reachability.labeledEdges(), reduction, colors);
+    const size_t blockCount = quotient.blockCount();
+    std::vector<size_t> blockSizes(blockCount, 0);
+    for (const uint32_t block : quotient.blockOf)
+    {
+        blockSizes[block]++;
+    }
+    // Edges between the same two blocks are drawn as one arc listing all their transitions
+    std::map<std::pair<StateId, StateId>, TransitionIds> edges;
+    for (const LabeledEdge &edge : quotient.edges)
     {
-        isConnected[std::get<0>(x)] = std::get<1>(x);
-        isConnected[std::get<1>(x)] = std::get<0>(x);
+        edges[{edge.from, edge.to}].push_back(edge.transition);
     }
 
-    for (const auto &x : visitedStates)
+    LayoutGraph graph;
+    graph.nodeCount = blockCount;
+    for (const auto &edge : edges)
     {
-        double randomX = start + incr;
-        start += incr;
-        double randomY = start + incr;
-        std::vector<std::string> connectedStates;
-        int offset = 50;
-        for (const auto &y : visitedStates2)
+        graph.edges.push_back(edge.first);
+    }
+    std::vector<std::string> keys(blockCount);
+    for (uint32_t block = 0; block < blockCount; block++)
+    {
+        keys[block] = markingToString(view, reachability.marking(quotient.representatives[block]));
+    }
+    const LayoutCache cache(options.cacheDirectory);
+    const uint64_t fingerprint = graphFingerprint(graph, keys, options.mode == LayoutMode::Multilevel ? "multilevel" : "force-directed");
+    LayoutPositions layout;
+    if (!cache.find(fingerprint, keys, layout))
+    {
+        // A layout of an earlier version of the graph only needs refining if it places most of the states
+        LayoutOptions layoutOptions = options;
+        std::vector<bool> known;
+        if (static_cast<double>(cache.warmStart(filename, keys, layout, known)) >= LAYOUT_WARM_START * static_cast<double>(keys.size()) && !keys.empty())
         {
-            if (isConnected[x] == y)
-            {
-                positions[y] = Node(randomX, randomY - offset);
-                offset += 50;
-                connectedStates.push_back(y);
-            }
+            placeNewNodes(graph, layout, known);
+            layoutOptions.refine = true;
         }
-        for (const auto &y : connectedStates)
+        else
         {
-            visitedStates2.erase(y);
-        }
-        if (!positions.count(x))
-            positions[x] = Node(randomX, randomY);
-    }
-
-    double K = 500;
-    for (int i = 0; i < ITERATIONS; i++)
-    {
-        for (auto &x : positions)
+            layout = {};
+        }
+        computeLayout(graph, layout, layoutOptions);
+        cache.store(filename, fingerprint, keys, layout);
+    }
+
+    // Scale the positions to the canvas, which grows with the number of states
+    Drawing drawing;
+    const double width = std::max(static_cast<double>(REACHABILITY_GRAPH_WIDTH), std::sqrt(static_cast<double>(blockCount)) * SPACE_BETWEEN_NODES);
+    drawing.width = width;
+    drawing.height = width;
+    const auto [min_x, max_x] = std::minmax_element(layout.x.begin(), layout.x.end());
+    const auto [min_y, max_y] = std::minmax_element(layout.y.begin(), layout.y.end());
+    const double extent = std::max({static_cast<double>(*max_x - *min_x), static_cast<double>(*max_y - *min_y), 1e-9});
+    const double scale = (width - 2 * NODE_RADIUS) / extent;
+    drawing.nodes.resize(blockCount);
+    for (uint32_t block = 0; block < blockCount; block++)
+    {
+        DrawingNode &node = drawing.nodes[block];
+        node.id = "s" + std::to_string(quotient.representatives[block]);
+        node.shape = NodeShape::Text;
+        node.x = (layout.x[block] - *min_x) * scale + NODE_RADIUS;
+        node.y = (layout.y[block] - *min_y) * scale + NODE_RADIUS;
+        node.label = " {" + keys[block] + "}";
+        if (blockSizes[block] > 1)
         {
-            for (auto &y : positions)
-            {
-                if (x.first != y.first)
-                {
-                    double force;
-                    double x_dist = x.second.x - y.second.x;
-                    double y_dist = x.second.y - y.second.y;
-                    double dist = sqrt(x_dist * x_dist + y_dist * y_dist);
-                    if (!isConnected.count(x.first) || isConnected[x.first] != y.first)
-                    {
-                        force = std::min(std::max(K * K / dist, MIN_FORCE), MAX_FORCE);
-                    }
-                    else
-                    {
-                        force = -1 * std::min(std::max(dist * dist / K, MIN_FORCE), MAX_FORCE);
-                    }
-                    x.second.x += x_dist / dist * force;
-                    x.second.y += y_dist / dist * force;
-                    y.second.x -= x_dist / dist * force;
-                    y.second.y -= y_dist / dist * force;
-                }
-            }
+            node.label += " (+" + std::to_string(blockSizes[block] - 1) + ")";
         }
-        K *= ATTRACTION_CONSTANT;
     }
-
-    // Scale the positions to keep the same relative position on the canvas as the original graph
-    double min_y = std::numeric_limits<double>::max();
-    double max_y = std::numeric_limits<double>::min();
-    double min_x = std::numeric_limits<double>::max();
-    double max_x = std::numeric_limits<double>::min();
-    for (auto &x : positions)
-    {
-        min_y = std::min(min_y, x.second.y);
-        max_y = std::max(max_y, x.second.y);
-        min_x = std::min(min_x, x.second.x);
-        max_x = std::max(max_x, x.second.x);
-    }
-
-    double scale = std::min((REACHABILITY_GRAPH_WIDTH - 2 * NODE_RADIUS) / (max_x - min_x),
-                            (REACHABILITY_GRAPH_WIDTH - 2 * NODE_RADIUS) / (max_y - min_y));
-    for (auto &x : positions)
-    {
-        x.second.x = (x.second.x - min_x) * scale + NODE_RADIUS;
-        x.second.y = (x.second.y - min_y) * scale + NODE_RADIUS;
-    }
-    std::ofstream file(filename);
-    // Define SVG header
-    file
-            << R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink" fill="white" version="1.1" width=")"
-            << REACHABILITY_GRAPH_WIDTH << "\" height=\"" << REACHABILITY_GRAPH_WIDTH
-            << "\">" << std::endl;
-    file << "<defs>" << std::endl;
-    // Define arrowheads using Xiketic and Blue Jeans colors
-    file << R"(<marker
-      id="arrowheadBlue"
-      viewBox="0 0 10 10"
-      refX="1"
-      refY="5"
-      markerUnits="strokeWidth"
-      markerWidth="5"
-      markerHeight="5"
-      orient="auto">
-      <path d="M 0 0 L 10 5 L 0 10 z" fill="#38B6FF" />)"
-         << std::endl;
-    file << "</marker>" << std::endl;
-    file << R"(<marker
-                  id="arrowhead"
-                  viewBox="0 0 10 10"
-                  refX="1"
-                  refY="5"
-                  markerUnits="strokeWidth"
-                  markerWidth="5"
-                  markerHeight="5"
-                  orient="auto">
-                  <path d="M 0 0 L 10 5 L 0 10 z" fill="#121420" />)"
-         << std::endl;
-    file << "</marker>" << std::endl;
-    file << "</defs>" << std::endl;
-    for (auto [u, v] : positions)
-    {
-        std::string text = "{" + u + "}";
-        file << "<text x=\"" << v.x << "\" y=\"" << v.y
-             << R"(" text-anchor="middle" fill="black" font-size="20px" dy=".3em" font-weight="bold"> )"
-             << text << "</text>" << std::endl;
-    }
-    std::map<std::pair<std::string, std::string>, std::vector<std::string>> grouped_edges;
-    for (auto x : edges)
-    {
-        std::string to = std::get<0>(x);
-        std::string from = std::get<1>(x);
-        std::string transition = std::get<2>(x);
-        grouped_edges[{to, from}].push_back(transition);
-    }
-    for (auto const &x : grouped_edges)
-    {
-        double x1 = positions[x.first.first].x;
-        double y1 = positions[x.first.first].y;
-        double x2 = positions[x.first.second].x;
-        double y2 = positions[x.first.second].y;
+    drawing.edges.reserve(edges.size());
+    for (auto const &x : edges)
+    {
+        DrawingEdge &edge = drawing.edges.emplace_back();
+        edge.from = x.first.first;
+        edge.to = x.first.second;
+        const double x1 = drawing.nodes[edge.from].x;
+        const double y1 = drawing.nodes[edge.from].y;
+        const double x2 = drawing.nodes[edge.to].x;
+        const double y2 = drawing.nodes[edge.to].y;
         double offsetX = 100;
         double offsetY = 100;
-        if (x.first.first < x.first.second)
+        // Edges to later states are blue with a dark label, edges back are the other way round
+        if (edge.from < edge.to)
         {
             offsetX = -offsetX;
             offsetY = -offsetY;
-        }
-        double controlX = (x1 + x2) / 2 - offsetX;
-        double controlY = (y1 + y2) / 2 - offsetY; // Adjust the control point's Y coordinate as desired
-
-        double angle = std::atan2(y2 - y1, x2 - x1);
-        if (x.first.first < x.first.second)
-        {
-            file << "<path d=\"M " << x1 << " " << y1 + 20 * sin(angle) << " Q " << controlX << " " << controlY
-                 << " " << x2 << " " << y2 - 20 * sin(angle)
-                 << R"lit(" fill="none" stroke="#38B6FF" stroke-width="2" marker-end="url(#arrowheadBlue)"/>)lit"
-                 << std::endl;
+            edge.color = DrawingColor::Blue;
         }
         else
         {
-
-            file << "<path d=\"M " << x1 << " " << y1 + 20 * sin(angle) << " Q " << controlX << " " << controlY
-                 << " " << x2 << " " << y2 - 20 * sin(angle)
-                 << R"lit(" fill="none" stroke="#121420" stroke-width="2" marker-end="url(#arrowhead)"/>)lit"
-                 << std::endl;
+            edge.labelColor = DrawingColor::Blue;
         }
+        const double angle = std::atan2(y2 - y1, x2 - x1);
+        edge.curved = true;
+        edge.x1 = x1;
+        edge.y1 = y1 + 20 * sin(angle);
+        edge.controlX = (x1 + x2) / 2 - offsetX;
+        edge.controlY = (y1 + y2) / 2 - offsetY;
+        edge.x2 = x2;
+        edge.y2 = y2 - 20 * sin(angle);
 
         std::string transitions;
-        for (auto &t : x.second)
+        for (const TransitionId t : x.second)
         {
-            transitions += t + ", ";
+            transitions += std::string(net.transitionName(t)) + ", ";
         }
         transitions.insert(transitions.begin(), '{');
         transitions[transitions.size() - 2] = '}';
-        double x3 = (x1 + x2) / 2 - offsetX / 2;
-        double y3 = (y1 + y2) / 2 - offsetY / 2;
-        if (x.first.first < x.first.second)
-        {
-            file << "<text x=\"" << x3 << "\" y=\"" << y3
-                 << R"(" text-anchor="middle" fill="#121420" font-size="20px" dy=".3em" font-weight="bold">)"
-                 << transitions << "</text>" << std::endl;
-        }
-        else
-        {
-            file << "<text x=\"" << x3 << "\" y=\"" << y3
-                 << R"(" text-anchor="middle" fill="#38B6FF" font-size="20px" dy=".3em" font-weight="bold">)"
-                 << transitions << "</text>" << std::endl;
-        }
+        edge.label = transitions;
+        edge.labelX = (x1 + x2) / 2 - offsetX / 2;
+        edge.labelY = (y1 + y2) / 2 - offsetY / 2;
     }
-    file << "</svg>" << std::endl;
-    file.close();
-}
\ No newline at end of file
+    renderQueue().submit(std::move(drawing), filename);
+}
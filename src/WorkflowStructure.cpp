@@ -0,0 +1,166 @@
+#include "../include/WorkflowStructure.h"
+#include "../include/BinaryNet.h"
+
+#include <algorithm>
+
+/// @brief Marks every node reachable from a place, places first and transitions after them in the result.
+/// @param forward Follow arcs in their direction, otherwise against it.
+static std::vector<bool> reachableNodes(const NetView &net, PlaceId start, bool forward)
+{
+    const size_t placeCount = net.placeCount();
+    std::vector<bool> seen(placeCount + net.transitionCount(), false);
+    std::vector<PlaceId> queue{start};
+    seen[start] = true;
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        const PlaceId place = queue[head];
+        for (const TransitionId transition : forward ? net.placePostset(place) : net.placePreset(place))
+        {
+            if (seen[placeCount + transition])
+            {
+                continue;
+            }
+            seen[placeCount + transition] = true;
+            for (const PlaceId next : forward ? net.postset(transition) : net.preset(transition))
+            {
+                if (!seen[next])
+                {
+                    seen[next] = true;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+    return seen;
+}
+
+WorkflowPlaces findWorkflowPlaces(const NetView &net)
+{
+    WorkflowPlaces places;
+    for (PlaceId place = 0; place < net.placeCount(); place++)
+    {
+        if (net.placePreset(place).empty())
+        {
+            places.sources.push_back(place);
+        }
+        if (net.placePostset(place).empty())
+        {
+            places.sinks.push_back(place);
+        }
+    }
+    places.input = places.sources.size() == 1 ? places.sources.front() : INVALID_ID;
+    places.output = places.sinks.size() == 1 ? places.sinks.front() : INVALID_ID;
+    return places;
+}
+
+WorkflowStructure validateWorkflowNet(const NetView &net)
+{
+    WorkflowStructure structure;
+    const size_t placeCount = net.placeCount();
+    const WorkflowPlaces places = findWorkflowPlaces(net);
+    structure.input = places.input;
+    structure.output = places.output;
+    if (places.sources.empty())
+    {
+        structure.issues.push_back({WorkflowDefect::MissingInput});
+    }
+    if (places.sinks.empty())
+    {
+        structure.issues.push_back({WorkflowDefect::MissingOutput});
+    }
+    // Every candidate is reported, the user has to decide which one is meant
+    if (places.sources.size() > 1)
+    {
+        for (const PlaceId place : places.sources)
+        {
+            structure.issues.push_back({WorkflowDefect::SeveralInputs, place});
+        }
+    }
+    if (places.sinks.size() > 1)
+    {
+        for (const PlaceId place : places.sinks)
+        {
+            structure.issues.push_back({WorkflowDefect::SeveralOutputs, place});
+        }
+    }
+    if (structure.input != INVALID_ID && net.places[structure.input].tokens < 1)
+    {
+        structure.issues.push_back({WorkflowDefect::UnmarkedInput, structure.input});
+    }
+    for (PlaceId place = 0; place < placeCount; place++)
+    {
+        // Candidates for an ambiguous input place may hold its tokens, they are reported already
+        const bool candidate = std::binary_search(places.sources.begin(), places.sources.end(), place);
+        if (net.places[place].tokens > 0 && place != structure.input && (structure.input != INVALID_ID || !candidate))
+        {
+            structure.issues.push_back({WorkflowDefect::MarkedPlace, place});
+        }
+    }
+    if (structure.input == INVALID_ID || structure.output == INVALID_ID)
+    {
+        return structure;
+    }
+
+    // Every node lies on a path from i to o exactly if adding o -> i makes the net strongly connected
+    const std::vector<bool> fromInput = reachableNodes(net, structure.input, true);
+    const std::vector<bool> toOutput = reachableNodes(net, structure.output, false);
+    const auto report = [&](const std::vector<bool> &seen, WorkflowDefect defect)
+    {
+        for (uint32_t node = 0; node < seen.size(); node++)
+        {
+            if (!seen[node])
+            {
+                const bool transition = node >= placeCount;
+                structure.issues.push_back({defect, transition ? static_cast<uint32_t>(node - placeCount) : node, transition});
+            }
+        }
+    };
+    const size_t before = structure.issues.size();
+    report(fromInput, WorkflowDefect::Unreachable);
+    report(toOutput, WorkflowDefect::CannotReachOutput);
+    structure.stronglyConnected = structure.issues.size() == before;
+    return structure;
+}
+
+PetriNet shortCircuitNet(const NetView &net, PlaceId input, PlaceId output)
+{
+    PetriNet loop = netFromView(net);
+    // The name only has to be new
+    std::string name = "o->i";
+    while (!loop.addTransition(name))
+    {
+        name += "'";
+    }
+    const auto transition = static_cast<TransitionId>(loop.getTransitions().size() - 1);
+    loop.addArc(output, transition, ArcDirection::PlaceToTransition);
+    loop.addArc(transition, input, ArcDirection::TransitionToPlace);
+    loop.finalize();
+    return loop;
+}
+
+std::string describeWorkflowIssue(const NetView &net, const WorkflowIssue &issue)
+{
+    const std::string node = issue.node == INVALID_ID ? ""
+                             : issue.transition       ? "Transition " + std::string(net.transitionName(issue.node))
+                                                      : "Place " + std::string(net.placeName(issue.node));
+    switch (issue.defect)
+    {
+    case WorkflowDefect::MissingInput:
+        return "Every place has producers, there is no input place";
+    case WorkflowDefect::MissingOutput:
+        return "Every place has consumers, there is no output place";
+    case WorkflowDefect::SeveralInputs:
+        return node + " has no producers, but it isn't the only one";
+    case WorkflowDefect::SeveralOutputs:
+        return node + " has no consumers, but it isn't the only one";
+    case WorkflowDefect::UnmarkedInput:
+        return "The input place " + std::string(net.placeName(issue.node)) + " holds no token";
+    case WorkflowDefect::MarkedPlace:
+        return node + " holds tokens initially";
+    case WorkflowDefect::Unreachable:
+        return node + " isn't on any path from the input place";
+    case WorkflowDefect::CannotReachOutput:
+        return node + " can't reach the output place";
+    }
+    return node;
+}
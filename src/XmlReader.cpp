@@ -0,0 +1,484 @@
+#include "../include/XmlReader.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+
+static const size_t XML_CHUNK_SIZE = 1 << 16;
+
+/// @brief Builds a lookup table of the characters that end a run.
+static constexpr std::array<bool, 256> charClass(std::string_view characters)
+{
+    std::array<bool, 256> table{};
+    for (const char c : characters)
+    {
+        table[static_cast<unsigned char>(c)] = true;
+    }
+    return table;
+}
+
+static constexpr std::array<bool, 256> TEXT_STOP = charClass("<&");
+static constexpr std::array<bool, 256> NAME_STOP = charClass(" \t\n\r>/=");
+static constexpr std::array<bool, 256> DOUBLE_QUOTED_STOP = charClass("\"&");
+static constexpr std::array<bool, 256> SINGLE_QUOTED_STOP = charClass("'&");
+static constexpr std::array<bool, 256> NON_WHITESPACE = []
+{
+    std::array<bool, 256> table{};
+    table.fill(true);
+    table[' '] = table['\t'] = table['\n'] = table['\r'] = false;
+    return table;
+}();
+
+XmlReader::XmlReader(std::istream &input, std::string source)
+    : input(input), source(std::move(source)), buffer(XML_CHUNK_SIZE)
+{
+}
+
+XmlReader::Event XmlReader::next()
+{
+    if (pendingEnd)
+    {
+        // The previous start element was self-closing
+        pendingEnd = false;
+        depth--;
+        return Event::EndElement;
+    }
+    while (true)
+    {
+        int c = peek();
+        if (c == EOF)
+        {
+            if (depth != 0)
+            {
+                fail("Unexpected end of document");
+            }
+            return Event::EndOfDocument;
+        }
+        if (c != '<')
+        {
+            characters.clear();
+            bool blank = true;
+            while (true)
+            {
+                const size_t start = characters.size();
+                appendRun(&characters, TEXT_STOP);
+                for (size_t i = start; blank && i < characters.size(); i++)
+                {
+                    blank = !NON_WHITESPACE[static_cast<unsigned char>(characters[i])];
+                }
+                if (peek() != '&')
+                {
+                    break;
+                }
+                get();
+                readReference(characters);
+                blank = false;
+            }
+            if (!blank)
+            {
+                return Event::Text;
+            }
+            continue;
+        }
+        get();
+        c = peek();
+        if (c == '?')
+        {
+            skipUntil("?>");
+        }
+        else if (c == '!')
+        {
+            get();
+            if (peek() == '-')
+            {
+                expect("--");
+                skipUntil("-->");
+            }
+            else if (peek() == '[')
+            {
+                expect("[CDATA[");
+                characters.clear();
+                while (true)
+                {
+                    c = get();
+                    if (c == EOF)
+                    {
+                        fail("Unterminated CDATA section");
+                    }
+                    characters += static_cast<char>(c);
+                    if (characters.size() >= 3 && characters.compare(characters.size() - 3, 3, "]]>") == 0)
+                    {
+                        characters.resize(characters.size() - 3);
+                        break;
+                    }
+                }
+                return Event::Text;
+            }
+            else
+            {
+                // <!DOCTYPE ...> possibly with an internal subset in brackets
+                int nesting = 0;
+                while ((c = get()) != EOF)
+                {
+                    if (c == '[')
+                    {
+                        nesting++;
+                    }
+                    else if (c == ']')
+                    {
+                        nesting--;
+                    }
+                    else if (c == '>' && nesting <= 0)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+        else if (c == '/')
+        {
+            get();
+            readName(elementName);
+            if (depth == 0)
+            {
+                fail("Unexpected end tag </" + elementName + ">");
+            }
+            if (elementName != openElements[depth - 1])
+            {
+                fail("Expected </" + openElements[depth - 1] + ">, found </" + elementName + ">");
+            }
+            size_t colon = elementName.find(':');
+            if (colon != std::string::npos)
+            {
+                elementName.erase(0, colon + 1);
+            }
+            skipWhitespace();
+            expect(">");
+            depth--;
+            return Event::EndElement;
+        }
+        else
+        {
+            readStartElement();
+            depth++;
+            return Event::StartElement;
+        }
+    }
+}
+
+const std::string &XmlReader::name() const
+{
+    return elementName;
+}
+
+std::string_view XmlReader::attribute(std::string_view name) const
+{
+    for (size_t i = 0; i < attributeCount; i++)
+    {
+        if (attributes[i].first == name)
+        {
+            return attributes[i].second;
+        }
+    }
+    return {};
+}
+
+bool XmlReader::hasAttribute(std::string_view name) const
+{
+    for (size_t i = 0; i < attributeCount; i++)
+    {
+        if (attributes[i].first == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string &XmlReader::text() const
+{
+    return characters;
+}
+
+size_t XmlReader::line() const
+{
+    return currentLine;
+}
+
+void XmlReader::fail(const std::string &message) const
+{
+    throw std::runtime_error(source + ":" + std::to_string(currentLine) + ": " + message);
+}
+
+int XmlReader::peek()
+{
+    if (position == available && !refill())
+    {
+        return EOF;
+    }
+    return static_cast<unsigned char>(buffer[position]);
+}
+
+int XmlReader::get()
+{
+    int c = peek();
+    if (c != EOF)
+    {
+        position++;
+        if (c == '\n')
+        {
+            currentLine++;
+        }
+    }
+    return c;
+}
+
+bool XmlReader::refill()
+{
+    input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    available = static_cast<size_t>(input.gcount());
+    position = 0;
+    return available > 0;
+}
+
+void XmlReader::expect(std::string_view literal)
+{
+    for (const char c : literal)
+    {
+        if (get() != static_cast<unsigned char>(c))
+        {
+            fail("Expected '" + std::string(literal) + "'");
+        }
+    }
+}
+
+void XmlReader::skipUntil(std::string_view terminator)
+{
+    size_t matched = 0;
+    while (matched < terminator.size())
+    {
+        int c = get();
+        if (c == EOF)
+        {
+            fail("Expected '" + std::string(terminator) + "'");
+        }
+        if (c == static_cast<unsigned char>(terminator[matched]))
+        {
+            matched++;
+        }
+        else
+        {
+            matched = c == static_cast<unsigned char>(terminator[0]) ? 1 : 0;
+        }
+    }
+}
+
+void XmlReader::skipWhitespace()
+{
+    appendRun(nullptr, NON_WHITESPACE);
+}
+
+/// @brief Consumes characters up to (not including) the first one in the stop class or the end of input.
+/// @param out Receives the consumed characters, nullptr to discard them.
+void XmlReader::appendRun(std::string *out, const std::array<bool, 256> &stop)
+{
+    while (position < available || refill())
+    {
+        const size_t start = position;
+        while (position < available && !stop[static_cast<unsigned char>(buffer[position])])
+        {
+            currentLine += buffer[position] == '\n';
+            position++;
+        }
+        if (out != nullptr)
+        {
+            out->append(buffer.data() + start, position - start);
+        }
+        if (position < available)
+        {
+            return;
+        }
+    }
+}
+
+/// @brief Reads an element or attribute name, element names have their namespace prefix removed by the caller.
+void XmlReader::readName(std::string &out)
+{
+    out.clear();
+    appendRun(&out, NAME_STOP);
+    if (out.empty())
+    {
+        fail("Expected a name");
+    }
+}
+
+/// @brief Decodes an entity or character reference, the '&' has already been consumed.
+void XmlReader::readReference(std::string &out)
+{
+    char reference[12];
+    size_t length = 0;
+    int c;
+    while ((c = get()) != ';')
+    {
+        if (c == EOF || length == sizeof(reference))
+        {
+            fail("Malformed entity reference");
+        }
+        reference[length++] = static_cast<char>(c);
+    }
+    std::string_view entity(reference, length);
+    if (entity == "lt")
+    {
+        out += '<';
+    }
+    else if (entity == "gt")
+    {
+        out += '>';
+    }
+    else if (entity == "amp")
+    {
+        out += '&';
+    }
+    else if (entity == "quot")
+    {
+        out += '"';
+    }
+    else if (entity == "apos")
+    {
+        out += '\'';
+    }
+    else if (length > 1 && entity[0] == '#')
+    {
+        const bool hex = entity[1] == 'x' || entity[1] == 'X';
+        const char *begin = entity.data() + (hex ? 2 : 1);
+        uint32_t code = 0;
+        auto [end, error] = std::from_chars(begin, entity.data() + entity.size(), code, hex ? 16 : 10);
+        if (error != std::errc() || end != entity.data() + entity.size())
+        {
+            fail("Malformed character reference");
+        }
+        // Encode as UTF-8
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    else
+    {
+        fail("Unknown entity &" + std::string(entity) + ";");
+    }
+}
+
+/// @brief Reads the name and attributes of a start tag, the '<' has already been consumed.
+void XmlReader::readStartElement()
+{
+    readName(elementName);
+    // The qualified name is kept until the matching end tag, the strings are reused across elements
+    if (static_cast<size_t>(depth) == openElements.size())
+    {
+        openElements.emplace_back();
+    }
+    openElements[depth] = elementName;
+    size_t colon = elementName.find(':');
+    if (colon != std::string::npos)
+    {
+        elementName.erase(0, colon + 1);
+    }
+    attributeCount = 0;
+    while (true)
+    {
+        skipWhitespace();
+        int c = peek();
+        if (c == '>')
+        {
+            get();
+            return;
+        }
+        if (c == '/')
+        {
+            get();
+            expect(">");
+            pendingEnd = true;
+            return;
+        }
+        if (c == EOF)
+        {
+            fail("Unterminated start tag");
+        }
+        if (attributeCount == attributes.size())
+        {
+            attributes.emplace_back();
+        }
+        auto &[key, value] = attributes[attributeCount++];
+        readName(key);
+        skipWhitespace();
+        expect("=");
+        skipWhitespace();
+        const int quote = get();
+        if (quote != '"' && quote != '\'')
+        {
+            fail("Expected a quoted attribute value");
+        }
+        value.clear();
+        const std::array<bool, 256> &valueStop = quote == '"' ? DOUBLE_QUOTED_STOP : SINGLE_QUOTED_STOP;
+        while ((c = get()) != quote)
+        {
+            if (c == EOF)
+            {
+                fail("Unterminated attribute value");
+            }
+            if (c == '&')
+            {
+                readReference(value);
+            }
+            else
+            {
+                value += static_cast<char>(c);
+                appendRun(&value, valueStop);
+            }
+        }
+    }
+}
+
+/// @brief Writes text with the XML special characters escaped, usable in character data and attribute values.
+void writeXmlEscaped(std::ostream &out, std::string_view text)
+{
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '<':
+            out << "&lt;";
+            break;
+        case '>':
+            out << "&gt;";
+            break;
+        case '&':
+            out << "&amp;";
+            break;
+        case '"':
+            out << "&quot;";
+            break;
+        default:
+            out << c;
+        }
+    }
+}
@@ -1,63 +1,53 @@
 #include <iostream>
 #include <string>
-#include "../include/utility.h"
+#include "../include/Utility.h"
+#include "../include/NetLoader.h"
+#include "../include/BatchVerifier.h"
+#include "../include/BinaryNet.h"
+#include "../include/Pnml.h"
+#include "../include/GraphExport.h"
+#include "../include/Renderer.h"
+#include "../include/Constants.h"
 
-int main()
+#include <filesystem>
+
+/// @brief Reads a Petri net interactively from the console.
+/// @return (PetriNet) Finalized Petri net.
+static PetriNet readNetFromConsole()
 {
-    bool choice;
-    std::cout << "Choose 0 for text file input and 1 for manual input: ";
-    std::cin >> choice;
-    // Read file name
-    if (choice == 0)
-    {
-        char fileName[100];
-        std::cout << "Enter text file name (including .txt/no spaces): ";
-        std::cin >> fileName;
-        freopen(fileName, "r", stdin);
-    }
     // Define the Petri net
     PetriNet petriNet;
     int n = 0;
-    // Add initial and final place
-    Place initialPlace("i", 0);
-    Place finalPlace("o", 0);
     // Get places from user
-    if (choice != 0)
-        std::cout << "Enter the number of places (min. 2): ";
+    std::cout << "Enter the number of places (min. 2): ";
     std::cin >> n;
     if (n < 2)
     {
         throw std::runtime_error("The number of places must be at least 2");
     }
-    int tokens;
-    if (choice != 0)
-        std::cout << "Enter the number of tokens for the initial place: ";
-    std::cin >> tokens;
-    initialPlace.tokens = tokens;
-    if (choice != 0)
-        std::cout << "Enter the number of tokens for the output place: ";
-    std::cin >> tokens;
-    finalPlace.tokens = tokens;
-    petriNet.addPlace(initialPlace);
+    int tokens, initialTokens, finalTokens;
+    std::cout << "Enter the number of tokens for the initial place: ";
+    std::cin >> initialTokens;
+    std::cout << "Enter the number of tokens for the output place: ";
+    std::cin >> finalTokens;
+    // Add initial and final place
+    petriNet.addPlace("i", initialTokens);
     for (int i = 0; i < n - 2; i++)
     {
-        if (choice != 0)
-            std::cout << "Enter the number of token for place p" << (i + 1) << ": ";
+        std::cout << "Enter the number of token for place p" << (i + 1) << ": ";
         std::cin >> tokens;
-        Place place("p" + std::to_string(i + 1), tokens);
-        petriNet.addPlace(place);
+        petriNet.addPlace("p" + std::to_string(i + 1), tokens);
     }
-    petriNet.addPlace(finalPlace);
+    petriNet.addPlace("o", finalTokens);
     // Print the Places in the Petri net
     std::cout << "Places: ";
-    for (const auto &place : petriNet.getPlaces())
+    for (PlaceId place = 0; place < petriNet.getPlaces().size(); place++)
     {
-        std::cout << place.name << " ";
+        std::cout << petriNet.placeName(place) << " ";
     }
     std::cout << std::endl;
     // Get transitions from user
-    if (choice != 0)
-        std::cout << "Enter the number of transitions (min. 1): ";
+    std::cout << "Enter the number of transitions (min. 1): ";
     int m = 0;
     std::cin >> m;
     if (m < 1)
@@ -66,28 +56,20 @@ int main()
     }
     for (int i = 0; i < m; i++)
     {
-        if (choice != 0)
-            std::cout << "Enter the name of transition t" << (i + 1) << ": ";
+        std::cout << "Enter the name of transition t" << (i + 1) << ": ";
         std::string name;
         std::getline(std::cin >> std::ws, name);
-        Transition transition(name);
-        petriNet.addTransition(transition);
+        petriNet.addTransition(name);
     }
     // Print the Transitions in the Petri net
-    if (choice != 0)
+    std::cout << "Transitions: ";
+    for (TransitionId i = 0; i < petriNet.getTransitions().size(); i++)
     {
-        std::cout << "Transitions: ";
+        std::cout << "{t" << i + 1 << " , " << petriNet.transitionName(i) << "} ";
     }
-    for (int i = 0; i < petriNet.getTransitions().size(); i++)
-    {
-        if (choice != 0)
-            std::cout << "{t" << i + 1 << " , " << petriNet.getTransitions()[i].name << "} ";
-    }
-    if (choice != 0)
-        std::cout << std::endl;
+    std::cout << std::endl;
     // Add the arcs
-    if (choice != 0)
-        std::cout << "Enter number of arcs (min. 1): ";
+    std::cout << "Enter number of arcs (min. 1): ";
     int k = 0;
     std::cin >> k;
     if (k < 1)
@@ -97,14 +79,12 @@ int main()
     for (int i = 0; i < k; i++)
     {
         std::string x, y, placeName, transitionName;
-        if (choice != 0)
-            std::cout << "Enter the name of the place (i, p1, o, ..) or transition (t1, t2, ..): ";
+        std::cout << "Enter the name of the place (i, p1, o, ..) or transition (t1, t2, ..): ";
         std::cin >> x;
-        if (choice != 0)
-            std::cout << "Enter the name of the place (i, p1, o, ..) or transition (t1, t2, ..): ";
+        std::cout << "Enter the name of the place (i, p1, o, ..) or transition (t1, t2, ..): ";
         std::cin >> y;
-        bool firstIsPlace = petriNet.getPlaceMap().count(x);
-        bool secondIsPlace = petriNet.getPlaceMap().count(y);
+        bool firstIsPlace = petriNet.findPlace(x) != INVALID_ID;
+        bool secondIsPlace = petriNet.findPlace(y) != INVALID_ID;
         if (firstIsPlace == secondIsPlace)
         {
             throw std::runtime_error(firstIsPlace ? "Both are places" : "Both are transitions");
@@ -119,25 +99,130 @@ int main()
             placeName = y;
             transitionName = x;
         }
-        if (!petriNet.getPlaceMap().count(placeName))
+        PlaceId place = petriNet.findPlace(placeName);
+        TransitionId transition = petriNet.findTransitionLabel(transitionName);
+        if (place == INVALID_ID)
         {
             throw std::runtime_error("The place " + placeName + " does not exist");
         }
-        if (!petriNet.getReverseTransitionMap().count(transitionName))
+        if (transition == INVALID_ID)
         {
             throw std::runtime_error("The transition " + transitionName + " does not exist");
         }
-        Place place = petriNet.getPlaces()[petriNet.getPlaceMap().at(placeName)];
-        Transition transition = petriNet.getReverseTransitionMap().at(transitionName);
         if (firstIsPlace)
         {
-            petriNet.addArc(place, transition);
+            petriNet.addArc(place, transition, ArcDirection::PlaceToTransition);
         }
         else
         {
-            petriNet.addArc(transition, place);
+            petriNet.addArc(transition, place, ArcDirection::TransitionToPlace);
         }
     }
+    petriNet.finalize();
+    return petriNet;
+}
+
+/// @brief Converts a net between the supported formats, the output format is picked from its extension.
+/// @return (int) Process exit code.
+static int convertNet(const std::string &input, const std::string &output)
+{
+    try
+    {
+        NetLayout layout;
+        PetriNet petriNet = loadNet(input, &layout);
+        const std::string extension = std::filesystem::path(output).extension().string();
+        if (extension == ".pnb")
+        {
+            saveBinaryNet(petriNet, output);
+        }
+        else if (extension == ".pnml")
+        {
+            savePnml(petriNet, output, &layout);
+        }
+        else if (!exportNetGraph(petriNet.view(), output))
+        {
+            std::cerr << "Unsupported output format " << output << " (expected .pnb, .pnml, .dot or .graphml)" << std::endl;
+            return 2;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/// @brief Explores the reachability graph of a net and writes it to a file (.prg, .dot or .graphml).
+/// Binary nets (.pnb) are explored straight from the mapping.
+/// @return (int) Process exit code.
+static int exportReachabilityGraph(const std::string &input, const std::string &output)
+{
+    try
+    {
+        const LoadedNet net(input);
+        const StateSpaceResult result = exportReachabilityGraph(net.view(), output, DEFAULT_STATE_LIMIT);
+        std::cout << result.states << " states, " << result.edges << " edges";
+        if (!result.complete)
+        {
+            std::cout << " (stopped at the state limit)";
+        }
+        std::cout << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 4 && std::string(argv[1]) == "--convert")
+    {
+        return convertNet(argv[2], argv[3]);
+    }
+    if (argc == 4 && std::string(argv[1]) == "--reachability")
+    {
+        return exportReachabilityGraph(argv[2], argv[3]);
+    }
+    if (argc > 1)
+    {
+        // Non-interactive batch mode
+        return runBatch(std::vector<std::string>(argv + 1, argv + argc), std::cout, std::cerr);
+    }
+    bool choice;
+    std::cout << "Choose 0 for text file input and 1 for manual input: ";
+    std::cin >> choice;
+    PetriNet petriNet;
+    if (choice == 0)
+    {
+        // Read file name
+        std::string fileName;
+        std::cout << "Enter text file name (including .txt/no spaces): ";
+        std::cin >> fileName;
+        try
+        {
+            petriNet = loadNet(fileName);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        // Print the Places in the Petri net
+        std::cout << "Places: ";
+        for (PlaceId place = 0; place < petriNet.getPlaces().size(); place++)
+        {
+            std::cout << petriNet.placeName(place) << " ";
+        }
+        std::cout << std::endl;
+    }
+    else
+    {
+        petriNet = readNetFromConsole();
+    }
     // Print Conclusion
     std::cout << "Workflow net: " << std::boolalpha << isWorkflowNet(petriNet) << std::endl;
     bool soundness = isSound(petriNet);
@@ -146,9 +231,9 @@ int main()
     if (soundness)
     {
         std::cout << "The fired transitions (in order): ";
-        for (const auto &x : latestFiredTransitions)
+        for (const TransitionId x : latestFiredTransitions)
         {
-            std::cout << "t" + std::to_string(petriNet.getTransitionMap().at(x.name) + 1) << " ";
+            std::cout << "t" + std::to_string(x + 1) << " ";
         }
         std::cout << std::endl;
     }
@@ -158,9 +243,19 @@ int main()
     }
 
     drawReachabilityGraphToSVG(petriNet, "reachability.svg");
+    // The drawings are written in the background while the verification goes on
+    try
+    {
+        renderQueue().wait();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
     std::cout << "Reachability graph saved as reachability.svg \n";
     std::cout << "Press any key to exit...";
     std::cin.get();
     std::cout << "Thanks for using the program :)" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
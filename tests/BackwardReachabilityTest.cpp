@@ -0,0 +1,99 @@
+#include "../include/BackwardReachability.h"
+#include "../include/Livelock.h"
+#include "TestSupport.h"
+
+/// @brief Known final reachability of a net in nets/.
+struct ExpectedCompletion
+{
+    const char *file;
+    bool finalReachable;
+};
+
+/// @brief Checks the distances of a backward search against the graph: 0 exactly at the final marking, and every
+/// other finite distance one more than that of the nearest successor.
+static void checkDistances(const ReachabilityGraph &graph, const CompletionReport &completion, const std::string &file)
+{
+    const std::vector<StateId> finalStates = graph.statesWith(STATE_FINAL);
+    const std::vector<bool> completes = graph.canReach(finalStates);
+    expect(completion.markings.size() == graph.stateCount(), file, "the backward search explored another number of states");
+    expect(completion.finalReachable() == !finalStates.empty(), file, "the backward search disagrees on final reachability");
+    expect(completion.stuck.size() == static_cast<size_t>(std::count(completes.begin(), completes.end(), false)), file,
+           "the backward search finds a different number of stuck states");
+    for (StateId state = 0; state < graph.stateCount(); state++)
+    {
+        const StateId id = completion.markings.find(graph.marking(state));
+        if (id == INVALID_ID)
+        {
+            expect(false, file, "a state of the graph is missing from the backward search");
+            continue;
+        }
+        uint32_t nearest = INVALID_ID;
+        for (const StateId successor : graph.successors(state))
+        {
+            nearest = std::min(nearest, completion.distances[completion.markings.find(graph.marking(successor))]);
+        }
+        const uint32_t distance = completion.distances[id];
+        expect((distance == INVALID_ID) != completes[state], file, "a distance disagrees with the graph on completing");
+        if (graph.flags(state) & STATE_FINAL)
+        {
+            expect(distance == 0, file, "the final marking is at a distance");
+        }
+        else if (distance != INVALID_ID)
+        {
+            expect(nearest != INVALID_ID && distance == nearest + 1, file, "a distance isn't one more than the nearest successor's");
+        }
+    }
+}
+
+int main()
+{
+    const std::vector<ExpectedCompletion> nets = {
+        {"sound-loops.txt", true},
+        {"sound-free-choice.txt", true},
+        {"non-free-choice-fragments.txt", true},
+        {"deadlock.txt", true},
+        {"livelock.txt", true},
+        {"dead-transitions.txt", true},
+        {"unbounded.txt", true},
+        {"two-cases.pnml", false},
+    };
+    for (const ExpectedCompletion &expected : nets)
+    {
+        const std::string file = expected.file;
+        const PetriNet net = loadTestNet(file);
+        const NetView view = net.view();
+        const std::vector<int32_t> finalMarking = workflowFinalMarking(view);
+        const CompletionReport completion = checkOptionToComplete(view, finalMarking, TEST_STATE_LIMIT);
+        expect(completion.finalReachable() == expected.finalReachable, file, "wrong final reachability");
+        const ReachabilityGraph graph(view, finalMarking, TEST_STATE_LIMIT);
+        expect(completion.complete == graph.complete(), file, "the backward search disagrees on completeness");
+        if (!graph.complete())
+        {
+            continue;
+        }
+        checkDistances(graph, completion, file);
+
+        // Over the markings of the stuck-component search, as the fragments use it
+        LivelockReport stuck = findStuckComponents(view, finalMarking, false, TEST_STATE_LIMIT);
+        checkDistances(graph, checkOptionToComplete(view, std::move(stuck.markings), finalMarking, stuck.complete), file);
+
+        // The shortest completion is as long as the initial distance and fires to the final marking
+        const TransitionIds sequence = shortestCompletion(view, completion);
+        expect(sequence.size() == (completion.finalReachable() ? completion.distances[0] : 0), file, "the shortest completion has the wrong length");
+        PetriNet run = net;
+        bool enabled = true;
+        for (const TransitionId transition : sequence)
+        {
+            const TransitionIds possible = getEnabledTransitions(run);
+            enabled = enabled && std::find(possible.begin(), possible.end(), transition) != possible.end();
+            fireTransition(run, transition);
+        }
+        bool reached = enabled;
+        for (PlaceId place = 0; completion.finalReachable() && place < finalMarking.size(); place++)
+        {
+            reached = reached && run.getPlaces()[place].tokens == finalMarking[place];
+        }
+        expect(reached, file, "the shortest completion doesn't lead to the final marking");
+    }
+    return testResult("The backward search agrees with the graph on all " + std::to_string(nets.size()) + " nets");
+}
@@ -0,0 +1,204 @@
+#include "../include/Invariants.h"
+#include "TestSupport.h"
+
+#include <numeric>
+#include <optional>
+
+/// @brief Incidence matrix of a net, one row per place: C[p][t] is what firing t adds to p.
+static std::vector<std::vector<int64_t>> incidence(const NetView &net)
+{
+    std::vector<std::vector<int64_t>> matrix(net.placeCount(), std::vector<int64_t>(net.transitionCount(), 0));
+    for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+    {
+        const auto inputs = net.preset(transition);
+        const auto inputWeights = net.presetWeights(transition);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            matrix[inputs[i]][transition] -= inputWeights[i];
+        }
+        const auto outputs = net.postset(transition);
+        const auto outputWeights = net.postsetWeights(transition);
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            matrix[outputs[i]][transition] += outputWeights[i];
+        }
+    }
+    return matrix;
+}
+
+/// @brief Divides a vector by the gcd of its entries.
+static void reduce(std::vector<int64_t> &vector)
+{
+    int64_t divisor = 0;
+    for (const int64_t value : vector)
+    {
+        divisor = std::gcd(divisor, value);
+    }
+    if (divisor > 1)
+    {
+        for (int64_t &value : vector)
+        {
+            value /= divisor;
+        }
+    }
+}
+
+/// @brief The definition, checked directly: a set of places S is the support of a minimal invariant exactly if the
+/// solutions of y·C_S = 0 over the rows of S form a line and the line holds a vector positive on every place of S.
+/// @return (std::optional<std::vector<int64_t>>) That vector without a common divisor, one weight per place of S, or
+/// nothing if S isn't a minimal support.
+static std::optional<std::vector<int64_t>> minimalInvariant(const std::vector<std::vector<int64_t>> &matrix, const std::vector<PlaceId> &places)
+{
+    // Gauss-Jordan elimination on the transpose, one equation per transition over one unknown per place of S
+    const size_t unknowns = places.size();
+    std::vector<std::vector<int64_t>> rows;
+    for (size_t transition = 0; transition < matrix[0].size(); transition++)
+    {
+        std::vector<int64_t> row(unknowns);
+        for (size_t i = 0; i < unknowns; i++)
+        {
+            row[i] = matrix[places[i]][transition];
+        }
+        rows.push_back(std::move(row));
+    }
+    std::vector<size_t> pivots;
+    for (size_t column = 0; column < unknowns && pivots.size() < rows.size(); column++)
+    {
+        const size_t rank = pivots.size();
+        size_t pivot = rank;
+        while (pivot < rows.size() && rows[pivot][column] == 0)
+        {
+            pivot++;
+        }
+        if (pivot == rows.size())
+        {
+            continue;
+        }
+        std::swap(rows[rank], rows[pivot]);
+        for (size_t row = 0; row < rows.size(); row++)
+        {
+            if (row != rank && rows[row][column] != 0)
+            {
+                const int64_t factor = rows[row][column], pivotValue = rows[rank][column];
+                for (size_t i = 0; i < unknowns; i++)
+                {
+                    rows[row][i] = rows[row][i] * pivotValue - rows[rank][i] * factor;
+                }
+                reduce(rows[row]);
+            }
+        }
+        pivots.push_back(column);
+    }
+    if (pivots.size() + 1 != unknowns)
+    {
+        return std::nullopt;
+    }
+
+    // One free unknown: every pivot row reads a * y[pivot] + b * y[free] = 0
+    size_t free = 0;
+    while (std::find(pivots.begin(), pivots.end(), free) != pivots.end())
+    {
+        free++;
+    }
+    int64_t scale = 1;
+    for (size_t row = 0; row < pivots.size(); row++)
+    {
+        scale = std::lcm(scale, rows[row][pivots[row]]);
+    }
+    std::vector<int64_t> weights(unknowns);
+    weights[free] = scale;
+    for (size_t row = 0; row < pivots.size(); row++)
+    {
+        weights[pivots[row]] = -rows[row][free] * (scale / rows[row][pivots[row]]);
+    }
+    if (weights[0] < 0)
+    {
+        for (int64_t &weight : weights)
+        {
+            weight = -weight;
+        }
+    }
+    if (std::any_of(weights.begin(), weights.end(), [](int64_t weight) { return weight <= 0; }))
+    {
+        return std::nullopt;
+    }
+    reduce(weights);
+    return weights;
+}
+
+int main()
+{
+    std::mt19937 random(2024);
+    for (int round = 0; round < 3000; round++)
+    {
+        const PetriNet net = randomNet(random);
+        const NetView view = net.view();
+        const std::string context = "net " + std::to_string(round);
+        const std::vector<std::vector<int64_t>> matrix = incidence(view);
+        const size_t placeCount = view.placeCount();
+
+        // Brute force: every set of places that is the support of a minimal invariant, with its weights
+        std::vector<Invariant> expected;
+        for (uint32_t mask = 1; mask < (1u << placeCount); mask++)
+        {
+            Invariant invariant;
+            for (PlaceId place = 0; place < placeCount; place++)
+            {
+                if ((mask >> place) & 1)
+                {
+                    invariant.support.push_back(place);
+                }
+            }
+            if (auto weights = minimalInvariant(matrix, invariant.support))
+            {
+                invariant.weights = std::move(*weights);
+                expected.push_back(std::move(invariant));
+            }
+        }
+
+        const InvariantBasis basis = placeInvariants(view);
+        expect(basis.complete, context, "the elimination gave up");
+        expect(basis.invariants.size() == expected.size(), context, "the elimination and brute force find another number of invariants");
+        for (const Invariant &invariant : basis.invariants)
+        {
+            expect(std::is_sorted(invariant.support.begin(), invariant.support.end()) && invariant.support.size() == invariant.weights.size(),
+                   context, "malformed support");
+            std::vector<int64_t> product(view.transitionCount(), 0);
+            for (size_t i = 0; i < invariant.support.size(); i++)
+            {
+                for (TransitionId transition = 0; transition < view.transitionCount(); transition++)
+                {
+                    product[transition] += invariant.weights[i] * matrix[invariant.support[i]][transition];
+                }
+            }
+            expect(std::all_of(product.begin(), product.end(), [](int64_t value) { return value == 0; }), context, "y·C isn't 0");
+            const bool found = std::any_of(expected.begin(), expected.end(), [&invariant](const Invariant &other) {
+                return other.support == invariant.support && other.weights == invariant.weights;
+            });
+            expect(found, context, "an invariant isn't a minimal one of brute force with the same weights");
+        }
+
+        // A row limit below what the elimination needs loses everything rather than returning a partial basis
+        const InvariantBasis limited = placeInvariants(view, 2);
+        expect(limited.complete ? limited.invariants.size() == basis.invariants.size() : limited.invariants.empty(), context,
+               "a partial basis was returned");
+
+        // The bounds and the weighted token sums hold on every marking the net reaches
+        const PlaceBounds bounds = placeBounds(view, basis);
+        const ReachabilityGraph graph(view, {}, 2000);
+        const auto initial = graph.marking(0);
+        for (StateId state = 0; state < graph.stateCount(); state++)
+        {
+            const auto marking = graph.marking(state);
+            for (PlaceId place = 0; place < placeCount; place++)
+            {
+                expect(bounds.tokens[place] == UNBOUNDED_PLACE || marking[place] <= bounds.tokens[place], context, "a bound is exceeded");
+            }
+            for (const Invariant &invariant : basis.invariants)
+            {
+                expect(!separates(invariant, initial, marking), context, "an invariant separates a reachable marking");
+            }
+        }
+    }
+    return testResult("placeInvariants agrees with brute force");
+}
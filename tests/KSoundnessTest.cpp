@@ -0,0 +1,55 @@
+#include "../include/KSoundness.h"
+#include "TestSupport.h"
+
+/// @brief Known k-soundness of a net in nets/.
+struct ExpectedLevels
+{
+    const char *file;
+    std::vector<bool> kSound; // checkKSoundness for k = 1, 2, .., empty to skip the net
+};
+
+int main()
+{
+    const std::vector<ExpectedLevels> nets = {
+        {"sound-loops.txt", {true, true, true}},
+        {"sound-free-choice.txt", {true, true}},
+        {"non-free-choice-fragments.txt", {true, true}},
+        {"deadlock.txt", {false}},
+        {"livelock.txt", {false}},
+        {"dead-transitions.txt", {true}},
+        {"unbounded.txt", {}},
+        {"two-cases.pnml", {false, true, false}},
+    };
+    for (const ExpectedLevels &expected : nets)
+    {
+        const std::string file = expected.file;
+        if (expected.kSound.empty())
+        {
+            continue;
+        }
+        const PetriNet net = loadTestNet(file);
+        const auto maxK = static_cast<uint32_t>(expected.kSound.size());
+        const std::vector<KSoundnessLevel> levels = checkKSoundness(net.view(), maxK, TEST_STATE_LIMIT);
+        expect(levels.size() == expected.kSound.size(), file, "k-soundness stopped early");
+        const PlaceId input = findWorkflowPlaces(net.view()).input;
+        for (uint32_t k = 1; k <= levels.size(); k++)
+        {
+            const KSoundnessLevel &level = levels[k - 1];
+            expect(level.k == k && level.sound == expected.kSound[k - 1], file, "wrong k-soundness verdict");
+            expect(level.inherited <= level.states, file, "more states inherited than reachable");
+
+            // The level agrees with exploring k tokens in i from scratch, without the dead-transition requirement
+            PetriNet cases = net;
+            cases.addToken(input, static_cast<int>(k) - 1);
+            const NetView view = cases.view();
+            const ReachabilityGraph graph(view, workflowFinalMarking(view), TEST_STATE_LIMIT);
+            const std::vector<bool> completes = graph.canReach(graph.statesWith(STATE_FINAL));
+            expect(graph.complete() && level.complete, file, "a level was cut short");
+            expect(level.states == graph.stateCount(), file, "a level holds another number of states than the exploration");
+            expect(level.stuck == static_cast<size_t>(std::count(completes.begin(), completes.end(), false)), file,
+                   "a level has another number of stuck states than the exploration");
+            expect(level.sound == everyStateCompletes(graph), file, "a level disagrees with the exploration");
+        }
+    }
+    return testResult("checkKSoundness agrees with exploring every level from scratch");
+}
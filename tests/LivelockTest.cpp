@@ -0,0 +1,74 @@
+#include "../include/Livelock.h"
+#include "TestSupport.h"
+
+/// @brief Known stuck states of a net in nets/.
+struct ExpectedStuck
+{
+    const char *file;
+    bool deadlock;    // Some reachable state has no enabled transition and isn't final
+    size_t livelocks;
+};
+
+/// @brief Number of deadlocks among stuck components.
+static size_t deadlocks(const std::vector<StuckComponent> &components)
+{
+    return std::count_if(components.begin(), components.end(), [](const StuckComponent &component) { return component.deadlock; });
+}
+
+int main()
+{
+    const std::vector<ExpectedStuck> nets = {
+        {"sound-loops.txt", false, 0},
+        {"sound-free-choice.txt", false, 0},
+        {"non-free-choice-fragments.txt", false, 0},
+        {"deadlock.txt", true, 0},
+        {"livelock.txt", false, 1},
+        {"dead-transitions.txt", false, 0},
+        {"unbounded.txt", true, 0},
+        {"two-cases.pnml", true, 0},
+    };
+    for (const ExpectedStuck &expected : nets)
+    {
+        const std::string file = expected.file;
+        const PetriNet net = loadTestNet(file);
+        const NetView view = net.view();
+        const SoundnessReport report = verifySoundness(net, 1);
+        expect(report.deadlockPlaces.empty() != expected.deadlock, file, "wrong deadlock verdict");
+        expect(report.livelocks.size() == expected.livelocks, file, "wrong number of livelocks");
+
+        // Every component found in the graph is stuck, even where the state limit cut it short
+        const std::vector<int32_t> finalMarking = workflowFinalMarking(view);
+        const ReachabilityGraph graph(view, finalMarking, TEST_STATE_LIMIT);
+        const std::vector<StuckComponent> components = findStuckComponents(graph);
+        for (const StuckComponent &component : components)
+        {
+            // A deadlock is one state without successors, a livelock has no edge leaving it
+            bool closed = true;
+            for (const StateId state : component.states)
+            {
+                expect(!(graph.flags(state) & STATE_FINAL), file, "a stuck component holds the final marking");
+                for (const StateId successor : graph.successors(state))
+                {
+                    closed = closed && std::find(component.states.begin(), component.states.end(), successor) != component.states.end();
+                }
+            }
+            expect(closed, file, "an edge leaves a stuck component");
+            expect(!component.deadlock || (component.states.size() == 1 && graph.successors(component.states[0]).empty()), file,
+                   "a deadlock isn't a single state without successors");
+        }
+
+        // The search on the fly finds the same components, the two explore different states once the limit cuts them
+        const LivelockReport onTheFly = findStuckComponents(view, finalMarking, false, TEST_STATE_LIMIT);
+        expect(graph.complete() == onTheFly.complete, file, "the two explorations disagree on completeness");
+        if (!graph.complete())
+        {
+            continue;
+        }
+        expect(components.size() == onTheFly.components.size(), file, "the two stuck-component searches disagree");
+        expect(deadlocks(components) == deadlocks(onTheFly.components), file, "the two stuck-component searches disagree on deadlocks");
+        const LivelockReport first = findStuckComponents(view, finalMarking, true, TEST_STATE_LIMIT);
+        expect(first.components.size() == std::min<size_t>(1, components.size()), file, "stopping at the first component finds another number");
+        expect(components.empty() == everyStateCompletes(graph), file, "stuck components without stuck states, or the other way round");
+    }
+    return testResult("Both stuck-component searches agree on all " + std::to_string(nets.size()) + " nets");
+}
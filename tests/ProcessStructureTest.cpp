@@ -0,0 +1,120 @@
+#include "../include/ProcessStructure.h"
+#include "TestSupport.h"
+
+/// @brief Known decomposition of a net in nets/.
+struct ExpectedFragments
+{
+    const char *file;
+    bool fragments; // verifySoundness decided the net fragment by fragment
+};
+
+/// @brief Checks the shape of the tree: the whole net last, every parent after its children and every fragment
+/// bordered as its definition says.
+static void checkTree(const NetView &net, const WorkflowStructure &structure, const ProcessStructureTree &tree, const std::string &file)
+{
+    expect(!tree.fragments.empty() && tree.fragments.back().entry == structure.input && tree.fragments.back().exit == structure.output &&
+               tree.fragments.back().parent == INVALID_ID,
+           file, "the root isn't the whole net");
+    for (uint32_t id = 0; id < tree.fragments.size(); id++)
+    {
+        const Fragment &fragment = tree.fragments[id];
+        expect(id + 1 == tree.fragments.size() || (fragment.parent != INVALID_ID && fragment.parent > id), file, "a parent comes before its child");
+        const auto inside = [&fragment](TransitionId transition)
+        { return std::binary_search(fragment.transitions.begin(), fragment.transitions.end(), transition); };
+        const auto consumers = net.placePostset(fragment.entry), producers = net.placePreset(fragment.exit);
+        expect(std::all_of(consumers.begin(), consumers.end(), inside) && std::all_of(producers.begin(), producers.end(), inside), file,
+               "a consumer of the entry or a producer of the exit is outside");
+    }
+}
+
+/// @brief Workflow net i -> t0 -> p -> .. -> q -> t6 -> o whose fragment between p and q pumps tokens into b:
+/// t1 takes p to a, t2 keeps a and adds a token to b, t3 takes a to c, t4 takes b and c to c and t5 takes c to q.
+static PetriNet pumpingNet()
+{
+    PetriNet net;
+    for (const char *place : {"i", "p", "a", "b", "c", "q", "o"})
+    {
+        net.addPlace(place, place[0] == 'i' ? 1 : 0);
+    }
+    for (const char *transition : {"t0", "t1", "t2", "t3", "t4", "t5", "t6"})
+    {
+        net.addTransition(transition);
+    }
+    const std::vector<std::pair<std::vector<PlaceId>, std::vector<PlaceId>>> arcs = {
+        {{0}, {1}}, {{1}, {2}}, {{2}, {2, 3}}, {{2}, {4}}, {{3, 4}, {4}}, {{4}, {5}}, {{5}, {6}},
+    };
+    for (TransitionId transition = 0; transition < arcs.size(); transition++)
+    {
+        for (const PlaceId place : arcs[transition].first)
+        {
+            net.addArc(place, transition, ArcDirection::PlaceToTransition);
+        }
+        for (const PlaceId place : arcs[transition].second)
+        {
+            net.addArc(transition, place, ArcDirection::TransitionToPlace);
+        }
+    }
+    net.finalize();
+    return net;
+}
+
+int main()
+{
+    const std::vector<ExpectedFragments> nets = {
+        {"sound-loops.txt", false},
+        {"sound-free-choice.txt", false},
+        {"non-free-choice-fragments.txt", true},
+        {"deadlock.txt", false},
+        {"livelock.txt", false},
+        {"dead-transitions.txt", false},
+        {"unbounded.txt", false},
+        {"two-cases.pnml", false},
+    };
+    for (const ExpectedFragments &expected : nets)
+    {
+        const std::string file = expected.file;
+        const PetriNet net = loadTestNet(file);
+        const NetView view = net.view();
+        expect((verifySoundness(net, 1).fragments > 0) == expected.fragments, file, "wrong path: fragments");
+        const WorkflowStructure structure = validateWorkflowNet(view);
+        const ProcessStructureTree tree = decomposeWorkflowNet(view, structure);
+        checkTree(view, structure, tree, file);
+
+        // Fragments only ever prove soundness, the exploration must agree whenever they do
+        const ReachabilityGraph graph(view, workflowFinalMarking(view), TEST_STATE_LIMIT);
+        if (!graph.complete() || view.places[structure.input].tokens != 1 || tree.fragments.size() < 2 || !verifyFragments(view, tree, 1).sound)
+        {
+            continue;
+        }
+        std::vector<bool> fired(view.transitionCount(), false);
+        for (StateId state = 0; state < graph.stateCount(); state++)
+        {
+            for (const TransitionId transition : graph.successorTransitions(state))
+            {
+                fired[transition] = true;
+            }
+        }
+        expect(everyStateCompletes(graph) && std::all_of(fired.begin(), fired.end(), [](bool value) { return value; }), file,
+               "every fragment is sound but the exploration finds the net unsound");
+    }
+
+    // The fragment from p to q is unbounded, its exploration ends at the second token in b instead of the state limit
+    const PetriNet pumping = pumpingNet();
+    const NetView view = pumping.view();
+    const WorkflowStructure structure = validateWorkflowNet(view);
+    const ProcessStructureTree tree = decomposeWorkflowNet(view, structure);
+    checkTree(view, structure, tree, "pumping");
+    const DecomposedSoundness fragments = verifyFragments(view, tree, 1);
+    const auto inner = std::find_if(tree.fragments.begin(), tree.fragments.end(), [](const Fragment &fragment) { return fragment.entry == 1; });
+    expect(inner != tree.fragments.end() && inner->exit == 5, "pumping", "the fragment from p to q wasn't found");
+    if (inner != tree.fragments.end())
+    {
+        const FragmentVerdict &verdict = fragments.verdicts[inner - tree.fragments.begin()];
+        expect(!verdict.safe && !verdict.complete && verdict.states > 0 && verdict.states < 10, "pumping",
+               "the fragment wasn't stopped at its first unsafe marking");
+    }
+    expect(!fragments.sound, "pumping", "an unbounded net was reported sound");
+
+    return testResult("The fragments of all " + std::to_string(nets.size()) +
+                      " nets are well formed and agree with the exploration, an unsafe one stops early");
+}
@@ -0,0 +1,154 @@
+#include "TestSupport.h"
+
+#include <set>
+
+/// @brief Known verdict of a net in nets/.
+struct ExpectedVerdict
+{
+    const char *file;
+    bool sound;
+    bool finalReachable;
+    bool complete;          // The exploration stays within the state limit
+    size_t deadTransitions;
+};
+
+/// @brief Checks every state of the graph against the net: its edges are exactly the enabled transitions, each leads
+/// to the marking firing it gives, the backward rows mirror the forward ones and STATE_FINAL marks the final marking.
+static void checkGraph(const NetView &net, const ReachabilityGraph &graph, std::span<const int32_t> finalMarking, const std::string &file)
+{
+    std::vector<int32_t> next(net.placeCount());
+    std::set<std::vector<int32_t>> markings;
+    size_t backwardEdges = 0;
+    for (StateId state = 0; state < graph.stateCount(); state++)
+    {
+        const auto marking = graph.marking(state);
+        if (graph.complete())
+        {
+            expect(markings.emplace(marking.begin(), marking.end()).second, file, "a marking is stored twice");
+        }
+        const bool final = std::equal(marking.begin(), marking.end(), finalMarking.begin(), finalMarking.end());
+        expect(final == ((graph.flags(state) & STATE_FINAL) != 0), file, "STATE_FINAL doesn't match the final marking");
+        backwardEdges += graph.predecessors(state).size();
+
+        const auto successors = graph.successors(state);
+        const auto transitions = graph.successorTransitions(state);
+        TransitionIds enabled;
+        for (TransitionId transition = 0; transition < net.transitionCount(); transition++)
+        {
+            const auto inputs = net.preset(transition);
+            const auto weights = net.presetWeights(transition);
+            bool fires = true;
+            for (size_t i = 0; fires && i < inputs.size(); i++)
+            {
+                fires = marking[inputs[i]] >= static_cast<int32_t>(weights[i]);
+            }
+            if (fires)
+            {
+                enabled.push_back(transition);
+            }
+        }
+        TransitionIds labels(transitions.begin(), transitions.end());
+        std::sort(labels.begin(), labels.end());
+        if (!(graph.flags(state) & STATE_TRUNCATED))
+        {
+            expect(labels == enabled, file, "the edges of a state aren't its enabled transitions");
+        }
+        for (size_t edge = 0; edge < successors.size(); edge++)
+        {
+            const TransitionId transition = transitions[edge];
+            std::copy(marking.begin(), marking.end(), next.begin());
+            const auto inputs = net.preset(transition);
+            const auto inputWeights = net.presetWeights(transition);
+            for (size_t i = 0; i < inputs.size(); i++)
+            {
+                next[inputs[i]] -= static_cast<int32_t>(inputWeights[i]);
+            }
+            const auto outputs = net.postset(transition);
+            const auto outputWeights = net.postsetWeights(transition);
+            for (size_t i = 0; i < outputs.size(); i++)
+            {
+                next[outputs[i]] += static_cast<int32_t>(outputWeights[i]);
+            }
+            const auto reached = graph.marking(successors[edge]);
+            expect(std::equal(next.begin(), next.end(), reached.begin(), reached.end()), file, "an edge leads to the wrong marking");
+            const auto predecessors = graph.predecessors(successors[edge]);
+            const auto predecessorTransitions = graph.predecessorTransitions(successors[edge]);
+            bool mirrored = false;
+            for (size_t back = 0; !mirrored && back < predecessors.size(); back++)
+            {
+                mirrored = predecessors[back] == state && predecessorTransitions[back] == transition;
+            }
+            expect(mirrored, file, "an edge is missing from the backward rows");
+        }
+    }
+    expect(backwardEdges == graph.edgeCount(), file, "the backward rows hold a different number of edges");
+    const StateId initial = 0;
+    const std::vector<bool> reached = graph.reachableFrom(std::span<const StateId>(&initial, 1));
+    expect(std::all_of(reached.begin(), reached.end(), [](bool value) { return value; }), file, "a state isn't reachable from the initial one");
+}
+
+int main()
+{
+    const std::vector<ExpectedVerdict> nets = {
+        {"sound-loops.txt", true, true, true, 0},
+        {"sound-free-choice.txt", true, true, true, 0},
+        {"non-free-choice-fragments.txt", true, true, true, 0},
+        {"deadlock.txt", false, true, true, 0},
+        {"livelock.txt", false, true, true, 2},
+        {"dead-transitions.txt", false, true, true, 3},
+        {"unbounded.txt", false, true, false, 0},
+        {"two-cases.pnml", false, false, true, 2},
+    };
+    for (const ExpectedVerdict &expected : nets)
+    {
+        const std::string file = expected.file;
+        const PetriNet net = loadTestNet(file);
+        const NetView view = net.view();
+        const std::vector<int32_t> finalMarking = workflowFinalMarking(view);
+        const ReachabilityGraph graph(view, finalMarking, TEST_STATE_LIMIT);
+        checkGraph(view, graph, finalMarking, file);
+
+        const SoundnessReport report = verifySoundness(net, 1);
+        expect(report.sound == expected.sound, file, "wrong verdict");
+        expect(report.finalReachable == expected.finalReachable, file, "wrong final reachability");
+        expect(report.complete == expected.complete, file, "wrong completeness");
+        expect(report.deadTransitions.size() == expected.deadTransitions, file, "wrong number of dead transitions");
+        expect(!report.sound || !report.witness.empty(), file, "sound without a witness");
+        if (!report.witness.empty())
+        {
+            // The witness fires from the initial marking to the final one
+            PetriNet run = net;
+            bool enabled = true;
+            for (const TransitionId transition : report.witness)
+            {
+                const TransitionIds possible = getEnabledTransitions(run);
+                enabled = enabled && std::find(possible.begin(), possible.end(), transition) != possible.end();
+                fireTransition(run, transition);
+            }
+            bool reached = enabled;
+            for (PlaceId place = 0; place < finalMarking.size(); place++)
+            {
+                reached = reached && run.getPlaces()[place].tokens == finalMarking[place];
+            }
+            expect(reached, file, "the witness doesn't lead to the final marking");
+        }
+
+        // Sound means every state completes and every transition labels an edge, whichever route decided it
+        if (!graph.complete())
+        {
+            expect(!report.sound, file, "a net beyond the state limit was reported sound");
+            continue;
+        }
+        std::vector<bool> fired(view.transitionCount(), false);
+        for (StateId state = 0; state < graph.stateCount(); state++)
+        {
+            for (const TransitionId transition : graph.successorTransitions(state))
+            {
+                fired[transition] = true;
+            }
+        }
+        const bool explored = everyStateCompletes(graph) && std::all_of(fired.begin(), fired.end(), [](bool value) { return value; });
+        expect(explored == report.sound, file, "the exploration and verifySoundness disagree");
+    }
+    return testResult("The reachability graphs match their nets and all " + std::to_string(nets.size()) + " nets have their known verdicts");
+}
@@ -0,0 +1,140 @@
+#include "../include/SComponents.h"
+#include "TestSupport.h"
+
+/// @brief The definition, checked directly: every producer and consumer of the set takes one token from it and puts
+/// one back over arcs of weight 1, and the places and these transitions form a strongly connected subnet.
+static bool isSComponent(const PetriNet &net, const std::vector<bool> &inSet)
+{
+    const size_t placeCount = inSet.size();
+    const size_t transitionCount = net.getTransitions().size();
+    std::vector<uint32_t> inputs(transitionCount, 0), outputs(transitionCount, 0);
+    std::vector<std::vector<uint32_t>> successors(placeCount + transitionCount);
+    bool any = false;
+    for (const Edge &arc : net.getArcs())
+    {
+        const bool toTransition = arc.direction == ArcDirection::PlaceToTransition;
+        const PlaceId place = toTransition ? arc.from : arc.to;
+        const TransitionId transition = toTransition ? arc.to : arc.from;
+        if (!inSet[place])
+        {
+            continue;
+        }
+        if (arc.weight != 1)
+        {
+            return false;
+        }
+        (toTransition ? inputs : outputs)[transition]++;
+        successors[toTransition ? place : placeCount + transition].push_back(toTransition ? static_cast<uint32_t>(placeCount + transition) : place);
+    }
+    std::vector<uint32_t> nodes;
+    for (PlaceId place = 0; place < placeCount; place++)
+    {
+        if (inSet[place])
+        {
+            nodes.push_back(place);
+            any = true;
+        }
+    }
+    for (TransitionId transition = 0; transition < transitionCount; transition++)
+    {
+        if (inputs[transition] + outputs[transition] == 0)
+        {
+            continue;
+        }
+        if (inputs[transition] != 1 || outputs[transition] != 1)
+        {
+            return false;
+        }
+        nodes.push_back(static_cast<uint32_t>(placeCount + transition));
+    }
+    if (!any)
+    {
+        return false;
+    }
+    // Strongly connected: every node reaches every other, checked from each one
+    for (const uint32_t start : nodes)
+    {
+        std::vector<bool> seen(placeCount + transitionCount, false);
+        std::vector<uint32_t> queue{start};
+        seen[start] = true;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            for (const uint32_t next : successors[queue[head]])
+            {
+                if (!seen[next])
+                {
+                    seen[next] = true;
+                    queue.push_back(next);
+                }
+            }
+        }
+        if (queue.size() != nodes.size())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::mt19937 random(2024);
+    for (int round = 0; round < 3000; round++)
+    {
+        const PetriNet net = randomNet(random);
+        const std::string context = "net " + std::to_string(round);
+        const size_t placeCount = net.getPlaces().size();
+
+        // Brute force: a place is coverable if some set of places holding it is an S-component
+        std::vector<bool> coverable(placeCount, false);
+        for (uint32_t mask = 1; mask < (1u << placeCount); mask++)
+        {
+            std::vector<bool> inSet(placeCount);
+            for (PlaceId place = 0; place < placeCount; place++)
+            {
+                inSet[place] = (mask >> place) & 1;
+            }
+            if (isSComponent(net, inSet))
+            {
+                for (PlaceId place = 0; place < placeCount; place++)
+                {
+                    coverable[place] = coverable[place] || inSet[place];
+                }
+            }
+        }
+
+        const SComponentCover cover = sComponentCover(net);
+        expect(cover.complete, context, "the search gave up");
+        std::vector<bool> covered(placeCount, false);
+        for (const SComponent &component : cover.components)
+        {
+            std::vector<bool> inSet(placeCount, false);
+            int64_t tokens = 0;
+            for (const PlaceId place : component.places)
+            {
+                inSet[place] = covered[place] = true;
+                tokens += net.getPlaces()[place].tokens;
+            }
+            expect(isSComponent(net, inSet), context, "a reported component isn't an S-component");
+            expect(tokens == component.tokens, context, "wrong token count of a component");
+        }
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            const bool uncovered = std::find(cover.uncovered.begin(), cover.uncovered.end(), place) != cover.uncovered.end();
+            const std::string where = context + ", p" + std::to_string(place);
+            expect(covered[place] == coverable[place], where, "the cover and brute force disagree");
+            expect(uncovered == !covered[place], where, "the uncovered list disagrees with the components");
+        }
+
+        // Every component's tokens bound its places
+        const PlaceBounds bounds = placeBounds(net.view(), cover);
+        for (const SComponent &component : cover.components)
+        {
+            for (const PlaceId place : component.places)
+            {
+                expect(bounds.tokens[place] <= component.tokens, context + ", p" + std::to_string(place), "bound above the tokens of a component");
+            }
+        }
+    }
+    return testResult("sComponentCover agrees with brute force");
+}
@@ -0,0 +1,189 @@
+#include "../include/Siphons.h"
+#include "TestSupport.h"
+
+/// @brief Known structural proof of a net in nets/.
+struct ExpectedProof
+{
+    const char *file;
+    bool provenStructurally;
+};
+
+/// @brief The definitions, checked directly: every set of places that is a siphon (each producer of the set also
+/// consumes from it) or a trap (each consumer of the set also produces into it), as a bit mask.
+static std::vector<bool> placeSets(const NetView &net, bool siphons)
+{
+    const size_t placeCount = net.placeCount();
+    std::vector<bool> result(size_t{1} << placeCount, false);
+    for (uint32_t mask = 1; mask < result.size(); mask++)
+    {
+        bool holds = true;
+        for (TransitionId transition = 0; holds && transition < net.transitionCount(); transition++)
+        {
+            const auto touching = siphons ? net.postset(transition) : net.preset(transition);
+            const auto required = siphons ? net.preset(transition) : net.postset(transition);
+            const auto inSet = [mask](PlaceId place) { return ((mask >> place) & 1) != 0; };
+            holds = std::none_of(touching.begin(), touching.end(), inSet) || std::any_of(required.begin(), required.end(), inSet);
+        }
+        result[mask] = holds;
+    }
+    return result;
+}
+
+/// @brief The sets among placeSets no other one lies inside, as increasing place ids in increasing mask order.
+static std::vector<std::vector<PlaceId>> minimalSets(const std::vector<bool> &sets)
+{
+    std::vector<std::vector<PlaceId>> result;
+    for (uint32_t mask = 1; mask < sets.size(); mask++)
+    {
+        bool minimal = sets[mask];
+        for (uint32_t inner = (mask - 1) & mask; minimal && inner != 0; inner = (inner - 1) & mask)
+        {
+            minimal = !sets[inner];
+        }
+        if (minimal)
+        {
+            std::vector<PlaceId> places;
+            for (PlaceId place = 0; (mask >> place) != 0; place++)
+            {
+                if ((mask >> place) & 1)
+                {
+                    places.push_back(place);
+                }
+            }
+            result.push_back(std::move(places));
+        }
+    }
+    return result;
+}
+
+/// @brief Checks an enumeration against brute force, in any order.
+static void expectSets(MinimalPlaceSets found, const std::vector<std::vector<PlaceId>> &expected, const std::string &context, const char *message)
+{
+    std::sort(found.sets.begin(), found.sets.end());
+    std::vector<std::vector<PlaceId>> sorted = expected;
+    std::sort(sorted.begin(), sorted.end());
+    expect(found.complete && found.sets == sorted, context, message);
+}
+
+/// @brief Checks the structural proof against the exploration: a net proven sound explores as sound.
+static void checkProof(const PetriNet &net, const std::string &file)
+{
+    const NetView view = net.view();
+    const ReachabilityGraph graph(view, workflowFinalMarking(view), TEST_STATE_LIMIT);
+    if (!graph.complete() || !provenSound(view, validateWorkflowNet(view)))
+    {
+        return;
+    }
+    std::vector<bool> fired(view.transitionCount(), false);
+    for (StateId state = 0; state < graph.stateCount(); state++)
+    {
+        for (const TransitionId transition : graph.successorTransitions(state))
+        {
+            fired[transition] = true;
+        }
+    }
+    expect(everyStateCompletes(graph) && std::all_of(fired.begin(), fired.end(), [](bool value) { return value; }), file,
+           "proven structurally but the exploration finds it unsound");
+}
+
+int main()
+{
+    std::mt19937 random(2024);
+    for (int round = 0; round < 3000; round++)
+    {
+        const PetriNet net = randomNet(random);
+        const NetView view = net.view();
+        const std::string context = "net " + std::to_string(round);
+        const size_t placeCount = view.placeCount();
+        const std::vector<bool> siphons = placeSets(view, true), traps = placeSets(view, false);
+        const std::vector<std::vector<PlaceId>> expectedSiphons = minimalSets(siphons);
+        expectSets(minimalSiphons(view), expectedSiphons, context, "minimalSiphons and brute force disagree");
+        expectSets(minimalTraps(view), minimalSets(traps), context, "minimalTraps and brute force disagree");
+
+        // The maximal siphon and trap are the unions of all of them
+        std::vector<bool> siphonUnion(placeCount, false), trapUnion(placeCount, false);
+        for (uint32_t mask = 1; mask < siphons.size(); mask++)
+        {
+            for (PlaceId place = 0; place < placeCount; place++)
+            {
+                siphonUnion[place] = siphonUnion[place] || (siphons[mask] && ((mask >> place) & 1));
+                trapUnion[place] = trapUnion[place] || (traps[mask] && ((mask >> place) & 1));
+            }
+        }
+        expect(maximalSiphon(view, std::vector<bool>(placeCount, true)) == siphonUnion, context, "wrong maximal siphon");
+        expect(maximalTrap(view, std::vector<bool>(placeCount, true)) == trapUnion, context, "wrong maximal trap");
+
+        // Commoner: every minimal siphon holds a trap with a token
+        uint32_t marked = 0;
+        for (PlaceId place = 0; place < placeCount; place++)
+        {
+            marked |= view.places[place].tokens > 0 ? 1u << place : 0;
+        }
+        std::vector<std::vector<PlaceId>> unmarkedSiphons;
+        for (const std::vector<PlaceId> &siphon : expectedSiphons)
+        {
+            uint32_t mask = 0;
+            for (const PlaceId place : siphon)
+            {
+                mask |= 1u << place;
+            }
+            bool markedTrap = false;
+            for (uint32_t inner = mask; !markedTrap && inner != 0; inner = (inner - 1) & mask)
+            {
+                markedTrap = traps[inner] && (inner & marked) != 0;
+            }
+            if (!markedTrap)
+            {
+                unmarkedSiphons.push_back(siphon);
+            }
+        }
+        const CommonerReport commoner = checkCommonerProperty(view);
+        expect(commoner.complete && commoner.holds == unmarkedSiphons.empty(), context, "checkCommonerProperty and brute force disagree");
+        expect(commoner.holds == commoner.unmarkedSiphon.empty() &&
+                   (commoner.holds ||
+                    std::find(unmarkedSiphons.begin(), unmarkedSiphons.end(), commoner.unmarkedSiphon) != unmarkedSiphons.end()),
+               context, "the reported siphon isn't a minimal one without a marked trap");
+
+        // An ordinary net with the property never reaches a dead marking
+        if (commoner.holds && view.ordinary)
+        {
+            const ReachabilityGraph graph(view, {}, 2000);
+            for (StateId state = 0; state < graph.stateCount(); state++)
+            {
+                expect((graph.flags(state) & STATE_TRUNCATED) || !graph.successors(state).empty(), context,
+                       "the Commoner property holds but a dead marking is reachable");
+            }
+        }
+
+        // Free choice: transitions sharing an input place have the same inputs
+        bool freeChoice = true;
+        for (TransitionId first = 0; first < view.transitionCount(); first++)
+        {
+            for (TransitionId second = 0; second < view.transitionCount(); second++)
+            {
+                const auto a = view.preset(first), b = view.preset(second);
+                const bool shared = std::any_of(a.begin(), a.end(), [&b](PlaceId place) { return std::find(b.begin(), b.end(), place) != b.end(); });
+                freeChoice = freeChoice && (!shared || std::is_permutation(a.begin(), a.end(), b.begin(), b.end()));
+            }
+        }
+        expect(isFreeChoice(view) == freeChoice, context, "isFreeChoice and the definition disagree");
+    }
+
+    const std::vector<ExpectedProof> nets = {
+        {"sound-loops.txt", false},
+        {"sound-free-choice.txt", true},
+        {"non-free-choice-fragments.txt", false},
+        {"deadlock.txt", false},
+        {"livelock.txt", false},
+        {"dead-transitions.txt", false},
+        {"unbounded.txt", false},
+        {"two-cases.pnml", false},
+    };
+    for (const ExpectedProof &expected : nets)
+    {
+        const PetriNet net = loadTestNet(expected.file);
+        expect(verifySoundness(net, 1).provenStructurally == expected.provenStructurally, expected.file, "wrong path: structural proof");
+        checkProof(net, expected.file);
+    }
+    return testResult("The siphons, traps and Commoner's property agree with brute force, and every structural proof with the exploration");
+}
@@ -0,0 +1,84 @@
+#ifndef PETRINETS_TESTSUPPORT_H
+#define PETRINETS_TESTSUPPORT_H
+
+#include "../include/NetLoader.h"
+#include "../include/Petrinet.h"
+#include "../include/ReachabilityGraph.h"
+#include "../include/Utility.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+const size_t TEST_STATE_LIMIT = 100000; // Every bounded net in nets/ stays far below this
+
+/// @brief Failed checks so far, the test exits with 1 if there are any.
+inline int failures = 0;
+
+/// @brief Reports a failed check without stopping, so one run lists every mismatch.
+/// @param context What the check is about, e.g. the net file.
+inline void expect(bool condition, const std::string &context, const char *message)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED on " << context << ": " << message << std::endl;
+        failures++;
+    }
+}
+
+/// @brief Loads a net of nets/, the tests run from this directory.
+inline PetriNet loadTestNet(const std::string &file)
+{
+    std::string path = "nets/";
+    path += file;
+    return loadNet(path);
+}
+
+/// @brief Random net with up to 8 places and transitions and a few weighted arcs, small enough to enumerate every set
+/// of places.
+inline PetriNet randomNet(std::mt19937 &random)
+{
+    PetriNet net;
+    const uint32_t places = 1 + random() % 8, transitions = 1 + random() % 8;
+    for (uint32_t place = 0; place < places; place++)
+    {
+        net.addPlace(std::string("p").append(std::to_string(place)), static_cast<int>(random() % 3));
+    }
+    for (TransitionId transition = 0; transition < transitions; transition++)
+    {
+        net.addTransition(std::string("t").append(std::to_string(transition)));
+        const uint32_t inputs = random() % 3, outputs = random() % 3;
+        for (uint32_t i = 0; i < inputs; i++)
+        {
+            net.addArc(random() % places, transition, ArcDirection::PlaceToTransition, random() % 8 == 0 ? 2 : 1);
+        }
+        for (uint32_t i = 0; i < outputs; i++)
+        {
+            net.addArc(transition, random() % places, ArcDirection::TransitionToPlace, random() % 8 == 0 ? 2 : 1);
+        }
+    }
+    net.finalize();
+    return net;
+}
+
+/// @brief Whether a graph has a final state and every state can reach one: the option to complete, if it's complete.
+inline bool everyStateCompletes(const ReachabilityGraph &graph)
+{
+    const std::vector<StateId> finalStates = graph.statesWith(STATE_FINAL);
+    const std::vector<bool> completes = graph.canReach(finalStates);
+    return !finalStates.empty() && std::all_of(completes.begin(), completes.end(), [](bool value) { return value; });
+}
+
+/// @brief Exit code of the test, the summary is printed if every check passed.
+inline int testResult(const std::string &summary)
+{
+    if (failures == 0)
+    {
+        std::cout << summary << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+#endif //PETRINETS_TESTSUPPORT_H
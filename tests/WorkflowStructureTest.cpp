@@ -0,0 +1,105 @@
+#include "../include/WorkflowStructure.h"
+#include "TestSupport.h"
+
+/// @brief Arc of a net built by buildNet, place to transition unless toPlace is set.
+struct TestArc
+{
+    uint32_t place;
+    uint32_t transition;
+    bool toPlace;
+};
+
+/// @brief Net with places p0, p1, .. holding the given tokens and transitions t0, t1, ..
+static PetriNet buildNet(const std::vector<int> &tokens, uint32_t transitions, const std::vector<TestArc> &arcs)
+{
+    PetriNet net;
+    for (size_t place = 0; place < tokens.size(); place++)
+    {
+        net.addPlace(std::string("p").append(std::to_string(place)), tokens[place]);
+    }
+    for (uint32_t transition = 0; transition < transitions; transition++)
+    {
+        net.addTransition(std::string("t").append(std::to_string(transition)));
+    }
+    for (const TestArc &arc : arcs)
+    {
+        if (arc.toPlace)
+        {
+            net.addArc(arc.transition, arc.place, ArcDirection::TransitionToPlace);
+        }
+        else
+        {
+            net.addArc(arc.place, arc.transition, ArcDirection::PlaceToTransition);
+        }
+    }
+    net.finalize();
+    return net;
+}
+
+/// @brief Checks that validateWorkflowNet reports exactly the given issues, in order.
+static void expectIssues(const PetriNet &net, const std::vector<WorkflowIssue> &issues, const std::string &name)
+{
+    const WorkflowStructure structure = validateWorkflowNet(net.view());
+    bool same = structure.issues.size() == issues.size();
+    for (size_t i = 0; same && i < issues.size(); i++)
+    {
+        same = structure.issues[i].defect == issues[i].defect && structure.issues[i].node == issues[i].node &&
+               structure.issues[i].transition == issues[i].transition;
+    }
+    expect(same, name, "wrong issues");
+    expect(structure.valid() == issues.empty(), name, "valid() disagrees with the issues");
+}
+
+int main()
+{
+    // The nets in nets/ are workflow nets, the PNML one with input and output places that aren't named i and o
+    const std::vector<std::pair<const char *, std::pair<const char *, const char *>>> nets = {
+        {"sound-loops.txt", {"i", "o"}},
+        {"sound-free-choice.txt", {"i", "o"}},
+        {"non-free-choice-fragments.txt", {"i", "o"}},
+        {"deadlock.txt", {"i", "o"}},
+        {"livelock.txt", {"i", "o"}},
+        {"dead-transitions.txt", {"i", "o"}},
+        {"unbounded.txt", {"i", "o"}},
+        {"two-cases.pnml", {"start", "end"}},
+    };
+    for (const auto &[file, places] : nets)
+    {
+        const PetriNet net = loadTestNet(file);
+        const NetView view = net.view();
+        const WorkflowStructure structure = validateWorkflowNet(view);
+        expect(structure.valid() && structure.stronglyConnected, file, "not a workflow net");
+        expect(structure.input != INVALID_ID && view.placeName(structure.input) == places.first, file, "wrong input place");
+        expect(structure.output != INVALID_ID && view.placeName(structure.output) == places.second, file, "wrong output place");
+        const std::vector<int32_t> finalMarking = workflowFinalMarking(view);
+        expect(finalMarking.size() == view.placeCount() && structure.output != INVALID_ID && finalMarking[structure.output] == 1 &&
+                   std::count(finalMarking.begin(), finalMarking.end(), 0) == static_cast<long>(view.placeCount() - 1),
+               file, "the final marking isn't one token in the output place");
+    }
+
+    // Two places without producers: both are reported and neither counts as marked by mistake
+    expectIssues(buildNet({1, 0, 0}, 1, {{0, 0, false}, {1, 0, false}, {2, 0, true}}),
+                 {{WorkflowDefect::SeveralInputs, 0}, {WorkflowDefect::SeveralInputs, 1}}, "two inputs");
+    // Two places without consumers
+    expectIssues(buildNet({1, 0, 0}, 1, {{0, 0, false}, {1, 0, true}, {2, 0, true}}),
+                 {{WorkflowDefect::SeveralOutputs, 1}, {WorkflowDefect::SeveralOutputs, 2}}, "two outputs");
+    // Every place has producers
+    expectIssues(buildNet({1, 0}, 1, {{0, 0, false}, {0, 0, true}, {1, 0, true}}),
+                 {{WorkflowDefect::MissingInput}, {WorkflowDefect::MarkedPlace, 0}}, "no input");
+    expectIssues(buildNet({0, 0}, 1, {{0, 0, false}, {1, 0, true}}), {{WorkflowDefect::UnmarkedInput, 0}}, "unmarked input");
+    expectIssues(buildNet({1, 1, 0}, 2, {{0, 0, false}, {1, 0, true}, {1, 1, false}, {2, 1, true}}),
+                 {{WorkflowDefect::MarkedPlace, 1}}, "marked place");
+    // p3 and p4 cycle through t2 and t3 apart from the path p0 -> t0 -> p1 -> t1 -> p2
+    const PetriNet detached = buildNet({1, 0, 0, 0, 0}, 4,
+                                       {{0, 0, false}, {1, 0, true}, {1, 1, false}, {2, 1, true},
+                                        {3, 2, false}, {4, 2, true}, {4, 3, false}, {3, 3, true}});
+    expectIssues(detached,
+                 {{WorkflowDefect::Unreachable, 3}, {WorkflowDefect::Unreachable, 4}, {WorkflowDefect::Unreachable, 2, true},
+                  {WorkflowDefect::Unreachable, 3, true}, {WorkflowDefect::CannotReachOutput, 3}, {WorkflowDefect::CannotReachOutput, 4},
+                  {WorkflowDefect::CannotReachOutput, 2, true}, {WorkflowDefect::CannotReachOutput, 3, true}},
+                 "detached cycle");
+    expect(describeWorkflowIssue(detached.view(), {WorkflowDefect::CannotReachOutput, 2, true}) == "Transition t2 can't reach the output place",
+           "detached cycle", "wrong description");
+
+    return testResult("validateWorkflowNet finds the input and output places by structure and reports every defect");
+}